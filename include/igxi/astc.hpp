@@ -0,0 +1,16 @@
+#pragma once
+#include "types/vec.hpp"
+
+namespace igxi {
+
+	//ASTC (LDR) encoder; one block of 4x4, 6x6 or 8x8 rgba8 pixels (row major) per call
+	//Missing channels should be 0 (and alpha 255)
+	//Every block is encoded as one partition and one weight plane (RGB or RGBA endpoints depending on alpha)
+	//"Iterations" is how many times the endpoints are refined;
+	//	0 is the fast preset, which only tries one weight grid instead of all of them
+	void encodeASTC(const u8 (*px)[4], u8 blockWidth, u8 blockHeight, u8 *out, u8 iterations);
+
+	//Whether or not encodeASTC supports the block size
+	bool supportsASTC(u8 blockWidth, u8 blockHeight);
+
+}
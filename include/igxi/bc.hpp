@@ -0,0 +1,30 @@
+#pragma once
+#include "types/vec.hpp"
+
+namespace igxi {
+
+	//A 4x4 block of rgba8 pixels (row major)
+	//Missing channels should be 0 (and alpha 255)
+	struct Block {
+		u8 px[16][4];
+	};
+
+	//Block compression (BCn/S3TC) encoders; one 4x4 block per call
+	//"Iterations" is how many times the endpoints are refined; 0 is the fastest
+
+	//RGB in 8 bytes; always uses the opaque 4 color mode
+	void encodeBC1(const Block &block, u8 *out, u8 iterations);
+
+	//BC4 alpha (8 bytes) + BC1 color (8 bytes)
+	void encodeBC3(const Block &block, u8 *out, u8 iterations);
+
+	//One channel (R) in 8 bytes
+	void encodeBC4(const Block &block, u8 *out, u8 iterations);
+
+	//Two channels (RG) as two BC4 blocks (16 bytes)
+	void encodeBC5(const Block &block, u8 *out, u8 iterations);
+
+	//RGBA in 16 bytes; uses mode 6 (one subset, 7-bit endpoints + p-bit, 4-bit indices)
+	void encodeBC7(const Block &block, u8 *out, u8 iterations);
+
+}
\ No newline at end of file
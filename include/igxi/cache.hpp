@@ -0,0 +1,85 @@
+#pragma once
+#include "igxi/convert.hpp"
+#include "igxi/mapped_file.hpp"
+#include <mutex>
+#include <memory>
+#include <list>
+
+namespace igxi {
+
+	//An on-disk cache of decoded (and format converted) images
+	//Images are keyed by a hash of the source file and the flags that change how it's decoded,
+	//	so an unchanged file doesn't have to be decoded by stb again
+	//Only the decoded image is cached (mip 0 as it was loaded); mips and compression are still done on every conversion
+	//
+	//Every image is its own file in the directory. Once the total size goes over maxSize,
+	//	the least recently used ones are removed. Last use is kept as the file's write time,
+	//	so it carries over to the next run
+	//
+	//Can be used by multiple threads at once
+	//
+	struct DecodeCache {
+
+		//Header of a cached image; followed by the pixels
+		struct Header {
+			u64 magic, key;
+			u16 width, height, format, padding;
+		};
+
+		//Loads the index of the directory (and creates it if it doesn't exist)
+		DecodeCache(const String &directory, u64 maxSize);
+
+		DecodeCache(const DecodeCache&) = delete;
+		DecodeCache(DecodeCache&&) = delete;
+		DecodeCache &operator=(const DecodeCache&) = delete;
+		DecodeCache &operator=(DecodeCache&&) = delete;
+
+		//Get the key of a source file; only flags that change the decoded result are included
+		static u64 getKey(const u8 *file, usz size, Helper::Flags flags);
+
+		//Find an image; returns null if it isn't cached
+		//The pixels start at data() + sizeof(Header) and are the size of the image
+		std::unique_ptr<MappedFile> find(u64 key, Header &header);
+
+		//Store a decoded image; evicts the least recently used images if the cache gets too big
+		void store(u64 key, u16 width, u16 height, ignis::GPUFormat format, const u8 *data, usz size);
+
+		inline u64 getHits() const { return hits; }
+		inline u64 getMisses() const { return misses; }
+		inline u64 getSize() const { return size; }
+		inline u64 getMaxSize() const { return maxSize; }
+
+	private:
+
+		//Keys ordered from least to most recently used
+
+		using UseList = std::list<u64>;
+
+		struct Item {
+			u64 size;
+			UseList::iterator use;
+		};
+
+		String directory;
+		u64 maxSize;
+
+		std::mutex mutex;
+		HashMap<u64, Item> items;
+		UseList uses;
+		u64 size{};
+
+		std::atomic<u64> hits{}, misses{};
+
+		String getPath(u64 key) const;
+
+		//Add or replace an image as the most recently used (mutex has to be locked)
+		void insert(u64 key, u64 fileSize);
+
+		//Remove an image from the index (mutex has to be locked)
+		void erase(HashMap<u64, Item>::iterator it);
+
+		//Remove the least recently used images until the size fits (mutex has to be locked)
+		void evict();
+	};
+
+}
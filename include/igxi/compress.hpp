@@ -0,0 +1,79 @@
+#pragma once
+#include "igxi/convert.hpp"
+
+namespace igxi {
+
+	//Compressed formats that can be generated
+
+	enum class CompressedFormat : u8 {
+
+		BC1,
+		BC1_SRGB,
+		BC3,
+		BC3_SRGB,
+		BC4,
+		BC5,
+		BC7,
+		BC7_SRGB,
+
+		ASTC_4x4,
+		ASTC_4x4_SRGB,
+		ASTC_6x6,
+		ASTC_6x6_SRGB,
+		ASTC_8x8,
+		ASTC_8x8_SRGB,
+
+		COUNT
+	};
+
+	struct CompressedFormatInfo {
+		const char *name;			//Name of the GPUFormat
+		u8 blockWidth, blockHeight, blockBytes;
+	};
+
+	//Get the block size and name of a compressed format
+	const CompressedFormatInfo &getCompressedFormatInfo(CompressedFormat format);
+
+	//Find the GPUFormat of a compressed format
+	//Compressed formats don't follow the bit layout of the other formats, so they're looked up by name
+	//Returns GPUFormat::NONE if the graphics api doesn't know the format
+	ignis::GPUFormat getGPUFormat(CompressedFormat format);
+
+	//Whether the format is one of the compressed formats (as returned by getGPUFormat)
+	bool isCompressed(ignis::GPUFormat format);
+
+	//Compress every mip, layer and z of in.data[formatId] into blocks of the compressed format
+	//The input has to be 8-bit (unorm or srgb); out gets one buffer per mip
+	//"Quality" can be set to 0->1 and decides how much time is spent per block (0 is the fast preset)
+	Helper::ErrorMessage compress(
+		const IGXI &in, u16 formatId, CompressedFormat format, f32 quality, List<Buffer> &out, u32 threads = 0
+	);
+
+	//Compress in.data[formatId] into multiple compressed formats at once; out gets one List<Buffer> per format
+	//The block rows of all formats are spread over the same threads
+	Helper::ErrorMessage compress(
+		const IGXI &in, u16 formatId, const List<CompressedFormat> &formats, f32 quality,
+		List<List<Buffer>> &out, u32 threads = 0
+	);
+
+	//Whether or not the alpha channel of the base mip is used (for 4 channel formats that can be compressed)
+	//It's unused if every pixel has the same alpha of 0 or 255
+	bool usesAlpha(const IGXI &in, u16 formatId = 0);
+
+	//Get the compressed formats compress(out, flags, ...) would pick for the format
+	//Formats that aren't known by the graphics api are skipped; empty if the format can't be compressed
+	//"Alpha" is whether the alpha channel is used; it decides between BC1 and BC3
+	List<CompressedFormat> getCompressionTargets(
+		ignis::GPUFormat format, Helper::Flags flags, f32 quality, bool alpha
+	);
+
+	//Pick suitable compressed formats for in.format[0] and replace it with the compressed versions
+	//With KEEP_UNCOMPRESSED, the compressed versions are added after it instead
+	//Formats that can't be compressed (or aren't known by the graphics api) are left as is
+	//The COMPRESS_* flags decide the targets (COMPRESS_BC if none are set):
+	//	BC4 for 1 channel, BC5 for 2 channels,
+	//	BC7 for 3/4 channels if quality >= .5, otherwise BC1 (if alpha is unused) or BC3
+	//	ASTC 4x4, 6x6 and/or 8x8 for any channel count
+	Helper::ErrorMessage compress(IGXI &out, Helper::Flags flags, f32 quality, u32 threads = 0);
+
+}
\ No newline at end of file
@@ -5,6 +5,9 @@
 
 namespace igxi {
 
+	struct DecodeCache;
+	struct FileIndex;
+
 	//Supports the following formats:
 	//	hdr (defaulted as 16-bit float)
 	//	png/jpg/bmp/gif/pic/pnm/tga (defaulted as 8-bit unorm)
@@ -65,7 +68,7 @@ namespace igxi {
 		PIC, 
 		PNM, 
 		//TIFF,		TODO
-		//DDS,		TODO (almost any format)
+		//DDS,		TODO (almost any format); reading DDS and KTX2 is supported by Helper::convertContainer
 		//OPENEXR,	TODO (almost any format)
 		PSD
 		*/
@@ -120,17 +123,49 @@ namespace igxi {
 		//			If GENERATE_MIPS is not set, it will require the mip then a seperator and then the arraySlice
 		//				E.g. 'right0-1', 'right.0.1', 'top-1_2', etc.
 		//	
+		//		If CUBE_FROM_IMAGE is set; every file is a whole cube instead (no suffix), its layer is the cube index
+		//			The layout is detected by aspect ratio: 2:1 equirectangular panorama, 4:3 or 3:4 cross (see CubeLayout)
+		//			Panoramas are resampled bilinearly to faces of width / 4; faces of crosses are copied
+		//			Other aspect ratios (e.g. a panorama that isn't exactly 2:1) return INVALID_IMAGE_SIZE
+		//	
 		//	If IS_ARRAY is set, it will include files with the path name and a number after it
 		//		If a number is missing, it ignores it. All numbers are put from lowest to highest
 		//
+		//	If FRAMES_FROM_IMAGE is set; every frame of a multi-frame file (animated gif) is its own layer (IS_ARRAY) or z (IS_3D)
+		//		The file name doesn't have a slice number; all frames of the file are decoded in one pass
+		//		With descs, the frames of a file are consecutive (its layer or z is multiplied by the frame count)
+		//		Every file needs the same number of frames; a 3D texture can't load its mips (only generate them)
+		//		It can't be combined with IS_CUBE
+		//
 		//Load hints:
 		//
-		//	If GENERATE_MIPS is set; it will generate linear mips
+		//	If GENERATE_MIPS is set; it will generate all mips from the base mip
+		//		Each mip is filtered from the previous one with the MIP_* filter (MIP_LINEAR by default)
+		//		MIP_LINEAR averages sRGB formats in linear space
+		//		MIP_PREMULTIPLY (only with MIP_LINEAR) weighs the color by alpha, so transparent texels don't bleed into the rest
+		//			The same as premultiplying, filtering and dividing by alpha again; the mips are stored unpremultiplied
+		//		MIP_PRESERVE_COVERAGE rescales the alpha of every mip to keep the coverage of mip 0 for an alpha test at .5
+		//		MIP_MITCHELL, MIP_LANCZOS and MIP_KAISER resample every mip from the previous one instead (see resample.hpp)
+		//			They can't be used for 3D textures and can't be combined with MIP_PREMULTIPLY
+		//		MIP_GGX prefilters the radiance of float cubes (e.g. hdr) for GGX specular; mip i has roughness i / (mips - 1)
+		//			It is importance sampled from the whole cube, so cubes are never split over batches
+		//			The irradiance can be read from the result with getIrradianceSH (see prefilter.hpp)
 		//		Otherwise it will look for a number (which can have a separator in-between)
 		//		path.0, path0, path-0, etc.
 		//
+		//	If one of MAX_SIZE_* is set; images bigger than it are downscaled (keeping the aspect ratio) while they're loaded
+		//		With the filter of MIP_MITCHELL, MIP_LANCZOS or MIP_KAISER (MIP_MITCHELL if none are set)
+		//		The faces of cubes from one image are clamped instead of the image
+		//		Mips that are loaded (instead of generated) are resampled to the size that fits the downscaled base mip
+		//
 		//	If DO_COMPRESSION is set; it will attempt to find suitable compression and ONLY use that
-		//		Both S3TC/BC and ASTC
+		//		Unless KEEP_UNCOMPRESSED is set; then format 0 stays uncompressed and the compressed formats follow it
+		//		Both S3TC/BC and ASTC; the COMPRESS_* flags select which (COMPRESS_BC if none are set)
+		//		Every selected target is stored as its own format in the same IGXI
+		//		8-bit formats are compressed to BC4 (R), BC5 (RG) or BC7/BC1/BC3 (RGB(A)) depending on quality
+		//		ASTC 4x4, 6x6 and 8x8 can be used for any 8-bit format
+		//		Quality 0 is the fast preset (for iteration builds); it tries one block mode without refinement
+		//		Other formats (or ones unknown to the graphics api) are left uncompressed
 		//
 		//Format hints:
 		//
@@ -174,7 +209,7 @@ namespace igxi {
 		//		MEMORY_GPU_WRITE	(The resource can be written to from GPU)
 		//
 		//
-		enum Flags : u32 {
+		enum Flags : u64 {
 
 			//Type
 
@@ -239,13 +274,61 @@ namespace igxi {
 			MEMORY_CPU_WRITE = 1 << 25,
 			MEMORY_GPU_WRITE = 1 << 26,
 
-			//Mip generation; TODO: needs a count
+			//Mip generation; generates the full chain
 
 			MIP_LINEAR = 0,
 			MIP_NEAREST = 1 << 27,
 			MIP_MIN = 1 << 28,
 			MIP_MAX = 1 << 29,
 
+			//Compression targets (only with DO_COMPRESSION); multiple can be combined
+
+			COMPRESS_BC = 1 << 30,
+			COMPRESS_ASTC_4x4 = u64(1) << 31,
+			COMPRESS_ASTC_6x6 = u64(1) << 32,
+			COMPRESS_ASTC_8x8 = u64(1) << 33,
+
+			PROPERTY_COMPRESSION = COMPRESS_BC | COMPRESS_ASTC_4x4 | COMPRESS_ASTC_6x6 | COMPRESS_ASTC_8x8,
+
+			//Cube from one image per cube (only with IS_CUBE)
+
+			CUBE_FROM_IMAGE = u64(1) << 34,
+
+			//Mip generation for cubes (only with IS_CUBE and a float format); see MIP_LINEAR for the others
+
+			MIP_GGX = u64(1) << 35,
+
+			//Alpha handling of mip generation (for formats with alpha)
+
+			MIP_PREMULTIPLY = u64(1) << 36,
+			MIP_PRESERVE_COVERAGE = u64(1) << 37,
+
+			//Resampling filters; for mip generation (instead of MIP_LINEAR's 2x2 box) and MAX_SIZE_*
+
+			MIP_MITCHELL = u64(1) << 38,
+			MIP_LANCZOS = u64(1) << 39,
+			MIP_KAISER = u64(1) << 40,
+
+			//Biggest dimension of the input; 2^(n + 4) with n in the 4-bit PROPERTY_MAX_SIZE (0 is unlimited)
+
+			MAX_SIZE_256 = u64(4) << 41,
+			MAX_SIZE_512 = u64(5) << 41,
+			MAX_SIZE_1024 = u64(6) << 41,
+			MAX_SIZE_2048 = u64(7) << 41,
+			MAX_SIZE_4096 = u64(8) << 41,
+			MAX_SIZE_8192 = u64(9) << 41,
+			MAX_SIZE_16384 = u64(10) << 41,
+
+			PROPERTY_MAX_SIZE = u64(0xF) << 41,
+
+			//Layers (IS_ARRAY) or slices (IS_3D) from the frames of one file
+
+			FRAMES_FROM_IMAGE = u64(1) << 45,
+
+			//Keep the uncompressed format as format 0 and add the compressed formats after it (only with DO_COMPRESSION)
+
+			KEEP_UNCOMPRESSED = u64(1) << 46,
+
 			//Default values
 
 			NONE = 0,
@@ -269,6 +352,7 @@ namespace igxi {
 		//	IS_3D with IS_1D, IS_2D, IS_CUBE, IS_MS, IS_ARRAY
 		//	IS_CUBE with IS_1D, IS_2D, IS_3D, IS_MS
 		//	IS_MS with IS_1D, IS_3D, IS_CUBE
+		//	FRAMES_FROM_IMAGE with IS_CUBE or without IS_ARRAY or IS_3D
 		//
 		//INVALID_CHANNELS is generated if any of the channel flags are combined which each other
 		//	e.g. IS_R, IS_RG, IS_RGB, IS_RGBA
@@ -290,13 +374,17 @@ namespace igxi {
 		//INVALID_IMAGE_SIZE is generated if the parsed size is too small or too big
 		//INVALID_RESOURCE_INDEX is if the mip, layer or z is out of bounds
 		//INVALID_OPERATION is generated if an operation is unimplemented
+		//INCOMPATIBLE_FORMATS is generated if the input format can't be converted to the requested format
+		//INVALID_MIP_FILTER is generated if more than one of MIP_NEAREST, MIP_MIN, MIP_MAX, MIP_GGX and the resampling filters are set
+		//	or if MIP_PREMULTIPLY is used with another filter than MIP_LINEAR, or MIP_GGX is used with the alpha flags
+		//	or if a resampling filter is used for a 3D texture
 		//
 		//MISSING_FACE is if a face of the cube is missing
 		//MISSING_MIP is if GENERATE_MIP is off and one of the mips isn't provided
 		//MISSING_PATHS is if the paths are missing
 		//MISSING_RESOURCE_INDEX is if one of the subresources is missing from input
 		//
-		//CONFLICTING_IMAGE_SIZE is if one of the input images is a different size than another
+		//CONFLICTING_IMAGE_SIZE is if one of the input images is a different size (or frame count) than another
 		//
 		//CONFLICTING_IMAGE_FORMAT is if one of the input images has a different format than another
 		//	Happens when non-hdr textures are combined with hdr
@@ -327,6 +415,7 @@ namespace igxi {
 			INVALID_FILE_NAME_MIP,
 			INVALID_OPERATION,
 			INCOMPATIBLE_FORMATS,
+			INVALID_MIP_FILTER,
 
 			MISSING_FACE = 0x21,
 			MISSING_PATHS,
@@ -347,14 +436,118 @@ namespace igxi {
 			ImageIdentifier iid;
 		};
 
+		//The size and format of a file, as read from its header
+		struct ImageInfo {
+			ignis::GPUFormat format;		//The format it is converted to (with the given flags)
+			u16 width, height;				//As it is decoded (after IS_1D, but before MAX_SIZE_* and CUBE_FROM_IMAGE)
+			u8 channels, bytesPerChannel;	//Of the file itself (hdr is 4 bytes per channel)
+			u16 frames;						//1 unless it's a multi-frame file and FRAMES_FROM_IMAGE is set
+		};
+
+		//The layout of a raw (headerless) file; the slices are stored after each other
+		struct RawDesc {
+			ignis::GPUFormat format;		//Of the texels in the file
+			u16 width, height, length = 1;	//Length is the number of slices (z with IS_3D, otherwise layers)
+			usz offset{};					//Bytes before the first texel
+			usz rowPitch{};					//Bytes from one row to the next; 0 = width * texel size
+		};
+
 		//Look up names starting with path and combine them into one IGXI
-		static ErrorMessage convert(IGXI &out, const String &path, Flags flags = DEFAULT);
+		//The path is without extension; the names are parsed as described in the Flags comment
+		//"Quality" can be set to 0->1; higher quality compression takes longer (only used with DO_COMPRESSION)
+		//"Threads" is how many threads can be used; 0 = all hardware threads
+		static ErrorMessage convert(IGXI &out, const String &path, Flags flags = DEFAULT, f32 quality = 1, u32 threads = 0);
+
+		//Look up names starting with name in an index of a directory and combine them into one IGXI
+		//Use this when converting multiple textures from the same directory, so it's only listed once
+		//"Quality" can be set to 0->1; higher quality compression takes longer (only used with DO_COMPRESSION)
+		//"Threads" is how many threads can be used; 0 = all hardware threads
+		static ErrorMessage convert(
+			IGXI &out, const FileIndex &index, const String &name, Flags flags = DEFAULT, f32 quality = 1, u32 threads = 0
+		);
 
 		//Convert a couple files by name into an IGXI file
-		static ErrorMessage convert(IGXI &out, const List<String> &paths, Flags flags = DEFAULT);
+		//The cube face, z, mip, array slice and sample are parsed from the name (see the Flags comment)
+		//A single .dds or .ktx2 path is passed to convertContainer; combined with other files it returns INVALID_OPERATION
+		//"Quality" can be set to 0->1; higher quality compression takes longer (only used with DO_COMPRESSION)
+		//"Threads" is how many threads can be used; 0 = all hardware threads
+		static ErrorMessage convert(IGXI &out, const List<String> &paths, Flags flags = DEFAULT, f32 quality = 1, u32 threads = 0);
+
+		//Read the headers of a couple files (in parallel) without decoding them; infos receives one ImageInfo per file
+		//If multiple fail, the error of the first one (in order of descs) is returned
+		//"Threads" is how many threads can be used; 0 = all hardware threads
+		static ErrorMessage probe(
+			const List<FileDesc> &descs, List<ImageInfo> &infos, Flags flags = DEFAULT, u32 threads = 0
+		);
 
 		//Convert a couple files (with description) into an IGXI file
-		static ErrorMessage convert(IGXI &out, const List<FileDesc> &descs, Flags flags = DEFAULT);
+		//The headers of all files are probed first (see probe), so inconsistent sizes or formats are found
+		//	before anything is decoded, and the IGXI is allocated once with the right size
+		//Files are decoded in parallel; if multiple fail, the error of the first one (in order of descs) is returned
+		//With DO_COMPRESSION, layers are decoded, mipped and compressed in batches of one layer per thread,
+		//	so only one batch is kept uncompressed at a time (errors are then reported per batch)
+		//	Alpha is checked on every batch; if the first to use it isn't the first batch, the batches before it
+		//	are converted again, so every layer has the same formats (e.g. BC3 instead of BC1)
+		//"Quality" can be set to 0->1; higher quality compression takes longer (only used with DO_COMPRESSION)
+		//"Threads" is how many threads can be used; 0 = all hardware threads
+		//"Cache" is optional; files that were decoded before (with the same flags) are then copied from there instead
+		//	It only holds decoded images, so mips and compression are still generated (it only saves the decoding)
+		static ErrorMessage convert(
+			IGXI &out, const List<FileDesc> &descs, Flags flags = DEFAULT, f32 quality = 1, u32 threads = 0, 
+			DecodeCache *cache = nullptr
+		);
+
+		//Convert a raw (headerless) file, e.g. a volume from a simulation, into an IGXI file
+		//The file is mapped and every slice is copied (or converted) straight from it into mip 0, without decoding
+		//The format flags override the parts of desc.format they set (e.g. IS_16_BIT for R32F to R16F), 
+		//	as long as there's a kernel for it (only float formats can change bit depth)
+		//IS_ARRAY (or IS_CUBE) is needed for multiple slices if it isn't IS_3D
+		//Returns INVALID_FILE_BOUNDS if the file is too small for the desc and INVALID_OPERATION for *_FROM_IMAGE and MAX_SIZE_*
+		//"Quality" can be set to 0->1; higher quality compression takes longer (only used with DO_COMPRESSION)
+		//"Threads" is how many threads can be used; 0 = all hardware threads
+		static ErrorMessage convertRaw(
+			IGXI &out, const String &path, const RawDesc &desc, Flags flags = IS_3D, f32 quality = 1, u32 threads = 0
+		);
+
+		//Convert a DDS or KTX2 file into an IGXI file without decoding it
+		//The format, type, mips and layers are read from its header and the data (e.g. BC7 blocks) is copied as is
+		//Only the memory flags are used; the data isn't mipped or compressed again
+		//Supports BC1/3/4/5/7, ASTC 4x4/6x6/8x8 (KTX2) and the common 8/16/32-bit uncompressed formats
+		//Returns INVALID_FORMAT for other formats, INVALID_OPERATION for supercompressed KTX2 files and INVALID_IMAGE_SIZE
+		//	for mips that don't fit IGXI's (rounded up) mip sizes; e.g. a 5x5 texture with mips
+		//"Threads" is how many threads can be used; 0 = all hardware threads
+		static ErrorMessage convertContainer(IGXI &out, const String &path, Flags flags = NONE, u32 threads = 0);
+
+		//Re-convert the layers of an existing IGXI that changed, instead of the whole IGXI
+		//"Changed" needs every file (z and mip, unless GENERATE_MIPS) of the layers that changed; all of them need a path
+		//	these layers are decoded, mipped and compressed and replace the old ones, the others are kept as is
+		//"Flags" should be the same as the IGXI was converted with
+		//For 3D textures, every z has to be passed, since the volume is converted completely (MISSING_RESOURCE_INDEX otherwise)
+		//With DO_COMPRESSION, the layers are compressed into the formats the IGXI already has instead of picking them again,
+		//	so e.g. an opaque layer of a BC3 array stays BC3
+		//Returns CONFLICTING_IMAGE_SIZE or CONFLICTING_IMAGE_FORMAT if the layers don't fit anymore (e.g. if the new
+		//	layers need BC3 instead of BC1); the IGXI then has to be converted completely
+		static ErrorMessage update(
+			IGXI &inout, const List<FileDesc> &changed, Flags flags = DEFAULT, f32 quality = 1, u32 threads = 0, 
+			DecodeCache *cache = nullptr
+		);
+
+		//A conversion of a couple files (with description) into an IGXI file
+		//See convert(IGXI&, const List<FileDesc>&, ...); "out" receives the result
+		struct Job {
+			IGXI out;
+			List<FileDesc> files;
+			Flags flags = DEFAULT;
+			f32 quality = 1;
+		};
+
+		//Convert multiple jobs at once; returns one ErrorMessage per job (in order of jobs)
+		//Jobs are handed out to a shared pool of threads, biggest (by input size) first.
+		//	The files, layers and tiles of a job are handed out by the same pool,
+		//	so threads without a job left help decode, mip and compress the ones that are still running
+		//"Threads" is how many threads can be used; 0 = all hardware threads
+		//"Cache" is optional and shared by all jobs; see convert(IGXI&, const List<FileDesc>&, ...)
+		static List<ErrorMessage> convertBatch(List<Job> &jobs, u32 threads = 0, DecodeCache *cache = nullptr);
 
 		//Convert to an IGXI description
 		//static ErrorMessage convert(const IGXI &out, const Description &desc, Flags flags = DEFAULT);
@@ -362,22 +555,38 @@ namespace igxi {
 		//Convert an IGXI's gpu format index to an external format format
 		//Returns an empty buffer if it cannot be converted
 		//"Quality" can be set to 0->1 depending on how much detail should be kept
-		static Buffer toExternal(const IGXI &in, ExternalFormat exFormat, ignis::GPUFormat format, const Vec3u16 &dim, u16 z, u16 layerId, u8 mipId, f32 quality = 1);
+		//	For lossless formats (PNG) it's the compression effort instead; 0 stores without compression (fastest)
+		//	The default (1) is PNG level 7 (see getPNGLevel); "maxEffort" uses level 9 instead, which tries every filter on every row
+		static Buffer toExternal(
+			const IGXI &in, ExternalFormat exFormat, ignis::GPUFormat format, const Vec3u16 &dim, u16 z, u16 layerId, u8 mipId, 
+			f32 quality = 1, bool maxEffort = false
+		);
 
 		//Whether or not the mentioned format can be represented by PNG format
 		//If quality == 1, the format has to be capable of representing lossless images
+		//Lossless formats are supported for any quality
 		static bool supportsExternal(ExternalFormat exFormat, ignis::GPUFormat format, f32 quality = 1);
 
 		//Output IGXI as png/jpg/hdr/dds/etc. depending on the GPUFormat
 		//Returns only the formats that are supported by the external file formats, so check result.size() with in.headers.formats
-		static HashMap<ignis::GPUFormat, List<Pair<FileDesc, Buffer>>> toMemoryExternal(const IGXI &in, f32 quality = 1);
+		//Images are encoded in parallel, but are returned in order of mip, layer and z
+		//"Threads" is how many threads can be used; 0 = all hardware threads
+		//"Quality" and "maxEffort" are the same as for toExternal; quality 1 is PNG level 7, level 9 has to be asked for with maxEffort
+		static HashMap<ignis::GPUFormat, List<Pair<FileDesc, Buffer>>> toMemoryExternal(
+			const IGXI &in, f32 quality = 1, u32 threads = 0, bool maxEffort = false
+		);
 
 		//Output IGXI as png/jpg/hdr/dds/etc. depending on the GPUFormat
-		//Returns the unsupported formats
+		//Returns the unsupported formats, or the formats of which an image couldn't be encoded or written
 		//On success (and successful write to "path"), the resulting List will be empty
 		//As this can return any type of image format, the path should be without an extension
 		//It also outputs layers as follows: path_z_layer_mip_formatName if multiple layers, mips or formats are present
-		static List<ignis::GPUFormat> toDiskExternal(const IGXI &in, const String &path, f32 quality = 1);
+		//Nothing is written if any format is unsupported. Otherwise images are written (and freed) as soon as they're encoded
+		//"Threads" is how many threads can be used; 0 = all hardware threads
+		//"Quality" and "maxEffort" are the same as for toExternal; quality 1 is PNG level 7, level 9 has to be asked for with maxEffort
+		static List<ignis::GPUFormat> toDiskExternal(
+			const IGXI &in, const String &path, f32 quality = 1, u32 threads = 0, bool maxEffort = false
+		);
 
 		//Load functions; returns IGXI with format.empty() if it failed
 
@@ -386,12 +595,23 @@ namespace igxi {
 		//If GPUFormat is NONE, the first supported format will be returned
 		static ignis::Texture::Info convert(const IGXI &in, const ignis::Graphics &g, ignis::GPUFormat format = ignis::GPUFormat::NONE);
 
+		//Convert to a texture info struct; see convert(const IGXI&, ...)
+		//"In" loses its data; the formats that aren't loaded are freed before the texture info copies the mips
+		//	and the mips are freed right after, so the loaded format is kept twice at most (not the whole IGXI and a copy)
+		static ignis::Texture::Info convert(IGXI &&in, const ignis::Graphics &g, ignis::GPUFormat format = ignis::GPUFormat::NONE);
+
 		//Load a Texture::Info from external format memory (1 image)
 		//Format is the format of the file you want to load. If it doesn't exist, it throws
 		//If GPUFormat is NONE, the first supported format will be returned
 		static ignis::Texture::Info loadMemoryExternal(const Buffer &data, const ignis::Graphics &g, Flags flags = Flags::DEFAULT_NO_MIPS_NO_COMPRESSION);
 
 		//Load a Texture::Info from external format memory (1 image)
+		//Takes ownership of the data, so the file isn't copied; the decoded IGXI is given to convert(IGXI&&, ...)
+		static ignis::Texture::Info loadMemoryExternal(Buffer &&data, const ignis::Graphics &g, Flags flags = Flags::DEFAULT_NO_MIPS_NO_COMPRESSION);
+
+		//Load a Texture::Info from an external format file (1 image)
+		//Files that are on disk are memory mapped (if possible) and decoded straight from there
+		//Others (e.g. virtual ~/ files) are read through oic::System::files()
 		//Format is the format of the file you want to load. If it doesn't exist, it throws
 		//If GPUFormat is NONE, the first supported format will be returned
 		static ignis::Texture::Info loadDiskExternal(const String &path, const ignis::Graphics &g, Flags flags = Flags::DEFAULT_NO_MIPS_NO_COMPRESSION);
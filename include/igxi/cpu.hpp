@@ -0,0 +1,96 @@
+#pragma once
+#include "types/vec.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+	#define IGXI_X86
+
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+		#include <immintrin.h>
+	#else
+		#include <cpuid.h>
+		#include <immintrin.h>
+	#endif
+
+#endif
+
+//Functions with IGXI_TARGET("avx") etc. may use the intrinsics of those instruction sets,
+//	without the whole library having to be compiled for them; so they may only be called if getCpuFeatures() has them
+//MSVC allows every intrinsic without flags, so there it's empty
+
+#if defined(IGXI_X86) && (defined(__GNUC__) || defined(__clang__))
+	#define IGXI_TARGET(x) __attribute__((target(x)))
+#else
+	#define IGXI_TARGET(x)
+#endif
+
+namespace igxi {
+
+	//Instruction sets beyond the compile flags that the CPU (and OS, for the 256-bit registers) supports
+
+	struct CpuFeatures {
+		bool ssse3, avx, f16c;
+	};
+
+	#ifdef IGXI_X86
+
+		inline void cpuid(u32 leaf, u32 regs[4]) {
+
+			#if defined(_MSC_VER) && !defined(__clang__)
+				__cpuidex((int*) regs, int(leaf), 0);
+			#else
+				__cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+			#endif
+		}
+
+		//Which register state the OS saves on a context switch (XCR0)
+
+		inline u64 getEnabledState() {
+
+			#if defined(_MSC_VER) && !defined(__clang__)
+				return _xgetbv(0);
+			#else
+				u32 lo, hi;
+				__asm__ ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+				return lo | (u64(hi) << 32);
+			#endif
+		}
+
+	#endif
+
+	inline const CpuFeatures &getCpuFeatures() {
+
+		static const CpuFeatures features = []() {
+
+			CpuFeatures res{};
+
+			#ifdef IGXI_X86
+
+				u32 regs[4]{};
+				cpuid(0, regs);
+
+				if (!regs[0])
+					return res;
+
+				cpuid(1, regs);
+
+				res.ssse3 = regs[2] & (1 << 9);
+
+				//The OS has to save the xmm and ymm registers for AVX to be usable
+
+				bool osxsave = regs[2] & (1 << 27);
+				bool ymm = osxsave && (getEnabledState() & 6) == 6;
+
+				res.avx = ymm && (regs[2] & (1 << 28));
+				res.f16c = res.avx && (regs[2] & (1 << 29));
+
+			#endif
+
+			return res;
+		}();
+
+		return features;
+	}
+
+}
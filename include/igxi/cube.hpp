@@ -0,0 +1,69 @@
+#pragma once
+#include "igxi/convert.hpp"
+#include <cmath>
+
+namespace igxi {
+
+	//Layouts of a whole cube in one image
+	//	EQUIRECTANGULAR is a 2:1 panorama (longitude, latitude); the center is -z (front) and the top is +y
+	//	HORIZONTAL_CROSS is a 4:3 cross; -x +z +x -z in the middle row, +y above and -y below +z
+	//	VERTICAL_CROSS is a 3:4 cross; -x +z +x in the second row, +y above and -y, -z (upside down) below +z
+	enum class CubeLayout : u8 {
+		EQUIRECTANGULAR,
+		HORIZONTAL_CROSS,
+		VERTICAL_CROSS,
+		NONE
+	};
+
+	//Direction (not normalized) through a point on a face (s and t are -1 -> 1, from left to right and top to bottom)
+	//Faces are in order of +x, -x, +y, -y, +z, -z
+	inline void getCubeDirection(u8 face, f32 s, f32 t, f32 *dir) {
+
+		switch (face) {
+			case 0:		dir[0] = 1;		dir[1] = -t;	dir[2] = -s;	break;
+			case 1:		dir[0] = -1;	dir[1] = -t;	dir[2] = s;		break;
+			case 2:		dir[0] = s;		dir[1] = 1;		dir[2] = t;		break;
+			case 3:		dir[0] = s;		dir[1] = -1;	dir[2] = -t;	break;
+			case 4:		dir[0] = s;		dir[1] = -t;	dir[2] = 1;		break;
+			default:	dir[0] = -s;	dir[1] = -t;	dir[2] = -1;	break;
+		}
+	}
+
+	//Face and point on the face (s and t are -1 -> 1) that a direction points at; the inverse of getCubeDirection
+	inline u8 getCubeFace(const f32 *dir, f32 &s, f32 &t) {
+
+		f32 ax = std::abs(dir[0]), ay = std::abs(dir[1]), az = std::abs(dir[2]);
+
+		if (ax >= ay && ax >= az) {
+			s = (dir[0] > 0 ? -dir[2] : dir[2]) / ax;
+			t = -dir[1] / ax;
+			return dir[0] > 0 ? 0 : 1;
+		}
+
+		if (ay >= az) {
+			s = dir[0] / ay;
+			t = (dir[1] > 0 ? dir[2] : -dir[2]) / ay;
+			return dir[1] > 0 ? 2 : 3;
+		}
+
+		s = (dir[2] > 0 ? dir[0] : -dir[0]) / az;
+		t = -dir[1] / az;
+		return dir[2] > 0 ? 4 : 5;
+	}
+
+	//Detect the layout by aspect ratio; NONE if it doesn't fit any
+	//Panoramas have to be exactly 2:1 and at least 4x2 (a face of 1x1)
+	CubeLayout getCubeLayout(u16 width, u16 height);
+
+	//Get the width (and height) of a face in the layout
+	u16 getCubeFaceSize(CubeLayout layout, u16 width, u16 height);
+
+	//Turn one image into the 6 faces (in order of +x, -x, +y, -y, +z, -z), which are written one after the other
+	//Crosses are copied, panoramas are sampled bilinearly (sRGB in linear space)
+	//Returns INVALID_FORMAT if the format can't be sampled, INVALID_IMAGE_SIZE if the size doesn't fit the layout
+	//	(e.g. a panorama that isn't exactly 2:1)
+	Helper::ErrorMessage toCube(
+		const u8 *src, u16 width, u16 height, ignis::GPUFormat format, CubeLayout layout, u8 *faces, u32 threads = 0
+	);
+
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include "types/vec.hpp"
+
+//Helpers shared by the block compression encoders (bc.cpp, astc.cpp)
+
+namespace igxi {
+
+	//Fit the endpoints along the principal axis of the first D channels of the pixels
+
+	template<usz D>
+	inline void fitEndpoints(const u8 (*px)[4], usz count, f32 *lo, f32 *hi) {
+
+		f32 mean[D]{}, minC[D], maxC[D];
+
+		for (usz c = 0; c < D; ++c) {
+			minC[c] = 255;
+			maxC[c] = 0;
+		}
+
+		for (usz i = 0; i < count; ++i)
+			for (usz c = 0; c < D; ++c) {
+				f32 v = px[i][c];
+				mean[c] += v;
+				minC[c] = std::min(minC[c], v);
+				maxC[c] = std::max(maxC[c], v);
+			}
+
+		for (usz c = 0; c < D; ++c)
+			mean[c] /= count;
+
+		f32 cov[D][D]{};
+
+		for (usz i = 0; i < count; ++i) {
+
+			f32 d[D];
+
+			for (usz c = 0; c < D; ++c)
+				d[c] = px[i][c] - mean[c];
+
+			for (usz a = 0; a < D; ++a)
+				for (usz b = 0; b < D; ++b)
+					cov[a][b] += d[a] * d[b];
+		}
+
+		//Power iteration, starting at the diagonal of the bounding box
+
+		f32 axis[D], length{};
+
+		for (usz c = 0; c < D; ++c) {
+			axis[c] = maxC[c] - minC[c];
+			length += axis[c] * axis[c];
+		}
+
+		if (length == 0) {
+
+			for (usz c = 0; c < D; ++c)
+				lo[c] = hi[c] = mean[c];
+
+			return;
+		}
+
+		for (usz it = 0; it < 8; ++it) {
+
+			f32 next[D]{}, biggest{};
+
+			for (usz a = 0; a < D; ++a) {
+
+				for (usz b = 0; b < D; ++b)
+					next[a] += cov[a][b] * axis[b];
+
+				biggest = std::max(biggest, std::abs(next[a]));
+			}
+
+			if (biggest == 0)
+				break;
+
+			for (usz c = 0; c < D; ++c)
+				axis[c] = next[c] / biggest;
+		}
+
+		length = 0;
+
+		for (usz c = 0; c < D; ++c)
+			length += axis[c] * axis[c];
+
+		length = std::sqrt(length);
+
+		for (usz c = 0; c < D; ++c)
+			axis[c] /= length;
+
+		//Project onto the axis to find the extremes
+
+		f32 tMin = f32_MAX, tMax = -f32_MAX;
+
+		for (usz i = 0; i < count; ++i) {
+
+			f32 t{};
+
+			for (usz c = 0; c < D; ++c)
+				t += (px[i][c] - mean[c]) * axis[c];
+
+			tMin = std::min(tMin, t);
+			tMax = std::max(tMax, t);
+		}
+
+		for (usz c = 0; c < D; ++c) {
+			lo[c] = std::clamp(mean[c] + axis[c] * tMin, 0.f, 255.f);
+			hi[c] = std::clamp(mean[c] + axis[c] * tMax, 0.f, 255.f);
+		}
+	}
+
+	//Fit the endpoints (e0 at weight 0, e1 at weight 1) with the least error for the given weights
+	//Returns false if they can't be solved (e.g. all pixels use the same weight)
+
+	template<usz D>
+	inline bool leastSquares(const u8 (*px)[4], usz count, usz channel, const f32 *weights, f32 *e0, f32 *e1) {
+
+		f32 alpha{}, beta{}, gamma{}, x[D]{}, y[D]{};
+
+		for (usz i = 0; i < count; ++i) {
+
+			f32 t = weights[i], s = 1 - t;
+
+			alpha += s * s;
+			beta += s * t;
+			gamma += t * t;
+
+			for (usz c = 0; c < D; ++c) {
+				x[c] += s * px[i][channel + c];
+				y[c] += t * px[i][channel + c];
+			}
+		}
+
+		f32 det = alpha * gamma - beta * beta;
+
+		if (std::abs(det) < 1e-6f)
+			return false;
+
+		for (usz c = 0; c < D; ++c) {
+			e0[c] = std::clamp((gamma * x[c] - beta * y[c]) / det, 0.f, 255.f);
+			e1[c] = std::clamp((alpha * y[c] - beta * x[c]) / det, 0.f, 255.f);
+		}
+
+		return true;
+	}
+
+	//Writes bits from LSB to MSB; out has to be zeroed
+
+	struct BitWriter {
+
+		u8 *out;
+		usz bit{};
+
+		inline void write(u32 v, usz n) {
+			for (usz i = 0; i < n; ++i, ++bit)
+				if ((v >> i) & 1)
+					out[bit >> 3] |= u8(1 << (bit & 7));
+		}
+	};
+
+}
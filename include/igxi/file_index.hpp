@@ -0,0 +1,50 @@
+#pragma once
+#include "igxi/convert.hpp"
+
+namespace igxi {
+
+	//The indices that are encoded in a file name (see the Helper::Flags comment)
+	//	name[sep][face][sep][z][sep][mip][sep][slice][sep][sample].extension
+	//Only the parts that the flags require are parsed (in that order); numbers after the first need a separator
+	//Separators are '.', '_' and '-'; faces are case-insensitive
+	struct ParsedFileName {
+		String base;
+		u16 side{}, sample{}, slice{}, z{};
+		u8 mip{};
+	};
+
+	//Parse the file name (directory and extension are ignored) of a path
+	//Returns INVALID_FILE_NAME_FACE, INVALID_FILE_NAME_MIP or INVALID_FILE_NAME_SLICE (also used for z and samples)
+	Helper::ErrorMessage parseFileName(const String &path, Helper::Flags flags, ParsedFileName &out);
+
+	//Whether or not the extension (including '.') is one that can be decoded (case-insensitive)
+	bool isSupportedExtension(const String &extension);
+
+	//Whether or not the extension is a DDS or KTX2 file; these are copied as is (see Helper::convertContainer)
+	bool isContainerExtension(const String &extension);
+
+	//An index of the decodable images in a directory
+	//The directory is listed once, after which any number of textures can be resolved from it
+	//	without touching the file system again
+	struct FileIndex {
+
+		//List the directory; if it can't be opened, the index is empty
+		FileIndex(const String &directory);
+
+		//Find all files that are part of the texture "name" (without directory and extension)
+		//Their parsed name has to have the same base as "name" (case-insensitive); other files are ignored
+		//Returns MISSING_PATHS if there are none
+		Helper::ErrorMessage find(const String &name, Helper::Flags flags, List<String> &paths) const;
+
+		inline const String &getDirectory() const { return directory; }
+		inline usz size() const { return files.size(); }
+
+	private:
+
+		String directory;
+
+		//Sorted by lowercase file name, so names starting with the same base are next to each other
+		List<Pair<String, String>> files;
+	};
+
+}
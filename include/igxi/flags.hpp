@@ -0,0 +1,60 @@
+#pragma once
+#include "igxi/convert.hpp"
+
+namespace igxi {
+
+	//Get the type of texture from the type flags
+
+	inline Helper::ErrorMessage getType(Helper::Flags flags, ignis::TextureType &type) {
+
+		using namespace ignis;
+
+		switch (flags & Helper::PROPERTY_TYPE) {
+
+			case 0:								type = TextureType::TEXTURE_2D;		break;
+			case Helper::IS_2D:					type = TextureType::TEXTURE_2D;		break;
+			case Helper::IS_CUBE:				type = TextureType::TEXTURE_CUBE;	break;
+			case Helper::IS_1D:					type = TextureType::TEXTURE_1D;		break;
+			case Helper::IS_3D:					type = TextureType::TEXTURE_3D;		break;
+
+			case Helper::IS_MS | Helper::IS_2D:
+			case Helper::IS_MS:					type = TextureType::TEXTURE_MS;		break;
+
+			default:							return Helper::INVALID_TYPE;
+		}
+
+		if (flags & Helper::IS_ARRAY) {
+			if (flags & Helper::IS_3D)	return Helper::INVALID_TYPE;
+			else						type = TextureType(u8(type) | u8(TextureType::PROPERTY_IS_ARRAY));
+		}
+
+		return Helper::SUCCESS;
+	}
+
+	//Get the memory usage from the memory flags
+
+	inline ignis::GPUMemoryUsage getUsage(Helper::Flags flags) {
+
+		using namespace ignis;
+
+		GPUMemoryUsage usage{};
+
+		if (flags & Helper::MEMORY_SHARED)
+			usage = GPUMemoryUsage::SHARED;
+
+		if (flags & Helper::MEMORY_PREFER)
+			usage |= GPUMemoryUsage::PREFER;
+
+		if (flags & Helper::MEMORY_CPU_READ)
+			usage |= GPUMemoryUsage::CPU_READ;
+
+		if (flags & Helper::MEMORY_CPU_WRITE)
+			usage |= GPUMemoryUsage::CPU_WRITE;
+
+		if (flags & Helper::MEMORY_GPU_WRITE)
+			usage |= GPUMemoryUsage::GPU_WRITE;
+
+		return usage;
+	}
+
+}
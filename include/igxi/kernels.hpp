@@ -0,0 +1,393 @@
+#pragma once
+#include "igxi/igxi.hpp"
+#include "igxi/cpu.hpp"
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define IGXI_SSE2
+	#include <emmintrin.h>
+#endif
+
+//SSSE3, AVX and F16C kernels are compiled for their own instruction set (see IGXI_TARGET)
+//	and only picked if the CPU supports it, so they don't need any compile flags
+
+#ifdef IGXI_SSE2
+	#define IGXI_SSSE3
+	#define IGXI_F16C
+#endif
+
+namespace igxi {
+
+	//Converts "pixels" pixels from src to dst; dst has to be big enough to hold all converted pixels
+	using ConversionKernel = void (*)(const u8 *src, u8 *dst, usz pixels);
+
+	//Conversion of one primitive
+	//Float conversions that lose precision are clamped to the max value of the target
+
+	template<typename Out, typename In>
+	struct ConvertPrimitive {
+		static inline Out apply(const In &in) { return in; }
+	};
+
+	template<>
+	struct ConvertPrimitive<f16, f32> {
+		static inline f16 apply(const f32 &in) {
+
+			f16 v = f16(in);
+
+			if (v.lacksPrecision())
+				v = f16::max();
+
+			return v;
+		}
+	};
+
+	template<>
+	struct ConvertPrimitive<f16, f64> {
+		static inline f16 apply(const f64 &in) {
+
+			f16 v = f16(in);
+
+			if (v.lacksPrecision())
+				v = f16::max();
+
+			return v;
+		}
+	};
+
+	template<>
+	struct ConvertPrimitive<f32, f64> {
+		static inline f32 apply(const f64 &in) {
+
+			f32 v = f32(in);
+
+			if ((*(flp32*)&v).lacksPrecision())
+				v = f32_MAX;
+
+			return v;
+		}
+	};
+
+	template<>
+	struct ConvertPrimitive<f32, f16> {
+		static inline f32 apply(const f16 &in) { return f32(in); }
+	};
+
+	template<>
+	struct ConvertPrimitive<f64, f16> {
+		static inline f64 apply(const f16 &in) { return f64(in); }
+	};
+
+	//Generic kernel; converts the first min(inC, outC) channels and zeroes the other output channels
+
+	template<typename Out, typename In, usz outC, usz inC>
+	inline void convertPixels(const u8 *src, u8 *dst, usz pixels) {
+
+		constexpr usz copyC = outC < inC ? outC : inC;
+
+		const In *in = (const In*) src;
+		Out *out = (Out*) dst;
+
+		for (usz i = 0; i < pixels; ++i, in += inC, out += outC) {
+
+			for (usz c = 0; c < copyC; ++c)
+				out[c] = ConvertPrimitive<Out, In>::apply(in[c]);
+
+			if constexpr (outC > copyC)
+				std::memset((void*)(out + copyC), 0, sizeof(Out) * (outC - copyC));
+		}
+	}
+
+	//Vectorized kernels for the common cases
+
+	#ifdef IGXI_SSSE3
+
+		//RGB to RGBA for 8-bit and 16-bit (alpha is zeroed)
+
+		template<typename T>
+		IGXI_TARGET("ssse3") inline void expandRgbToRgba(const u8 *src, u8 *dst, usz pixels) {
+
+			static_assert(sizeof(T) == 1 || sizeof(T) == 2, "expandRgbToRgba only supports 8-bit and 16-bit");
+
+			constexpr usz perStep = 16 / (sizeof(T) * 4);
+			constexpr usz safeStep = (16 + sizeof(T) * 3 - 1) / (sizeof(T) * 3);		//Reading 16 bytes may not go out of bounds
+
+			const __m128i mask = sizeof(T) == 1 ?
+				_mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1) :
+				_mm_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1);
+
+			usz i = 0;
+
+			for (; i + safeStep <= pixels; i += perStep, src += perStep * 3 * sizeof(T), dst += perStep * 4 * sizeof(T))
+				_mm_storeu_si128(
+					(__m128i*) dst,
+					_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) src), mask)
+				);
+
+			convertPixels<T, T, 4, 3>(src, dst, pixels - i);
+		}
+
+	#endif
+
+	#ifdef IGXI_SSE2
+
+		//f32 to f64 with the same channel count
+
+		inline void f32ToF64(const f32 *in, f64 *out, usz count) {
+
+			usz i = 0;
+
+			for (; i + 2 <= count; i += 2)
+				_mm_storeu_pd(out + i, _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(in + i)))));
+
+			for (; i < count; ++i)
+				out[i] = f64(in[i]);
+		}
+
+		template<usz c>
+		inline void f32ToF64Pixels(const u8 *src, u8 *dst, usz pixels) {
+			f32ToF64((const f32*) src, (f64*) dst, pixels * c);
+		}
+
+		template<usz c>
+		IGXI_TARGET("avx") inline void f32ToF64PixelsAvx(const u8 *src, u8 *dst, usz pixels) {
+
+			usz count = pixels * c, i = 0;
+
+			const f32 *in = (const f32*) src;
+			f64 *out = (f64*) dst;
+
+			for (; i + 4 <= count; i += 4)
+				_mm256_storeu_pd(out + i, _mm256_cvtps_pd(_mm_loadu_ps(in + i)));
+
+			f32ToF64(in + i, out + i, count - i);
+		}
+
+		//f32 to f16 with the same channel count, rounded to nearest even
+		//Values that don't fit (and inf/NaN) become f16::max(), just like ConvertPrimitive<f16, f32>
+
+		inline __m128i f32ToF16(__m128 f) {
+
+			const __m128i signMask = _mm_set1_epi32(i32(0x80000000));
+			const __m128i f16Overflow = _mm_set1_epi32((127 + 16) << 23);			//Rounds to inf or more
+			const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);				//Smallest that is a normal f16
+			const __m128i subnormalMagic = _mm_set1_epi32((127 - 15 + 23 - 10 + 1) << 23);
+			const __m128i normalBias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));	//Rebias exponent and round
+
+			__m128i bits = _mm_castps_si128(f);
+			__m128i sign = _mm_and_si128(bits, signMask);
+			__m128i abs = _mm_xor_si128(bits, sign);
+
+			//Subnormals; adding the magic number lets the FPU round the mantissa to 10 bits
+
+			__m128i subnormal = _mm_sub_epi32(
+				_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(abs), _mm_castsi128_ps(subnormalMagic))), 
+				subnormalMagic
+			);
+
+			//Normals; round half to even by adding 0xFFF (+1 if the lowest kept bit is odd)
+
+			__m128i odd = _mm_srai_epi32(_mm_slli_epi32(abs, 31 - 13), 31);
+			__m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(abs, normalBias), odd), 13);
+
+			__m128i isSubnormal = _mm_cmpgt_epi32(minNormal, abs);
+			__m128i res = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+
+			//Inf, NaN and anything that rounds to inf is clamped to max (without sign, like f16::max())
+
+			__m128i lacksPrecision = _mm_or_si128(
+				_mm_cmpgt_epi32(abs, _mm_sub_epi32(f16Overflow, _mm_set1_epi32(1))),
+				_mm_cmpgt_epi32(res, _mm_set1_epi32(0x7BFF))
+			);
+
+			res = _mm_or_si128(res, _mm_srli_epi32(sign, 16));
+
+			return _mm_or_si128(
+				_mm_and_si128(lacksPrecision, _mm_set1_epi32(0x7BFF)), 
+				_mm_andnot_si128(lacksPrecision, res)
+			);
+		}
+
+		template<usz c>
+		inline void f32ToF16Pixels(const u8 *src, u8 *dst, usz pixels) {
+
+			usz count = pixels * c, i = 0;
+
+			const f32 *in = (const f32*) src;
+			u16 *out = (u16*) dst;
+
+			//Results are in [0, 0xFFFF], so subtracting 0x8000 makes the signed pack lossless
+
+			const __m128i bias = _mm_set1_epi32(0x8000);
+
+			for (; i + 8 <= count; i += 8) {
+
+				__m128i lo = _mm_sub_epi32(f32ToF16(_mm_loadu_ps(in + i)), bias);
+				__m128i hi = _mm_sub_epi32(f32ToF16(_mm_loadu_ps(in + i + 4)), bias);
+
+				_mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(_mm_packs_epi32(lo, hi), _mm_set1_epi16(i16(0x8000))));
+			}
+
+			convertPixels<f16, f32, 1, 1>((const u8*)(in + i), (u8*)(out + i), count - i);
+		}
+
+	#endif
+
+	#ifdef IGXI_F16C
+
+		//f16 to f32 with the same channel count
+
+		template<usz c>
+		IGXI_TARGET("avx,f16c") inline void f16ToF32Pixels(const u8 *src, u8 *dst, usz pixels) {
+
+			usz count = pixels * c, i = 0;
+
+			const u16 *in = (const u16*) src;
+			f32 *out = (f32*) dst;
+
+			for (; i + 8 <= count; i += 8) {
+
+				__m128i h = _mm_loadu_si128((const __m128i*)(in + i));
+				__m256 f = _mm256_cvtph_ps(h);
+
+				//F16C sets the quiet bit of signaling NaNs, while f32(f16) keeps the payload as is
+
+				__m128i isSignaling = _mm_andnot_si128(
+					_mm_cmpeq_epi16(_mm_and_si128(h, _mm_set1_epi16(0x1FF)), _mm_setzero_si128()),
+					_mm_cmpeq_epi16(_mm_and_si128(h, _mm_set1_epi16(0x7E00)), _mm_set1_epi16(0x7C00))
+				);
+
+				if (_mm_movemask_epi8(isSignaling)) {
+
+					const __m128i quietBit = _mm_set1_epi32(1 << 22);
+
+					f = _mm256_andnot_ps(
+						_mm256_castsi256_ps(_mm256_set_m128i(
+							_mm_and_si128(_mm_unpackhi_epi16(isSignaling, isSignaling), quietBit),
+							_mm_and_si128(_mm_unpacklo_epi16(isSignaling, isSignaling), quietBit)
+						)),
+						f
+					);
+				}
+
+				_mm256_storeu_ps(out + i, f);
+			}
+
+			convertPixels<f32, f16, 1, 1>((const u8*)(in + i), (u8*)(out + i), count - i);
+		}
+
+	#endif
+
+	//Kernel tables for a type pair; [outC - 1][inC - 1]
+
+	template<typename Out, typename In, usz ...i>
+	inline ConversionKernel getKernel(usz outC, usz inC, std::index_sequence<i...>) {
+
+		static constexpr ConversionKernel kernels[] = { &convertPixels<Out, In, i / 4 + 1, i % 4 + 1>... };
+
+		return kernels[(outC - 1) * 4 + (inC - 1)];
+	}
+
+	template<typename Out, typename In>
+	inline ConversionKernel getKernel(usz outC, usz inC) {
+
+		//Common cases that have a vectorized version
+
+		#ifdef IGXI_SSE2
+			const CpuFeatures &cpu = getCpuFeatures();
+		#endif
+
+		#ifdef IGXI_SSSE3
+
+			if constexpr (std::is_same_v<Out, In> && sizeof(In) <= 2)
+				if (outC == 4 && inC == 3 && cpu.ssse3)
+					return &expandRgbToRgba<In>;
+
+		#endif
+
+		#ifdef IGXI_SSE2
+
+			if constexpr (std::is_same_v<Out, f64> && std::is_same_v<In, f32>)
+				if (outC == inC) {
+
+					static constexpr ConversionKernel kernels[] = {
+						&f32ToF64Pixels<1>, &f32ToF64Pixels<2>, &f32ToF64Pixels<3>, &f32ToF64Pixels<4>
+					};
+
+					static constexpr ConversionKernel avxKernels[] = {
+						&f32ToF64PixelsAvx<1>, &f32ToF64PixelsAvx<2>, &f32ToF64PixelsAvx<3>, &f32ToF64PixelsAvx<4>
+					};
+
+					return (cpu.avx ? avxKernels : kernels)[inC - 1];
+				}
+
+			if constexpr (std::is_same_v<Out, f16> && std::is_same_v<In, f32>)
+				if (outC == inC) {
+
+					static constexpr ConversionKernel kernels[] = {
+						&f32ToF16Pixels<1>, &f32ToF16Pixels<2>, &f32ToF16Pixels<3>, &f32ToF16Pixels<4>
+					};
+
+					return kernels[inC - 1];
+				}
+
+		#endif
+
+		#ifdef IGXI_F16C
+
+			if constexpr (std::is_same_v<Out, f32> && std::is_same_v<In, f16>)
+				if (outC == inC && cpu.f16c) {
+
+					static constexpr ConversionKernel kernels[] = {
+						&f16ToF32Pixels<1>, &f16ToF32Pixels<2>, &f16ToF32Pixels<3>, &f16ToF32Pixels<4>
+					};
+
+					return kernels[inC - 1];
+				}
+
+		#endif
+
+		return getKernel<Out, In>(outC, inC, std::make_index_sequence<16>{});
+	}
+
+	//Pick the kernel that converts input to target with the given channel counts
+	//Only float formats can change stride; same stride formats are copied as-is
+	//Returns nullptr if there's no kernel for the combination
+
+	inline ConversionKernel getConversionKernel(
+		ignis::GPUFormat target, ignis::GPUFormat input, usz outC, usz inC
+	) {
+
+		using namespace ignis;
+
+		if (outC - 1 >= 4 || inC - 1 >= 4)
+			return nullptr;
+
+		usz outStride = FormatHelper::getStrideBytes(target);
+		usz inStride = FormatHelper::getStrideBytes(input);
+
+		if (outStride == inStride)
+			switch (outStride) {
+				case 1:		return getKernel<u8, u8>(outC, inC);
+				case 2:		return getKernel<u16, u16>(outC, inC);
+				case 4:		return getKernel<u32, u32>(outC, inC);
+				case 8:		return getKernel<u64, u64>(outC, inC);
+				default:	return nullptr;
+			}
+
+		if (FormatHelper::getType(target) != GPUFormatType::FLOAT || FormatHelper::getType(input) != GPUFormatType::FLOAT)
+			return nullptr;
+
+		switch ((outStride << 4) | inStride) {
+			case 0x24:	return getKernel<f16, f32>(outC, inC);
+			case 0x28:	return getKernel<f16, f64>(outC, inC);
+			case 0x42:	return getKernel<f32, f16>(outC, inC);
+			case 0x48:	return getKernel<f32, f64>(outC, inC);
+			case 0x82:	return getKernel<f64, f16>(outC, inC);
+			case 0x84:	return getKernel<f64, f32>(outC, inC);
+			default:	return nullptr;
+		}
+	}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "types/vec.hpp"
+
+namespace igxi {
+
+	//A read-only view of a file
+	//The file is mapped into memory if the OS allows it, so nothing has to be read up front
+	//	and the pages are shared with every other process (or thread) that reads the same file
+	//Otherwise it falls back to reading the whole file into a buffer
+	//
+	struct MappedFile {
+
+		//Check if data() is null to see if the file could be opened
+		MappedFile(const String &path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) = delete;
+		MappedFile &operator=(const MappedFile&) = delete;
+		MappedFile &operator=(MappedFile&&) = delete;
+
+		inline const u8 *data() const { return view; }
+		inline usz size() const { return length; }
+		inline bool isMapped() const { return mapped; }
+
+	private:
+
+		const u8 *view{};
+		usz length{};
+		bool mapped{};
+
+		Buffer fallback;
+
+		//Returns false if the file has to be read instead
+		bool map(const String &path);
+		bool read(const String &path);
+	};
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "igxi/convert.hpp"
+
+namespace igxi {
+
+	//Get the number of mips needed to go from the given size to 1x1x1 (each mip is ceil(x / 2))
+	inline u16 getMipCount(u16 width, u16 height, u16 length) {
+
+		u16 biggest = std::max(std::max(width, height), length), mips = 1;
+
+		for (; biggest > 1; ++mips)
+			biggest = u16((biggest + 1) / 2);
+
+		return mips;
+	}
+
+	//Generate mip 1 until out.header.mips from mip 0 of the given format
+	//Every mip is generated from the previous one (2x2 or 2x2x2 for 3D textures)
+	//	an odd size is handled by reusing the last row/column/slice
+	//
+	//The filter is picked from the MIP_* flags; MIP_LINEAR is done in linear space for sRGB formats
+	//MIP_PREMULTIPLY weighs the color by alpha and MIP_PRESERVE_COVERAGE rescales the alpha of every mip after
+	//MIP_MITCHELL, MIP_LANCZOS and MIP_KAISER resample the previous mip with a wider filter (see resample)
+	//MIP_GGX doesn't reduce the previous mip, but prefilters every mip from the whole cube (see prefilterCube)
+	//
+	//Returns INVALID_MIP_FILTER if multiple filters are set and INVALID_FORMAT if the format isn't supported
+	//
+	Helper::ErrorMessage generateMips(IGXI &out, u16 formatId, Helper::Flags flags, u32 threads = 0);
+
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+#include "types/vec.hpp"
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace igxi {
+
+	//Get the number of threads to use for a number of jobs
+	//If threads is 0, all hardware threads are used
+	inline u32 getThreadCount(u32 threads, usz jobs) {
+
+		if (!threads)
+			threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+		return u32(std::min(usz(threads), jobs));
+	}
+
+	//Lower an atomic to val if it is bigger
+	inline void atomicMin(std::atomic<usz> &target, usz val) {
+
+		usz current = target.load(std::memory_order_relaxed);
+
+		while (val < current && !target.compare_exchange_weak(current, val, std::memory_order_relaxed))
+			;
+	}
+
+	//The threads that every parallelFor is run on; they're created once and wait for work in between
+	//Work is one shared queue of loops; an idle thread joins the newest loop that still has indices left,
+	//	so a loop that is started from inside another one (e.g. per tile of a job) is helped first,
+	//	and nested loops never create more threads than there are hardware threads
+	struct ThreadPool {
+
+		using Call = void (*)(const void *func, usz i);
+
+		//Created on first use with a thread per hardware thread (except the calling one)
+		static ThreadPool &get();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		ThreadPool &operator=(const ThreadPool&) = delete;
+		ThreadPool &operator=(ThreadPool&&) = delete;
+
+		~ThreadPool();
+
+		//Run call(func, i) for every i in [0, count> on at most "threads" threads (the calling thread included)
+		//Returns when every index is done
+		//If a call throws, no new indices are handed out and the first exception is rethrown once the running calls are done
+		void run(usz count, u32 threads, Call call, const void *func);
+
+		inline u32 size() const { return u32(workers.size()) + 1; }
+
+	private:
+
+		struct Loop {
+			usz count;
+			std::atomic<usz> next;
+			Call call;
+			const void *func;
+			u32 helpers, maxHelpers;
+			std::exception_ptr error;
+		};
+
+		std::mutex mutex;
+		std::condition_variable wake, finished;
+
+		List<Loop*> loops;
+		List<std::thread> workers;
+		bool stop{};
+
+		ThreadPool();
+
+		//Find the newest loop that can use another thread (mutex has to be locked)
+		Loop *find();
+
+		//Run indices of the loop until there are none left (mutex can't be locked)
+		void execute(Loop &loop);
+
+		void work();
+	};
+
+	//Run func(i) for every i in [0, count> on the thread pool (the calling thread included)
+	//Indices are handed out one by one in increasing order,
+	//	so one big job doesn't stall a thread that has a whole range of small jobs queued behind it
+	//An exception thrown by func stops the loop and is rethrown to the caller once the other threads are done
+	template<typename Func>
+	inline void parallelFor(usz count, u32 threads, const Func &func) {
+
+		u32 workers = getThreadCount(threads, count);
+
+		if (workers <= 1) {
+
+			for (usz i = 0; i < count; ++i)
+				func(i);
+
+			return;
+		}
+
+		ThreadPool::get().run(
+			count, workers, 
+			[](const void *f, usz i) { (*(const Func*) f)(i); }, 
+			&func
+		);
+	}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "types/vec.hpp"
+
+namespace igxi {
+
+	//PNG encoder for 1-4 channels of 8 or 16 bits (16-bit channels are little endian in memory)
+	//The row stride can be negative, to start at the last row and flip the image
+	//
+	//"Level" is how much time is spent compressing:
+	//	0 stores the image without compression (fastest; for debug dumps)
+	//	1-3 use a fast deflate with the fixed Huffman codes; 1, 4 or 16 earlier matches are checked per position
+	//		1 uses Paeth for every row, the others estimate the best filter per row from every 4th pixel
+	//	4-8 estimate the best filter per row and use stb's deflate; higher searches longer for matches
+	//	9 tries every filter on every row
+	//
+	//Returns an empty buffer if the size or format isn't supported
+	Buffer encodePNG(const u8 *rows, i64 rowStride, u16 width, u16 height, u8 channels, u8 bytesPerChannel, u8 level);
+
+	//Map quality 0->1 to a PNG level (PNG is always lossless, so this is only the compression effort)
+	//Quality 1 is level 7; level 9 is slower for barely smaller files, so it's only used with maxEffort
+	inline u8 getPNGLevel(f32 quality, bool maxEffort = false) {
+		return maxEffort ? 9 : u8(std::lround(std::clamp(quality, 0.f, 1.f) * 7));
+	}
+
+	//Deflate with stb_image_write's compressor; implemented in convert.cpp (which has stb's implementation)
+	//"Quality" is the length of the hash chains it searches (it uses at least 5)
+	//Returns false if it fails
+	bool stbZlib(const u8 *data, usz size, int quality, Buffer &out);
+
+}
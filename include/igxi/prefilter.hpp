@@ -0,0 +1,26 @@
+#pragma once
+#include "igxi/convert.hpp"
+
+namespace igxi {
+
+	//Prefilter mip 1 until out.header.mips of every cube in the given format for GGX specular (split sum)
+	//Mip 0 is kept as is, mip i is the radiance convolved with a GGX lobe of roughness i / (mips - 1)
+	//	(perceptual roughness, so alpha = roughness^2) around the direction of the texel, with N = V = R
+	//
+	//The lobe is importance sampled (samples per texel) and every sample is read from a box filtered chain
+	//	at the mip that matches its solid angle, which keeps the noise low with a small number of samples
+	//Samples are bilinear within a face and clamped at its edges
+	//
+	//Returns INVALID_TYPE if out isn't a cube (array) and INVALID_FORMAT if the format isn't a float format
+	//
+	Helper::ErrorMessage prefilterCube(IGXI &out, u16 formatId, u32 threads = 0, u32 samples = 64);
+
+	//Get the irradiance of a cube as 9 RGB L2 spherical harmonics coefficients from mip 0
+	//They are already convolved with the cosine lobe; E(n) = sum(sh[i] * Y_i(n)), divide by pi for the diffuse radiance
+	//The basis is ordered Y00, Y1-1 (y), Y10 (z), Y11 (x), Y2-2 (xy), Y2-1 (yz), Y20 (3z^2 - 1), Y21 (xz), Y22 (x^2 - y^2)
+	//
+	//Returns INVALID_RESOURCE_INDEX if the cube doesn't exist, otherwise see prefilterCube
+	//
+	Helper::ErrorMessage getIrradianceSH(const IGXI &in, u16 formatId, u16 cube, f32 (&sh)[9][3], u32 threads = 0);
+
+}
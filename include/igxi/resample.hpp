@@ -0,0 +1,45 @@
+#pragma once
+#include "igxi/convert.hpp"
+
+namespace igxi {
+
+	//Filters for resampling (all separable)
+	//	MITCHELL is Mitchell-Netravali with B = C = 1/3 (radius 2); sharp without much ringing
+	//	LANCZOS is a 3 lobe Lanczos windowed sinc (radius 3); sharpest, but rings around hard edges
+	//	KAISER is a Kaiser windowed sinc (radius 3, alpha 4); between the two
+	enum class ResampleFilter : u8 {
+		MITCHELL,
+		LANCZOS,
+		KAISER,
+		NONE
+	};
+
+	//Get the filter selected by the MIP_MITCHELL, MIP_LANCZOS and MIP_KAISER flags (NONE if none are set)
+	//Returns INVALID_MIP_FILTER if multiple are set
+	Helper::ErrorMessage getResampleFilter(Helper::Flags flags, ResampleFilter &filter);
+
+	//Get the biggest dimension of MAX_SIZE_* (0 if unlimited)
+	inline u32 getMaxSize(Helper::Flags flags) {
+		u32 n = u32((flags & Helper::PROPERTY_MAX_SIZE) >> 41);
+		return n ? 1u << std::min(n + 4, 15u) : 0;
+	}
+
+	//Whether or not resample supports the format (up to 16-bit integers and 16/32-bit floats, sRGB in linear space)
+	bool canResample(ignis::GPUFormat format);
+
+	//Resample a 2D image to another size
+	//Every output row and column has a precomputed table of weights (the phase of the filter at that pixel),
+	//	when downsampling the filter is widened to cover all source pixels (so it doesn't alias)
+	//
+	//The horizontal pass filters the source rows a band of output rows needs, the vertical pass combines them;
+	//	bands are spread over the threads, so only a couple of rows per thread are kept in f32
+	//Edges are clamped
+	//
+	//Returns INVALID_FORMAT if the format isn't supported and INVALID_IMAGE_SIZE if a size is 0
+	//
+	Helper::ErrorMessage resample(
+		const u8 *src, u16 srcWidth, u16 srcHeight, u8 *dst, u16 dstWidth, u16 dstHeight,
+		ignis::GPUFormat format, ResampleFilter filter, u32 threads = 0
+	);
+
+}
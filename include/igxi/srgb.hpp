@@ -0,0 +1,70 @@
+#pragma once
+#include "types/vec.hpp"
+
+namespace igxi {
+
+	//sRGB <-> linear for 8-bit channels
+
+	struct SrgbTables {
+
+		static constexpr usz buckets = 4096;
+
+		f32 toLinear[256];
+		f32 threshold[256];			//threshold[k] is the lowest linear value that is encoded as k
+		u8 start[buckets + 1];		//start[i] is the encoded value of i / buckets; a linear value is close to the one of its bucket
+
+		SrgbTables() {
+
+			auto decode = [](f64 v) -> f64 {
+				return v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4);
+			};
+
+			threshold[0] = -f32_MAX;
+
+			for (usz i = 0; i < 256; ++i) {
+
+				toLinear[i] = f32(decode(i / 255.0));
+
+				if (i)
+					threshold[i] = f32(decode((i - 0.5) / 255.0));
+			}
+
+			for (usz i = 0; i <= buckets; ++i)
+				start[i] = search(f32(f64(i) / buckets));
+		}
+
+		//Binary search of the thresholds
+		inline u8 search(f32 linear) const {
+
+			u8 k{};
+
+			for (u8 step = 128; step; step >>= 1)
+				if (linear >= threshold[k + step])
+					k = u8(k + step);
+
+			return k;
+		}
+
+		//Same as rounding the encoded value, since encoding is monotonic
+		//Starts at the value of the bucket and walks to the right one; a bucket is smaller than a step of the encoded value
+		//	(even in the steepest part), so that's at most a step. The binary search was mispredicted half of the time
+		inline u8 toSrgb(f32 linear) const {
+
+			u8 k = start[usz((linear > 0 ? std::min(linear, 1.f) : 0) * buckets)];
+
+			while (k < 255 && linear >= threshold[k + 1])
+				++k;
+
+			while (k && linear < threshold[k])
+				--k;
+
+			return k;
+		}
+	};
+
+	inline const SrgbTables &getSrgbTables() {
+		static const SrgbTables tables;
+		return tables;
+	}
+
+}
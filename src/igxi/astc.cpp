@@ -0,0 +1,426 @@
+#include "igxi/astc.hpp"
+#include "igxi/endpoints.hpp"
+
+namespace igxi {
+
+	//Weight grid of a block; every weight is stored with the same number of bits (no trits or quints)
+	//Endpoints are always stored as 8-bit values, so the grid has to leave room for them
+
+	struct ASTCGrid {
+		u8 width, height, bits;
+	};
+
+	static constexpr usz astcHeaderBits = 17;		//Block mode (11), partition count (2) and endpoint mode (4)
+
+	//Encode the block mode of a single plane grid; returns 0 (reserved) if it can't be represented
+
+	constexpr u16 getBlockMode(const ASTCGrid &grid) {
+
+		//Weight range of 2, 4, 8, 16 or 32 levels
+
+		constexpr u16 quantMethod[] = { 0, 0, 2, 5, 8, 11 };
+
+		if (grid.bits < 1 || grid.bits > 5)
+			return 0;
+
+		u16 q = quantMethod[grid.bits];
+		u16 h = q >= 6, r = u16(h ? q - 4 : q + 2);
+		u16 x = grid.width, y = grid.height;
+		u16 mode = u16(((r & 1) << 4) | (r >> 1) | (h << 9));
+
+		if (x >= 4 && x <= 7 && y >= 2 && y <= 5)
+			return u16(mode | ((x - 4) << 7) | ((y - 2) << 5));
+
+		if (x >= 8 && x <= 11 && y >= 2 && y <= 5)
+			return u16(mode | (1 << 2) | ((x - 8) << 7) | ((y - 2) << 5));
+
+		if (x >= 2 && x <= 5 && y >= 8 && y <= 11)
+			return u16(mode | (2 << 2) | ((y - 8) << 7) | ((x - 2) << 5));
+
+		if (x >= 2 && x <= 5 && y >= 6 && y <= 7)
+			return u16(mode | (3 << 2) | ((y - 6) << 7) | ((x - 2) << 5));
+
+		if (x >= 2 && x <= 3 && y >= 2 && y <= 5)
+			return u16(mode | (3 << 2) | (1 << 8) | ((x - 2) << 7) | ((y - 2) << 5));
+
+		//6-9 x 6-9 moves the range bits and doesn't have a precision bit
+
+		if (x >= 6 && x <= 9 && y >= 6 && y <= 9 && !h)
+			return u16(((r & 1) << 4) | ((r >> 1) << 2) | (2 << 7) | ((x - 6) << 5) | ((y - 6) << 9));
+
+		return 0;
+	}
+
+	constexpr bool isValidGrid(const ASTCGrid &grid, u8 blockWidth, u8 blockHeight, usz endpointBits) {
+
+		usz weights = usz(grid.width) * grid.height, bits = weights * grid.bits;
+
+		return getBlockMode(grid) && grid.width <= blockWidth && grid.height <= blockHeight &&
+			weights <= 64 && bits >= 24 && bits <= 96 && astcHeaderBits + bits + endpointBits <= 128;
+	}
+
+	//Grids that are tried per block size; the first one is used by the fast preset
+
+	struct ASTCGrids {
+		u8 blockWidth, blockHeight;
+		ASTCGrid rgb[6], rgba[6];
+	};
+
+	static constexpr ASTCGrids astcGrids[] = {
+
+		{
+			4, 4,
+			{ { 4, 4, 3 }, { 4, 3, 4 }, { 3, 4, 4 }, { 3, 3, 5 }, { 4, 2, 5 }, { 2, 4, 5 } },
+			{ { 4, 4, 2 }, { 4, 3, 3 }, { 3, 4, 3 }, { 3, 3, 5 }, { 4, 2, 5 }, { 2, 4, 5 } }
+		},
+
+		{
+			6, 6,
+			{ { 4, 4, 3 }, { 5, 5, 2 }, { 5, 4, 3 }, { 4, 5, 3 }, { 6, 4, 2 }, { 4, 6, 2 } },
+			{ { 4, 4, 2 }, { 5, 4, 2 }, { 4, 5, 2 }, { 6, 6, 1 }, { 3, 3, 5 }, { 4, 3, 3 } }
+		},
+
+		{
+			8, 8,
+			{ { 4, 4, 3 }, { 5, 5, 2 }, { 5, 4, 3 }, { 4, 5, 3 }, { 7, 4, 2 }, { 4, 7, 2 } },
+			{ { 4, 4, 2 }, { 5, 4, 2 }, { 4, 5, 2 }, { 6, 6, 1 }, { 8, 5, 1 }, { 5, 8, 1 } }
+		}
+	};
+
+	constexpr bool areValidGrids() {
+
+		for (const ASTCGrids &grids : astcGrids)
+			for (usz i = 0; i < _countof(grids.rgb); ++i)
+				if (
+					!isValidGrid(grids.rgb[i], grids.blockWidth, grids.blockHeight, 6 * 8) ||
+					!isValidGrid(grids.rgba[i], grids.blockWidth, grids.blockHeight, 8 * 8)
+				)
+					return false;
+
+		return true;
+	}
+
+	static_assert(areValidGrids(), "Every ASTC grid has to be encodable and fit in a block with 8-bit endpoints");
+
+	inline const ASTCGrids *findGrids(u8 blockWidth, u8 blockHeight) {
+
+		for (const ASTCGrids &grids : astcGrids)
+			if (grids.blockWidth == blockWidth && grids.blockHeight == blockHeight)
+				return &grids;
+
+		return nullptr;
+	}
+
+	bool supportsASTC(u8 blockWidth, u8 blockHeight) {
+		return findGrids(blockWidth, blockHeight);
+	}
+
+	//Expand a weight to 0-64 (bit replication to 6 bits, skipping 32 -> 33)
+
+	inline u8 unquantizeWeight(u8 q, u8 bits) {
+
+		i32 v{};
+
+		for (i32 shift = 6 - bits; shift > -i32(bits); shift -= bits)
+			v |= shift >= 0 ? q << shift : q >> -shift;
+
+		return u8(v > 32 ? v + 1 : v);
+	}
+
+	//How a texel's weight is interpolated from the weight grid (4 grid points; the weights sum to 16)
+
+	struct Infill {
+		u8 idx[4], w[4];
+	};
+
+	inline void getInfill(const ASTCGrid &grid, u8 blockWidth, u8 blockHeight, Infill *infill) {
+
+		i32 ds = (1024 + blockWidth / 2) / (blockWidth - 1);
+		i32 dt = (1024 + blockHeight / 2) / (blockHeight - 1);
+
+		for (i32 t = 0; t < blockHeight; ++t)
+			for (i32 s = 0; s < blockWidth; ++s) {
+
+				i32 gs = (ds * s * (grid.width - 1) + 32) >> 6;
+				i32 gt = (dt * t * (grid.height - 1) + 32) >> 6;
+
+				i32 fs = gs & 15, ft = gt & 15;
+				i32 w11 = (fs * ft + 8) >> 4;
+				i32 v0 = (gt >> 4) * grid.width + (gs >> 4);
+
+				i32 idx[4] = { v0, v0 + 1, v0 + grid.width, v0 + grid.width + 1 };
+				i32 w[4] = { 16 - fs - ft + w11, fs - w11, ft - w11, w11 };
+
+				Infill &texel = infill[t * blockWidth + s];
+
+				//Unused neighbors can be outside of the grid
+
+				for (usz i = 0; i < 4; ++i) {
+					texel.idx[i] = u8(w[i] ? idx[i] : v0);
+					texel.w[i] = u8(w[i]);
+				}
+			}
+	}
+
+	//Interpolate a channel the way an LDR decoder does
+
+	inline i32 interpolate(i32 e0, i32 e1, i32 w) {
+		return ((e0 * 257 * (64 - w) + e1 * 257 * w + 32) >> 6) >> 8;
+	}
+
+	struct ASTCResult {
+		u8 e0[4], e1[4];
+		u8 weights[64];
+		u32 error;
+	};
+
+	//Encode the block with one grid (C = 3 for RGB, 4 for RGBA) and keep the result if it beats "best"
+
+	template<usz C>
+	inline void encodeGrid(
+		const u8 (*px)[4], u8 blockWidth, u8 blockHeight, const ASTCGrid &grid, u8 iterations, ASTCResult &best
+	) {
+
+		usz count = usz(blockWidth) * blockHeight, weights = usz(grid.width) * grid.height;
+
+		Infill infill[64];
+		getInfill(grid, blockWidth, blockHeight, infill);
+
+		//How much each grid point contributes to the texels
+
+		f32 coverage[64]{};
+
+		for (usz i = 0; i < count; ++i)
+			for (usz j = 0; j < 4; ++j)
+				coverage[infill[i].idx[j]] += infill[i].w[j];
+
+		u8 levelCount = u8(1 << grid.bits), levels[32];
+
+		for (u8 i = 0; i < levelCount; ++i)
+			levels[i] = unquantizeWeight(i, grid.bits);
+
+		f32 e0[C], e1[C];
+		fitEndpoints<C>(px, count, e0, e1);
+
+		for (u8 it = 0; ; ++it) {
+
+			ASTCResult result;
+
+			for (usz c = 0; c < 4; ++c) {
+				result.e0[c] = c < C ? u8(std::lround(e0[c])) : 255;
+				result.e1[c] = c < C ? u8(std::lround(e1[c])) : 255;
+			}
+
+			//The decoder swaps the endpoints (and contracts blue) if e1 is darker than e0
+
+			if (
+				result.e1[0] + result.e1[1] + result.e1[2] <
+				result.e0[0] + result.e0[1] + result.e0[2]
+			) {
+
+				for (usz c = 0; c < 4; ++c)
+					std::swap(result.e0[c], result.e1[c]);
+
+				for (usz c = 0; c < C; ++c)
+					std::swap(e0[c], e1[c]);
+			}
+
+			//Project every texel onto the endpoints to find the ideal weight
+
+			f32 axis[C], length{}, ideal[64];
+
+			for (usz c = 0; c < C; ++c) {
+				axis[c] = f32(result.e1[c]) - result.e0[c];
+				length += axis[c] * axis[c];
+			}
+
+			for (usz i = 0; i < count; ++i) {
+
+				f32 t{};
+
+				for (usz c = 0; c < C; ++c)
+					t += (f32(px[i][c]) - result.e0[c]) * axis[c];
+
+				ideal[i] = length ? std::clamp(t / length, 0.f, 1.f) * 64 : 0;
+			}
+
+			//Spread the ideal weights over the grid and correct what the interpolation gets wrong
+
+			f32 fit[64];
+
+			if (weights == count)
+				std::memcpy(fit, ideal, sizeof(f32) * count);
+
+			else {
+
+				std::fill(fit, fit + weights, 0.f);
+
+				for (usz i = 0; i < count; ++i)
+					for (usz j = 0; j < 4; ++j)
+						fit[infill[i].idx[j]] += infill[i].w[j] * ideal[i];
+
+				for (usz j = 0; j < weights; ++j)
+					fit[j] = coverage[j] ? fit[j] / coverage[j] : 32;
+
+				for (usz pass = 0; pass < 2; ++pass) {
+
+					f32 delta[64]{};
+
+					for (usz i = 0; i < count; ++i) {
+
+						f32 v{};
+
+						for (usz j = 0; j < 4; ++j)
+							v += infill[i].w[j] * fit[infill[i].idx[j]];
+
+						f32 d = ideal[i] - v / 16;
+
+						for (usz j = 0; j < 4; ++j)
+							delta[infill[i].idx[j]] += infill[i].w[j] * d;
+					}
+
+					for (usz j = 0; j < weights; ++j)
+						if (coverage[j])
+							fit[j] += delta[j] / coverage[j];
+				}
+			}
+
+			//Pick the closest level of every weight
+
+			for (usz j = 0; j < weights; ++j) {
+
+				i32 q = std::clamp(i32(std::lround(fit[j] / 64 * (levelCount - 1))), 0, levelCount - 1);
+				i32 bestQ = q;
+
+				for (i32 k = std::max(q - 1, 0); k <= std::min(q + 1, levelCount - 1); ++k)
+					if (std::abs(levels[k] - fit[j]) < std::abs(levels[bestQ] - fit[j]))
+						bestQ = k;
+
+				result.weights[j] = u8(bestQ);
+			}
+
+			//Decode the block to get the error
+
+			u8 texels[64];
+			result.error = 0;
+
+			for (usz i = 0; i < count; ++i) {
+
+				i32 v{};
+
+				for (usz j = 0; j < 4; ++j)
+					v += infill[i].w[j] * levels[result.weights[infill[i].idx[j]]];
+
+				texels[i] = u8((v + 8) >> 4);
+
+				for (usz c = 0; c < C; ++c) {
+					i32 d = interpolate(result.e0[c], result.e1[c], texels[i]) - px[i][c];
+					result.error += u32(d * d);
+				}
+			}
+
+			if (result.error < best.error)
+				best = result;
+
+			if (it >= iterations || !result.error)
+				break;
+
+			f32 w[64];
+
+			for (usz i = 0; i < count; ++i)
+				w[i] = texels[i] / 64.f;
+
+			if (!leastSquares<C>(px, count, 0, w, e0, e1))
+				break;
+		}
+	}
+
+	inline u8 reverseBits(u8 v) {
+
+		u8 r{};
+
+		for (usz i = 0; i < 8; ++i)
+			r |= u8(((v >> i) & 1) << (7 - i));
+
+		return r;
+	}
+
+	void encodeASTC(const u8 (*px)[4], u8 blockWidth, u8 blockHeight, u8 *out, u8 iterations) {
+
+		std::memset(out, 0, 16);
+
+		usz count = usz(blockWidth) * blockHeight;
+		bool solid = true, alpha{};
+
+		for (usz i = 0; i < count; ++i) {
+			solid &= std::memcmp(px[i], px[0], 4) == 0;
+			alpha |= px[i][3] != 255;
+		}
+
+		//A single color is stored as a void extent block (LDR, without extents) with 16-bit colors
+
+		if (solid) {
+
+			u64 header = 0xFFFFFFFFFFFFFDFC;
+			std::memcpy(out, &header, 8);
+
+			for (usz c = 0; c < 4; ++c) {
+				u16 v = u16(px[0][c] * 257);
+				out[8 + c * 2] = u8(v);
+				out[9 + c * 2] = u8(v >> 8);
+			}
+
+			return;
+		}
+
+		const ASTCGrids *grids = findGrids(blockWidth, blockHeight);
+
+		if (!grids)
+			return;
+
+		const ASTCGrid *candidates = alpha ? grids->rgba : grids->rgb;
+		usz candidateCount = iterations ? _countof(grids->rgb) : 1;
+
+		ASTCResult best{};
+		best.error = u32_MAX;
+
+		ASTCGrid bestGrid = candidates[0];
+
+		for (usz i = 0; i < candidateCount && best.error; ++i) {
+
+			u32 prev = best.error;
+
+			if (alpha)
+				encodeGrid<4>(px, blockWidth, blockHeight, candidates[i], iterations, best);
+
+			else encodeGrid<3>(px, blockWidth, blockHeight, candidates[i], iterations, best);
+
+			if (best.error < prev)
+				bestGrid = candidates[i];
+		}
+
+		//Block mode, 1 partition and LDR RGB(A) direct endpoints
+
+		BitWriter writer{ out };
+		writer.write(getBlockMode(bestGrid), 11);
+		writer.write(0, 2);
+		writer.write(alpha ? 12 : 8, 4);
+
+		for (usz c = 0; c < (alpha ? 4 : 3); ++c) {
+			writer.write(best.e0[c], 8);
+			writer.write(best.e1[c], 8);
+		}
+
+		//Weights are stored in reverse, starting from the end of the block
+
+		u8 weights[16]{};
+		BitWriter weightWriter{ weights };
+
+		for (usz j = 0; j < usz(bestGrid.width) * bestGrid.height; ++j)
+			weightWriter.write(best.weights[j], bestGrid.bits);
+
+		for (usz i = 0; i < 16; ++i)
+			out[15 - i] |= reverseBits(weights[i]);
+	}
+
+}
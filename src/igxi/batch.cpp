@@ -0,0 +1,72 @@
+#include "igxi/convert.hpp"
+#include "igxi/parallel.hpp"
+#include <filesystem>
+#include <algorithm>
+
+namespace igxi {
+
+	//Estimate how much work a job is by the size of its inputs
+	//Files without a path are read from the job's IGXI
+
+	inline u64 getJobSize(const Helper::Job &job) {
+
+		u64 size{};
+
+		for (const Helper::FileDesc &file : job.files) {
+
+			if (file.path.empty()) {
+
+				for (const List<Buffer> &format : job.out.data)
+					if (file.iid.layer < format.size())
+						size += format[file.iid.layer].size();
+
+				continue;
+			}
+
+			std::error_code error;
+			u64 fileSize = std::filesystem::file_size(file.path, error);
+
+			if (!error)
+				size += fileSize;
+		}
+
+		//Every job costs something, even if it will fail
+
+		return std::max(size, u64(1));
+	}
+
+	List<Helper::ErrorMessage> Helper::convertBatch(List<Job> &jobs, u32 threads, DecodeCache *cache) {
+
+		usz count = jobs.size();
+		List<ErrorMessage> errors(count);
+
+		if (!count)
+			return errors;
+
+		u32 workers = getThreadCount(threads, usz(u32_MAX));
+
+		//Biggest jobs first, so a big one doesn't start when everything else is already done
+
+		List<u64> sizes(count);
+		List<usz> order(count);
+
+		parallelFor(count, workers, [&](usz i) {
+			sizes[i] = getJobSize(jobs[i]);
+			order[i] = i;
+		});
+
+		std::stable_sort(order.begin(), order.end(), [&](usz a, usz b) { return sizes[a] > sizes[b]; });
+
+		//Every job may use all threads; its layers and tiles are loops on the same thread pool,
+		//	so threads that are out of jobs help the jobs that are still running instead of idling
+
+		parallelFor(count, workers, [&](usz i) {
+			usz j = order[i];
+			Job &job = jobs[j];
+			errors[j] = convert(job.out, job.files, job.flags, job.quality, workers, cache);
+		});
+
+		return errors;
+	}
+
+}
@@ -0,0 +1,371 @@
+#include "igxi/bc.hpp"
+#include "igxi/endpoints.hpp"
+
+namespace igxi {
+
+	//BC1
+
+	inline u16 to565(const f32 *c) {
+
+		u16 r = u16(std::clamp(std::lround(c[0] * 31 / 255), 0l, 31l));
+		u16 g = u16(std::clamp(std::lround(c[1] * 63 / 255), 0l, 63l));
+		u16 b = u16(std::clamp(std::lround(c[2] * 31 / 255), 0l, 31l));
+
+		return u16((r << 11) | (g << 5) | b);
+	}
+
+	inline void from565(u16 v, i32 *c) {
+
+		i32 r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+
+		c[0] = (r << 3) | (r >> 2);
+		c[1] = (g << 2) | (g >> 4);
+		c[2] = (b << 3) | (b >> 2);
+	}
+
+	//Assign the closest of the 4 colors to every pixel and return the error
+
+	inline u32 assignBC1(const Block &block, u16 c0, u16 c1, u8 *idx) {
+
+		i32 pal[4][3];
+		from565(c0, pal[0]);
+		from565(c1, pal[1]);
+
+		for (usz c = 0; c < 3; ++c) {
+			pal[2][c] = (2 * pal[0][c] + pal[1][c]) / 3;
+			pal[3][c] = (pal[0][c] + 2 * pal[1][c]) / 3;
+		}
+
+		u32 total{};
+
+		for (usz i = 0; i < 16; ++i) {
+
+			u32 best = u32_MAX;
+
+			for (u8 j = 0; j < 4; ++j) {
+
+				u32 err{};
+
+				for (usz c = 0; c < 3; ++c) {
+					i32 d = pal[j][c] - block.px[i][c];
+					err += u32(d * d);
+				}
+
+				if (err < best) {
+					best = err;
+					idx[i] = j;
+				}
+			}
+
+			total += best;
+		}
+
+		return total;
+	}
+
+	void encodeBC1(const Block &block, u8 *out, u8 iterations) {
+
+		static constexpr f32 weights[4] = { 0, 1, 1 / 3.f, 2 / 3.f };
+
+		f32 e0[3], e1[3];
+		fitEndpoints<3>(block.px, 16, e1, e0);
+
+		u16 best0{}, best1{};
+		u8 best[16]{}, idx[16];
+		u32 bestErr = u32_MAX;
+
+		for (u8 it = 0; ; ++it) {
+
+			u16 c0 = to565(e0), c1 = to565(e1);
+
+			//The 4 color mode needs c0 > c1
+
+			if (c0 < c1)
+				std::swap(c0, c1);
+
+			u32 err = assignBC1(block, c0, c1, idx);
+
+			if (err < bestErr) {
+				bestErr = err;
+				best0 = c0;
+				best1 = c1;
+				std::memcpy(best, idx, sizeof(idx));
+			}
+
+			if (it >= iterations || !err)
+				break;
+
+			f32 w[16];
+
+			for (usz i = 0; i < 16; ++i)
+				w[i] = weights[idx[i]];
+
+			if (!leastSquares<3>(block.px, 16, 0, w, e0, e1))
+				break;
+		}
+
+		//c0 == c1 would be the 3 color mode, where index 3 is transparent
+
+		if (best0 == best1)
+			std::memset(best, 0, sizeof(best));
+
+		u32 indices{};
+
+		for (usz i = 0; i < 16; ++i)
+			indices |= u32(best[i]) << (i * 2);
+
+		out[0] = u8(best0);
+		out[1] = u8(best0 >> 8);
+		out[2] = u8(best1);
+		out[3] = u8(best1 >> 8);
+		std::memcpy(out + 4, &indices, 4);
+	}
+
+	//BC4
+
+	inline u32 assignBC4(const Block &block, usz channel, u8 a0, u8 a1, u8 *idx) {
+
+		i32 pal[8] = { a0, a1 };
+
+		for (i32 i = 2; i < 8; ++i)
+			pal[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+
+		u32 total{};
+
+		for (usz i = 0; i < 16; ++i) {
+
+			u32 best = u32_MAX;
+
+			for (u8 j = 0; j < 8; ++j) {
+
+				i32 d = pal[j] - block.px[i][channel];
+
+				if (u32(d * d) < best) {
+					best = u32(d * d);
+					idx[i] = j;
+				}
+			}
+
+			total += best;
+		}
+
+		return total;
+	}
+
+	inline void encodeBC4Channel(const Block &block, usz channel, u8 *out, u8 iterations) {
+
+		static constexpr f32 weights[8] = { 0, 1, 1 / 7.f, 2 / 7.f, 3 / 7.f, 4 / 7.f, 5 / 7.f, 6 / 7.f };
+
+		u8 mn = 255, mx = 0;
+
+		for (usz i = 0; i < 16; ++i) {
+			mn = std::min(mn, block.px[i][channel]);
+			mx = std::max(mx, block.px[i][channel]);
+		}
+
+		u8 best0 = mx, best1 = mn, best[16]{}, idx[16];
+
+		//Uniform block; a0 == a1 is the 6 value mode, but index 0 is still a0
+
+		if (mn != mx) {
+
+			f32 e0 = mx, e1 = mn;
+			u32 bestErr = u32_MAX;
+
+			for (u8 it = 0; ; ++it) {
+
+				u8 a0 = u8(std::lround(e0)), a1 = u8(std::lround(e1));
+
+				//The 8 value mode needs a0 > a1
+
+				if (a0 < a1)
+					std::swap(a0, a1);
+
+				if (a0 == a1)
+					break;
+
+				u32 err = assignBC4(block, channel, a0, a1, idx);
+
+				if (err < bestErr) {
+					bestErr = err;
+					best0 = a0;
+					best1 = a1;
+					std::memcpy(best, idx, sizeof(idx));
+				}
+
+				if (it >= iterations || !err)
+					break;
+
+				f32 w[16];
+
+				for (usz i = 0; i < 16; ++i)
+					w[i] = weights[idx[i]];
+
+				if (!leastSquares<1>(block.px, 16, channel, w, &e0, &e1))
+					break;
+			}
+		}
+
+		u64 indices{};
+
+		for (usz i = 0; i < 16; ++i)
+			indices |= u64(best[i]) << (i * 3);
+
+		out[0] = best0;
+		out[1] = best1;
+
+		for (usz i = 0; i < 6; ++i)
+			out[2 + i] = u8(indices >> (i * 8));
+	}
+
+	void encodeBC4(const Block &block, u8 *out, u8 iterations) {
+		encodeBC4Channel(block, 0, out, iterations);
+	}
+
+	void encodeBC5(const Block &block, u8 *out, u8 iterations) {
+		encodeBC4Channel(block, 0, out, iterations);
+		encodeBC4Channel(block, 1, out + 8, iterations);
+	}
+
+	void encodeBC3(const Block &block, u8 *out, u8 iterations) {
+		encodeBC4Channel(block, 3, out, iterations);
+		encodeBC1(block, out + 8, iterations);
+	}
+
+	//BC7 (mode 6)
+
+	static constexpr u8 bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	//Quantize an endpoint to 7 bits per channel and pick the shared p-bit with the least error
+
+	inline void quantizeBC7(const f32 *e, u8 *q, u8 &p) {
+
+		f32 bestErr = f32_MAX;
+
+		for (u8 pb = 0; pb < 2; ++pb) {
+
+			u8 qq[4];
+			f32 err{};
+
+			for (usz c = 0; c < 4; ++c) {
+				qq[c] = u8(std::clamp(std::lround((e[c] - pb) / 2), 0l, 127l));
+				f32 d = f32(qq[c] * 2 + pb) - e[c];
+				err += d * d;
+			}
+
+			if (err < bestErr) {
+				bestErr = err;
+				p = pb;
+				std::memcpy(q, qq, sizeof(qq));
+			}
+		}
+	}
+
+	inline u32 assignBC7(const Block &block, const u8 *q0, u8 p0, const u8 *q1, u8 p1, u8 *idx) {
+
+		i32 pal[16][4];
+
+		for (usz c = 0; c < 4; ++c) {
+
+			i32 e0 = (q0[c] << 1) | p0, e1 = (q1[c] << 1) | p1;
+
+			for (usz i = 0; i < 16; ++i)
+				pal[i][c] = ((64 - bc7Weights4[i]) * e0 + bc7Weights4[i] * e1 + 32) >> 6;
+		}
+
+		u32 total{};
+
+		for (usz i = 0; i < 16; ++i) {
+
+			u32 best = u32_MAX;
+
+			for (u8 j = 0; j < 16; ++j) {
+
+				u32 err{};
+
+				for (usz c = 0; c < 4; ++c) {
+					i32 d = pal[j][c] - block.px[i][c];
+					err += u32(d * d);
+				}
+
+				if (err < best) {
+					best = err;
+					idx[i] = j;
+				}
+			}
+
+			total += best;
+		}
+
+		return total;
+	}
+
+	void encodeBC7(const Block &block, u8 *out, u8 iterations) {
+
+		f32 e0[4], e1[4];
+		fitEndpoints<4>(block.px, 16, e0, e1);
+
+		u8 best0[4]{}, best1[4]{}, bestP0{}, bestP1{}, best[16]{}, idx[16];
+		u32 bestErr = u32_MAX;
+
+		for (u8 it = 0; ; ++it) {
+
+			u8 q0[4], q1[4], p0{}, p1{};
+			quantizeBC7(e0, q0, p0);
+			quantizeBC7(e1, q1, p1);
+
+			u32 err = assignBC7(block, q0, p0, q1, p1, idx);
+
+			if (err < bestErr) {
+				bestErr = err;
+				std::memcpy(best0, q0, 4);
+				std::memcpy(best1, q1, 4);
+				bestP0 = p0;
+				bestP1 = p1;
+				std::memcpy(best, idx, sizeof(idx));
+			}
+
+			if (it >= iterations || !err)
+				break;
+
+			f32 w[16];
+
+			for (usz i = 0; i < 16; ++i)
+				w[i] = bc7Weights4[idx[i]] / 64.f;
+
+			if (!leastSquares<4>(block.px, 16, 0, w, e0, e1))
+				break;
+		}
+
+		//The MSB of the first index is implied to be 0; flip the endpoints if it isn't
+
+		if (best[0] & 8) {
+
+			for (usz c = 0; c < 4; ++c)
+				std::swap(best0[c], best1[c]);
+
+			std::swap(bestP0, bestP1);
+
+			for (usz i = 0; i < 16; ++i)
+				best[i] = u8(15 - best[i]);
+		}
+
+		std::memset(out, 0, 16);
+
+		BitWriter writer{ out };
+		writer.write(1 << 6, 7);
+
+		for (usz c = 0; c < 4; ++c) {
+			writer.write(best0[c], 7);
+			writer.write(best1[c], 7);
+		}
+
+		writer.write(bestP0, 1);
+		writer.write(bestP1, 1);
+		writer.write(best[0], 3);
+
+		for (usz i = 1; i < 16; ++i)
+			writer.write(best[i], 4);
+	}
+
+}
\ No newline at end of file
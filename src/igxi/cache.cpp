@@ -0,0 +1,302 @@
+#include "igxi/cache.hpp"
+#include <filesystem>
+#include <fstream>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <Windows.h>
+#else
+	#include <unistd.h>
+#endif
+
+using namespace ignis;
+
+namespace fs = std::filesystem;
+
+namespace igxi {
+
+	static constexpr u64 cacheMagic = 0x3143495847495843;		//"CXIGXIC1"
+	static constexpr const char *cacheExtension = ".igxic";
+
+	//A name for a temporary file that no other thread or process uses at the same time
+	//Thread ids can be the same in different processes (and hashes of them can collide), so it's the process id and a counter
+
+	static String getTempSuffix() {
+
+		static std::atomic<u64> counter{};
+
+		#ifdef _WIN32
+			u64 pid = GetCurrentProcessId();
+		#else
+			u64 pid = u64(getpid());
+		#endif
+
+		return "." + std::to_string(pid) + "_" + std::to_string(counter.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+	}
+
+	//xxHash64; a fast hash of the source file
+
+	static constexpr u64 prime0 = 0x9E3779B185EBCA87, prime1 = 0xC2B2AE3D27D4EB4F;
+	static constexpr u64 prime2 = 0x165667B19E3779F9, prime3 = 0x85EBCA77C2B2AE63, prime4 = 0x27D4EB2F165667C5;
+
+	inline u64 rotl(u64 v, u32 r) { return (v << r) | (v >> (64 - r)); }
+
+	inline u64 read64(const u8 *p) { u64 v; std::memcpy(&v, p, 8); return v; }
+	inline u32 read32(const u8 *p) { u32 v; std::memcpy(&v, p, 4); return v; }
+
+	inline u64 round(u64 acc, u64 v) { return rotl(acc + v * prime1, 31) * prime0; }
+	inline u64 merge(u64 acc, u64 v) { return (acc ^ round(0, v)) * prime0 + prime3; }
+
+	inline u64 hash(const u8 *p, usz size, u64 seed) {
+
+		const u8 *end = p + size;
+		u64 h;
+
+		if (size >= 32) {
+
+			u64 v[4] = { seed + prime0 + prime1, seed + prime1, seed, seed - prime0 };
+
+			for (; p + 32 <= end; p += 32)
+				for (usz i = 0; i < 4; ++i)
+					v[i] = round(v[i], read64(p + i * 8));
+
+			h = rotl(v[0], 1) + rotl(v[1], 7) + rotl(v[2], 12) + rotl(v[3], 18);
+
+			for (usz i = 0; i < 4; ++i)
+				h = merge(h, v[i]);
+
+		} else h = seed + prime4;
+
+		h += size;
+
+		for (; p + 8 <= end; p += 8)
+			h = rotl(h ^ round(0, read64(p)), 27) * prime0 + prime3;
+
+		if (p + 4 <= end) {
+			h = rotl(h ^ (read32(p) * prime0), 23) * prime1 + prime2;
+			p += 4;
+		}
+
+		for (; p < end; ++p)
+			h = rotl(h ^ (*p * prime4), 11) * prime0;
+
+		h ^= h >> 33;
+		h *= prime1;
+		h ^= h >> 29;
+		h *= prime2;
+		return h ^ (h >> 32);
+	}
+
+	u64 DecodeCache::getKey(const u8 *file, usz size, Helper::Flags flags) {
+
+		u64 decodeFlags = u64(flags) & (
+			Helper::IS_1D | Helper::IS_SRGB | 
+			Helper::PROPERTY_CHANNELS | Helper::PROPERTY_PRIMTIIVE | Helper::PROPERTY_BITS
+		);
+
+		return hash(file, size, decodeFlags);
+	}
+
+	//Index
+
+	DecodeCache::DecodeCache(const String &dir, u64 max): directory(dir), maxSize(max) {
+
+		std::error_code error;
+		fs::create_directories(directory, error);
+
+		//Order the images by write time, so the oldest are evicted first
+
+		List<Pair<fs::file_time_type, Pair<u64, u64>>> found;
+
+		for (const fs::directory_entry &entry : fs::directory_iterator(directory, error)) {
+
+			if (!entry.is_regular_file(error) || entry.path().extension() != cacheExtension)
+				continue;
+
+			String name = entry.path().stem().string();
+
+			if (name.size() != 16 || name.find_first_not_of("0123456789abcdef") != String::npos)
+				continue;
+
+			u64 fileSize = entry.file_size(error);
+
+			if (error)
+				continue;
+
+			found.push_back({ entry.last_write_time(error), { std::stoull(name, nullptr, 16), fileSize } });
+		}
+
+		std::sort(found.begin(), found.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		for (auto &elem : found)
+			insert(elem.second.first, elem.second.second);
+
+		evict();
+	}
+
+	String DecodeCache::getPath(u64 key) const {
+
+		char name[17];
+		std::snprintf(name, sizeof(name), "%016llx", (unsigned long long) key);
+
+		return (fs::path(directory) / (String(name) + cacheExtension)).string();
+	}
+
+	void DecodeCache::insert(u64 key, u64 fileSize) {
+
+		auto it = items.find(key);
+
+		if (it != items.end())
+			erase(it);
+
+		uses.push_back(key);
+		items[key] = { fileSize, std::prev(uses.end()) };
+		size += fileSize;
+	}
+
+	void DecodeCache::erase(HashMap<u64, Item>::iterator it) {
+		size -= it->second.size;
+		uses.erase(it->second.use);
+		items.erase(it);
+	}
+
+	//The front of the use list is always the least recently used image, so this is O(1) per image
+
+	void DecodeCache::evict() {
+
+		while (size > maxSize && !uses.empty()) {
+
+			auto oldest = items.find(uses.front());
+
+			std::error_code error;
+			fs::remove(getPath(oldest->first), error);
+
+			erase(oldest);
+		}
+	}
+
+	//Lookup
+
+	//Check if the file is a complete image of the key
+
+	inline bool readHeader(const MappedFile &file, u64 key, DecodeCache::Header &header) {
+
+		if (!file.data() || file.size() < sizeof(header))
+			return false;
+
+		std::memcpy(&header, file.data(), sizeof(header));
+
+		if (header.magic != cacheMagic || header.key != key || header.format >= GPUFormat::idByValue(GPUFormat::NONE))
+			return false;
+
+		GPUFormat format = GPUFormat(GPUFormat::valueById(header.format));
+
+		return file.size() - sizeof(header) == usz(header.width) * header.height * FormatHelper::getSizeBytes(format);
+	}
+
+	std::unique_ptr<MappedFile> DecodeCache::find(u64 key, Header &header) {
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			auto it = items.find(key);
+
+			if (it == items.end()) {
+				++misses;
+				return {};
+			}
+
+			uses.splice(uses.end(), uses, it->second.use);
+		}
+
+		String path = getPath(key);
+		auto file = std::make_unique<MappedFile>(path);
+
+		if (readHeader(*file, key, header)) {
+
+			++hits;
+
+			//Touch the file, so it's seen as recently used by the next run
+
+			std::error_code error;
+			fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+
+			return file;
+		}
+
+		//Broken or removed by someone else
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		auto it = items.find(key);
+
+		if (it != items.end())
+			erase(it);
+
+		++misses;
+		return {};
+	}
+
+	void DecodeCache::store(u64 key, u16 width, u16 height, GPUFormat format, const u8 *data, usz dataSize) {
+
+		u64 fileSize = sizeof(Header) + dataSize;
+
+		if (fileSize > maxSize)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (items.find(key) != items.end())
+				return;
+		}
+
+		Header header{ cacheMagic, key, width, height, u16(GPUFormat::idByValue(format.value)), 0 };
+
+		//Write to a temporary file first, so other threads (or processes) never see half of an image
+
+		String path = getPath(key);
+		String temp = path + getTempSuffix();
+
+		{
+			std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+
+			if (!out)
+				return;
+
+			out.write((const char*) &header, sizeof(header));
+			out.write((const char*) data, std::streamsize(dataSize));
+
+			if (!out) {
+				out.close();
+				std::error_code error;
+				fs::remove(temp, error);
+				return;
+			}
+		}
+
+		std::error_code error;
+		fs::rename(temp, path, error);
+
+		if (error) {
+			fs::remove(temp, error);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		insert(key, fileSize);
+		evict();
+	}
+
+}
@@ -0,0 +1,356 @@
+#include "igxi/compress.hpp"
+#include "igxi/bc.hpp"
+#include "igxi/astc.hpp"
+#include "igxi/parallel.hpp"
+
+using namespace ignis;
+
+namespace igxi {
+
+	//Formats
+
+	static constexpr CompressedFormatInfo compressedFormats[] = {
+		{ "bc1", 4, 4, 8 },
+		{ "bc1_srgb", 4, 4, 8 },
+		{ "bc3", 4, 4, 16 },
+		{ "bc3_srgb", 4, 4, 16 },
+		{ "bc4", 4, 4, 8 },
+		{ "bc5", 4, 4, 16 },
+		{ "bc7", 4, 4, 16 },
+		{ "bc7_srgb", 4, 4, 16 },
+		{ "astc4x4", 4, 4, 16 },
+		{ "astc4x4_srgb", 4, 4, 16 },
+		{ "astc6x6", 6, 6, 16 },
+		{ "astc6x6_srgb", 6, 6, 16 },
+		{ "astc8x8", 8, 8, 16 },
+		{ "astc8x8_srgb", 8, 8, 16 }
+	};
+
+	static_assert(
+		_countof(compressedFormats) == usz(CompressedFormat::COUNT),
+		"compressedFormats has to contain every CompressedFormat"
+	);
+
+	//Pixels of a block are rgba8 and row major (up to 8x8)
+
+	using BlockEncoder = void (*)(const u8 (*px)[4], u8 blockWidth, u8 blockHeight, u8 *out, u8 iterations);
+
+	template<void (*encode)(const Block&, u8*, u8)>
+	inline void encodeBC(const u8 (*px)[4], u8, u8, u8 *out, u8 iterations) {
+		Block block;
+		std::memcpy(block.px, px, sizeof(block.px));
+		encode(block, out, iterations);
+	}
+
+	static constexpr BlockEncoder blockEncoders[] = {
+		&encodeBC<&encodeBC1>,
+		&encodeBC<&encodeBC1>,
+		&encodeBC<&encodeBC3>,
+		&encodeBC<&encodeBC3>,
+		&encodeBC<&encodeBC4>,
+		&encodeBC<&encodeBC5>,
+		&encodeBC<&encodeBC7>,
+		&encodeBC<&encodeBC7>,
+		&encodeASTC,
+		&encodeASTC,
+		&encodeASTC,
+		&encodeASTC,
+		&encodeASTC,
+		&encodeASTC
+	};
+
+	static_assert(
+		_countof(blockEncoders) == usz(CompressedFormat::COUNT),
+		"blockEncoders has to contain every CompressedFormat"
+	);
+
+	const CompressedFormatInfo &getCompressedFormatInfo(CompressedFormat format) {
+		return compressedFormats[usz(format)];
+	}
+
+	GPUFormat getGPUFormat(CompressedFormat format) {
+
+		usz id = GPUFormat::idByName(getCompressedFormatInfo(format).name);
+
+		if (id >= GPUFormat::idByValue(GPUFormat::NONE))
+			return GPUFormat::NONE;
+
+		return GPUFormat(GPUFormat::valueById(id));
+	}
+
+	bool isCompressed(GPUFormat format) {
+
+		if (format == GPUFormat::NONE)
+			return false;
+
+		for (u8 i = 0; i < u8(CompressedFormat::COUNT); ++i)
+			if (getGPUFormat(CompressedFormat(i)) == format)
+				return true;
+
+		return false;
+	}
+
+	//Get the channel count of 8-bit formats that can be compressed (0 if it can't be)
+
+	inline usz getCompressibleChannels(GPUFormat format) {
+
+		if (FormatHelper::getStrideBytes(format) != 1)
+			return 0;
+
+		if (format != GPUFormat::srgba8 && FormatHelper::getType(format) != GPUFormatType::UNORM)
+			return 0;
+
+		usz channels = FormatHelper::getSizeBytes(format);
+		return channels - 1 < 4 ? channels : 0;
+	}
+
+	//Compress all images into blocks
+
+	Helper::ErrorMessage compress(
+		const IGXI &in, u16 formatId, CompressedFormat format, f32 quality, List<Buffer> &out, u32 threads
+	) {
+
+		List<List<Buffer>> data;
+
+		if (Helper::ErrorMessage msg = compress(in, formatId, List<CompressedFormat>{ format }, quality, data, threads))
+			return msg;
+
+		out = std::move(data[0]);
+		return Helper::SUCCESS;
+	}
+
+	Helper::ErrorMessage compress(
+		const IGXI &in, u16 formatId, const List<CompressedFormat> &formats, f32 quality,
+		List<List<Buffer>> &out, u32 threads
+	) {
+
+		if (formatId >= in.header.formats || formatId >= in.data.size())
+			return Helper::INVALID_RESOURCE_INDEX;
+
+		for (CompressedFormat format : formats)
+			if (format >= CompressedFormat::COUNT)
+				return Helper::INVALID_RESOURCE_INDEX;
+
+		usz channels = getCompressibleChannels(in.format[formatId]);
+
+		if (!channels)
+			return Helper::INCOMPATIBLE_FORMATS;
+
+		//0 -> 4 refinement passes per block
+
+		u8 iterations = u8(std::lround(std::clamp(quality, 0.f, 1.f) * 4));
+
+		const List<Buffer> &data = in.data[formatId];
+
+		usz mips = std::min(usz(in.header.mips), data.size());
+		usz layers = in.header.layers;
+
+		List<Array<u16, 3>> dims(mips);
+
+		for (usz mip = 0; mip < mips; ++mip) {
+
+			Array<u16, 3> &dim = dims[mip];
+
+			if (!mip)
+				dim = { in.header.width, in.header.height, in.header.length };
+
+			else for (usz j = 0; j < 3; ++j)
+				dim[j] = u16((dims[mip - 1][j] + 1) / 2);
+
+			if (data[mip].size() < layers * dim[2] * dim[1] * dim[0] * channels)
+				return Helper::INVALID_IMAGE_SIZE;
+		}
+
+		//Jobs are one row of blocks of one image (layer, z) of a mip of a format
+
+		List<usz> jobOffsets(formats.size() * mips + 1);
+
+		out.resize(formats.size());
+
+		for (usz i = 0; i < formats.size(); ++i) {
+
+			const CompressedFormatInfo &info = getCompressedFormatInfo(formats[i]);
+
+			out[i].resize(mips);
+
+			for (usz mip = 0; mip < mips; ++mip) {
+
+				const Array<u16, 3> &dim = dims[mip];
+
+				usz images = layers * dim[2];
+				usz blocksX = (dim[0] + info.blockWidth - 1) / info.blockWidth;
+				usz blocksY = (dim[1] + info.blockHeight - 1) / info.blockHeight;
+
+				usz k = i * mips + mip;
+
+				out[i][mip].resize(images * blocksY * blocksX * info.blockBytes);
+				jobOffsets[k + 1] = jobOffsets[k] + images * blocksY;
+			}
+		}
+
+		parallelFor(jobOffsets.back(), threads, [&](usz job) {
+
+			usz k{};
+
+			while (job >= jobOffsets[k + 1])
+				++k;
+
+			usz i = k / mips, mip = k % mips;
+
+			const CompressedFormatInfo &info = getCompressedFormatInfo(formats[i]);
+			BlockEncoder encoder = blockEncoders[usz(formats[i])];
+
+			const Array<u16, 3> &dim = dims[mip];
+
+			usz blocksX = (dim[0] + info.blockWidth - 1) / info.blockWidth;
+			usz blocksY = (dim[1] + info.blockHeight - 1) / info.blockHeight;
+
+			usz local = job - jobOffsets[k];
+			usz image = local / blocksY, blockY = local % blocksY;
+
+			const u8 *src = data[mip].data() + image * dim[1] * dim[0] * channels;
+			u8 *dst = out[i][mip].data() + (image * blocksY + blockY) * blocksX * info.blockBytes;
+
+			for (usz blockX = 0; blockX < blocksX; ++blockX) {
+
+				//Gather the block; pixels outside of the image repeat the edge
+
+				u8 block[64][4];
+
+				for (usz py = 0; py < info.blockHeight; ++py)
+					for (usz px = 0; px < info.blockWidth; ++px) {
+
+						usz x = std::min(blockX * info.blockWidth + px, usz(dim[0]) - 1);
+						usz y = std::min(blockY * info.blockHeight + py, usz(dim[1]) - 1);
+
+						const u8 *pixel = src + (y * dim[0] + x) * channels;
+						u8 *target = block[py * info.blockWidth + px];
+
+						for (usz c = 0; c < 4; ++c)
+							target[c] = c < channels ? pixel[c] : (c == 3 ? 255 : 0);
+					}
+
+				encoder(block, info.blockWidth, info.blockHeight, dst + blockX * info.blockBytes, iterations);
+			}
+		});
+
+		return Helper::SUCCESS;
+	}
+
+	//Alpha is unused if it's the same everywhere (0 if it was padded from RGB, or 255)
+
+	bool usesAlpha(const IGXI &in, u16 formatId) {
+
+		if (formatId >= in.data.size() || in.data[formatId].empty())
+			return false;
+
+		if (getCompressibleChannels(in.format[formatId]) != 4)
+			return false;
+
+		const Buffer &base = in.data[formatId][0];
+
+		//The buffer can be bigger than the header (e.g. when it's reused for fewer layers)
+
+		usz size = std::min(
+			base.size(), usz(in.header.layers) * in.header.length * in.header.height * in.header.width * 4
+		);
+
+		if (size < 4)
+			return false;
+
+		u8 alpha = base[3];
+
+		if (alpha != 0 && alpha != 255)
+			return true;
+
+		for (usz i = 3; i < size; i += 4)
+			if (base[i] != alpha)
+				return true;
+
+		return false;
+	}
+
+	List<CompressedFormat> getCompressionTargets(GPUFormat format, Helper::Flags flags, f32 quality, bool alpha) {
+
+		usz channels = getCompressibleChannels(format);
+
+		if (!channels)
+			return {};
+
+		bool srgb = format == GPUFormat::srgba8;
+
+		if (!(flags & Helper::PROPERTY_COMPRESSION))
+			flags = Helper::Flags(flags | Helper::COMPRESS_BC);
+
+		List<CompressedFormat> targets;
+
+		if (flags & Helper::COMPRESS_BC)
+			switch (channels) {
+
+				case 1:		targets.push_back(CompressedFormat::BC4);	break;
+				case 2:		targets.push_back(CompressedFormat::BC5);	break;
+
+				default:
+
+					if (quality >= .5f)
+						targets.push_back(srgb ? CompressedFormat::BC7_SRGB : CompressedFormat::BC7);
+
+					else if (channels == 4 && alpha)
+						targets.push_back(srgb ? CompressedFormat::BC3_SRGB : CompressedFormat::BC3);
+
+					else targets.push_back(srgb ? CompressedFormat::BC1_SRGB : CompressedFormat::BC1);
+			}
+
+		if (flags & Helper::COMPRESS_ASTC_4x4)
+			targets.push_back(srgb ? CompressedFormat::ASTC_4x4_SRGB : CompressedFormat::ASTC_4x4);
+
+		if (flags & Helper::COMPRESS_ASTC_6x6)
+			targets.push_back(srgb ? CompressedFormat::ASTC_6x6_SRGB : CompressedFormat::ASTC_6x6);
+
+		if (flags & Helper::COMPRESS_ASTC_8x8)
+			targets.push_back(srgb ? CompressedFormat::ASTC_8x8_SRGB : CompressedFormat::ASTC_8x8);
+
+		//Skip the formats the graphics api doesn't know
+
+		for (usz i = 0; i < targets.size(); )
+			if (getGPUFormat(targets[i]) == GPUFormat::NONE)
+				targets.erase(targets.begin() + i);
+
+			else ++i;
+
+		return targets;
+	}
+
+	Helper::ErrorMessage compress(IGXI &out, Helper::Flags flags, f32 quality, u32 threads) {
+
+		if (!out.header.formats || out.data.empty() || out.data[0].empty())
+			return Helper::SUCCESS;
+
+		List<CompressedFormat> targets = getCompressionTargets(out.format[0], flags, quality, usesAlpha(out));
+
+		if (targets.empty())
+			return Helper::SUCCESS;
+
+		List<List<Buffer>> data;
+
+		if (Helper::ErrorMessage msg = compress(out, 0, targets, quality, data, threads))
+			return msg;
+
+		//Format 0 is either replaced or kept in front of the compressed formats
+
+		usz first = flags & Helper::KEEP_UNCOMPRESSED ? 1 : 0;
+
+		out.format.resize(first + targets.size());
+		out.data.resize(first + targets.size());
+
+		for (usz i = 0; i < targets.size(); ++i) {
+			out.format[first + i] = getGPUFormat(targets[i]);
+			out.data[first + i] = std::move(data[i]);
+		}
+
+		out.header.formats = u16(out.format.size());
+
+		return Helper::SUCCESS;
+	}
+
+}
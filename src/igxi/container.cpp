@@ -0,0 +1,428 @@
+#include "igxi/convert.hpp"
+#include "igxi/compress.hpp"
+#include "igxi/mips.hpp"
+#include "igxi/flags.hpp"
+#include "igxi/mapped_file.hpp"
+#include "igxi/parallel.hpp"
+
+using namespace ignis;
+
+namespace igxi {
+
+	//Formats of containers
+	//Compressed formats are looked up by name (see getGPUFormat), the others by their bit layout
+
+	struct ContainerFormat {
+		u32 id;							//DXGI_FORMAT or VkFormat
+		CompressedFormat compressed;	//COUNT if it's uncompressed
+		u8 channels, bytes;				//Of uncompressed formats
+		GPUFormatType type;
+		bool srgb;
+	};
+
+	static constexpr CompressedFormat uncompressed = CompressedFormat::COUNT;
+
+	static constexpr ContainerFormat dxgiFormats[] = {
+		{ 2,	uncompressed,					4, 4, GPUFormatType::FLOAT, false },	//R32G32B32A32_FLOAT
+		{ 6,	uncompressed,					3, 4, GPUFormatType::FLOAT, false },	//R32G32B32_FLOAT
+		{ 10,	uncompressed,					4, 2, GPUFormatType::FLOAT, false },	//R16G16B16A16_FLOAT
+		{ 11,	uncompressed,					4, 2, GPUFormatType::UNORM, false },	//R16G16B16A16_UNORM
+		{ 16,	uncompressed,					2, 4, GPUFormatType::FLOAT, false },	//R32G32_FLOAT
+		{ 28,	uncompressed,					4, 1, GPUFormatType::UNORM, false },	//R8G8B8A8_UNORM
+		{ 29,	uncompressed,					4, 1, GPUFormatType::UNORM, true },		//R8G8B8A8_UNORM_SRGB
+		{ 34,	uncompressed,					2, 2, GPUFormatType::FLOAT, false },	//R16G16_FLOAT
+		{ 35,	uncompressed,					2, 2, GPUFormatType::UNORM, false },	//R16G16_UNORM
+		{ 41,	uncompressed,					1, 4, GPUFormatType::FLOAT, false },	//R32_FLOAT
+		{ 49,	uncompressed,					2, 1, GPUFormatType::UNORM, false },	//R8G8_UNORM
+		{ 54,	uncompressed,					1, 2, GPUFormatType::FLOAT, false },	//R16_FLOAT
+		{ 56,	uncompressed,					1, 2, GPUFormatType::UNORM, false },	//R16_UNORM
+		{ 61,	uncompressed,					1, 1, GPUFormatType::UNORM, false },	//R8_UNORM
+		{ 71,	CompressedFormat::BC1,			0, 0, GPUFormatType::UNORM, false },	//BC1_UNORM
+		{ 72,	CompressedFormat::BC1_SRGB,		0, 0, GPUFormatType::UNORM, true },		//BC1_UNORM_SRGB
+		{ 77,	CompressedFormat::BC3,			0, 0, GPUFormatType::UNORM, false },	//BC3_UNORM
+		{ 78,	CompressedFormat::BC3_SRGB,		0, 0, GPUFormatType::UNORM, true },		//BC3_UNORM_SRGB
+		{ 80,	CompressedFormat::BC4,			0, 0, GPUFormatType::UNORM, false },	//BC4_UNORM
+		{ 83,	CompressedFormat::BC5,			0, 0, GPUFormatType::UNORM, false },	//BC5_UNORM
+		{ 98,	CompressedFormat::BC7,			0, 0, GPUFormatType::UNORM, false },	//BC7_UNORM
+		{ 99,	CompressedFormat::BC7_SRGB,		0, 0, GPUFormatType::UNORM, true }		//BC7_UNORM_SRGB
+	};
+
+	static constexpr ContainerFormat vkFormats[] = {
+		{ 9,	uncompressed,					1, 1, GPUFormatType::UNORM, false },	//R8_UNORM
+		{ 16,	uncompressed,					2, 1, GPUFormatType::UNORM, false },	//R8G8_UNORM
+		{ 37,	uncompressed,					4, 1, GPUFormatType::UNORM, false },	//R8G8B8A8_UNORM
+		{ 43,	uncompressed,					4, 1, GPUFormatType::UNORM, true },		//R8G8B8A8_SRGB
+		{ 70,	uncompressed,					1, 2, GPUFormatType::UNORM, false },	//R16_UNORM
+		{ 76,	uncompressed,					1, 2, GPUFormatType::FLOAT, false },	//R16_SFLOAT
+		{ 77,	uncompressed,					2, 2, GPUFormatType::UNORM, false },	//R16G16_UNORM
+		{ 83,	uncompressed,					2, 2, GPUFormatType::FLOAT, false },	//R16G16_SFLOAT
+		{ 91,	uncompressed,					4, 2, GPUFormatType::UNORM, false },	//R16G16B16A16_UNORM
+		{ 97,	uncompressed,					4, 2, GPUFormatType::FLOAT, false },	//R16G16B16A16_SFLOAT
+		{ 100,	uncompressed,					1, 4, GPUFormatType::FLOAT, false },	//R32_SFLOAT
+		{ 103,	uncompressed,					2, 4, GPUFormatType::FLOAT, false },	//R32G32_SFLOAT
+		{ 106,	uncompressed,					3, 4, GPUFormatType::FLOAT, false },	//R32G32B32_SFLOAT
+		{ 109,	uncompressed,					4, 4, GPUFormatType::FLOAT, false },	//R32G32B32A32_SFLOAT
+		{ 131,	CompressedFormat::BC1,			0, 0, GPUFormatType::UNORM, false },	//BC1_RGB_UNORM_BLOCK
+		{ 132,	CompressedFormat::BC1_SRGB,		0, 0, GPUFormatType::UNORM, true },		//BC1_RGB_SRGB_BLOCK
+		{ 133,	CompressedFormat::BC1,			0, 0, GPUFormatType::UNORM, false },	//BC1_RGBA_UNORM_BLOCK
+		{ 134,	CompressedFormat::BC1_SRGB,		0, 0, GPUFormatType::UNORM, true },		//BC1_RGBA_SRGB_BLOCK
+		{ 137,	CompressedFormat::BC3,			0, 0, GPUFormatType::UNORM, false },	//BC3_UNORM_BLOCK
+		{ 138,	CompressedFormat::BC3_SRGB,		0, 0, GPUFormatType::UNORM, true },		//BC3_SRGB_BLOCK
+		{ 139,	CompressedFormat::BC4,			0, 0, GPUFormatType::UNORM, false },	//BC4_UNORM_BLOCK
+		{ 141,	CompressedFormat::BC5,			0, 0, GPUFormatType::UNORM, false },	//BC5_UNORM_BLOCK
+		{ 145,	CompressedFormat::BC7,			0, 0, GPUFormatType::UNORM, false },	//BC7_UNORM_BLOCK
+		{ 146,	CompressedFormat::BC7_SRGB,		0, 0, GPUFormatType::UNORM, true },		//BC7_SRGB_BLOCK
+		{ 157,	CompressedFormat::ASTC_4x4,		0, 0, GPUFormatType::UNORM, false },	//ASTC_4x4_UNORM_BLOCK
+		{ 158,	CompressedFormat::ASTC_4x4_SRGB,	0, 0, GPUFormatType::UNORM, true },		//ASTC_4x4_SRGB_BLOCK
+		{ 165,	CompressedFormat::ASTC_6x6,		0, 0, GPUFormatType::UNORM, false },	//ASTC_6x6_UNORM_BLOCK
+		{ 166,	CompressedFormat::ASTC_6x6_SRGB,	0, 0, GPUFormatType::UNORM, true },		//ASTC_6x6_SRGB_BLOCK
+		{ 171,	CompressedFormat::ASTC_8x8,		0, 0, GPUFormatType::UNORM, false },	//ASTC_8x8_UNORM_BLOCK
+		{ 172,	CompressedFormat::ASTC_8x8_SRGB,	0, 0, GPUFormatType::UNORM, true }		//ASTC_8x8_SRGB_BLOCK
+	};
+
+	template<usz N>
+	inline const ContainerFormat *findFormat(const ContainerFormat (&formats)[N], u32 id) {
+
+		for (const ContainerFormat &format : formats)
+			if (format.id == id)
+				return &format;
+
+		return nullptr;
+	}
+
+	inline GPUFormat getGPUFormat(const ContainerFormat &format) {
+
+		if (format.compressed != uncompressed)
+			return getGPUFormat(format.compressed);
+
+		if (format.srgb)
+			return GPUFormat::srgba8;
+
+		GPUFormat result = GPUFormat(u16((format.channels - 1) | ((format.bytes - 1) << 2) | (u8(format.type) << 4)));
+
+		if (GPUFormat::idByValue(result.value) >= GPUFormat::idByValue(GPUFormat::NONE))
+			return GPUFormat::NONE;
+
+		return result;
+	}
+
+	//Size of one image (z and layer) of a mip; compressed formats are stored in whole blocks
+
+	inline usz getImageSize(const ContainerFormat &format, usz width, usz height) {
+
+		if (format.compressed == uncompressed)
+			return width * height * format.channels * format.bytes;
+
+		const CompressedFormatInfo &info = getCompressedFormatInfo(format.compressed);
+
+		usz blocksX = (width + info.blockWidth - 1) / info.blockWidth;
+		usz blocksY = (height + info.blockHeight - 1) / info.blockHeight;
+
+		return blocksX * blocksY * info.blockBytes;
+	}
+
+	//Everything that is needed to copy the subresources out of a container
+
+	struct ContainerLayout {
+
+		const ContainerFormat *format{};
+		u32 width{}, height{}, length = 1, layers = 1, mips = 1;
+		bool is1D{}, isCube{}, isArray{};
+
+		List<usz> offsets;		//Of every mip and layer (offsets[mip * layers + layer]); all z of it are after each other
+
+		//The size of a mip as the container stores it (rounded down, like D3D and Vulkan)
+
+		inline usz getMipSize(u32 mip) const {
+			return
+				getImageSize(*format, std::max(width >> mip, 1u), std::max(height >> mip, 1u)) *
+				std::max(length >> mip, 1u);
+		}
+	};
+
+	template<typename T>
+	inline T read(const u8 *file, usz offset) {
+		T t;
+		std::memcpy(&t, file + offset, sizeof(t));
+		return t;
+	}
+
+	//DDS; the layers are after each other with all of their mips
+
+	inline Helper::ErrorMessage parseDDS(const u8 *file, usz size, ContainerLayout &layout) {
+
+		constexpr usz headerSize = 128, dx10HeaderSize = 20;
+
+		if (size < headerSize || read<u32>(file, 4) != 124)
+			return Helper::INVALID_FILE_DATA;
+
+		layout.height = read<u32>(file, 12);
+		layout.width = read<u32>(file, 16);
+		layout.mips = std::max(read<u32>(file, 28), 1u);
+
+		u32 pixelFlags = read<u32>(file, 80);
+		u32 fourCC = read<u32>(file, 84);
+		u32 caps2 = read<u32>(file, 112);
+
+		constexpr u32 ddpfAlphaPixels = 0x1, ddpfFourCC = 0x4, ddpfRGB = 0x40, ddpfLuminance = 0x20000;
+		constexpr u32 cubemap = 0x200, allFaces = 0xFC00, volume = 0x200000;
+
+		usz offset = headerSize;
+		u32 dxgi{};
+
+		if (pixelFlags & ddpfFourCC) {
+
+			//Legacy formats are mapped to their DXGI_FORMAT
+
+			switch (fourCC) {
+
+				case 0x31545844:	dxgi = 71;	break;		//DXT1
+				case 0x35545844:	dxgi = 77;	break;		//DXT5
+				case 0x31495441:							//ATI1
+				case 0x55344342:	dxgi = 80;	break;		//BC4U
+				case 0x32495441:							//ATI2
+				case 0x55354342:	dxgi = 83;	break;		//BC5U
+
+				case 36:			dxgi = 11;	break;		//A16B16G16R16
+				case 111:			dxgi = 54;	break;		//R16F
+				case 112:			dxgi = 34;	break;		//G16R16F
+				case 113:			dxgi = 10;	break;		//A16B16G16R16F
+				case 114:			dxgi = 41;	break;		//R32F
+				case 115:			dxgi = 16;	break;		//G32R32F
+				case 116:			dxgi = 2;	break;		//A32B32G32R32F
+
+				//DX10; the type is in the extended header
+
+				case 0x30315844: {
+
+					if (size < headerSize + dx10HeaderSize)
+						return Helper::INVALID_FILE_BOUNDS;
+
+					dxgi = read<u32>(file, 128);
+
+					u32 dimension = read<u32>(file, 132), arraySize = std::max(read<u32>(file, 140), 1u);
+
+					layout.isCube = read<u32>(file, 136) & 0x4;
+					layout.isArray = arraySize > 1;
+					layout.layers = arraySize * (layout.isCube ? 6 : 1);
+
+					switch (dimension) {
+						case 2:		layout.is1D = true;										break;
+						case 3:																break;
+						case 4:		layout.length = std::max(read<u32>(file, 24), 1u);		break;
+						default:	return Helper::INVALID_TYPE;
+					}
+
+					offset += dx10HeaderSize;
+					break;
+				}
+
+				default:
+					return Helper::INVALID_FORMAT;
+			}
+		}
+
+		//Only RGBA8; without an alpha mask, the 4th byte is padding (RGBX8), which has no format to copy into
+
+		else if (
+			(pixelFlags & (ddpfRGB | ddpfAlphaPixels)) == (ddpfRGB | ddpfAlphaPixels) && read<u32>(file, 88) == 32 && 
+			read<u32>(file, 92) == 0xFF && read<u32>(file, 96) == 0xFF00 && read<u32>(file, 100) == 0xFF0000 && read<u32>(file, 104) == 0xFF000000
+		)
+			dxgi = 28;
+
+		else if (pixelFlags & ddpfLuminance && read<u32>(file, 88) == 8)
+			dxgi = 61;
+
+		else return Helper::INVALID_FORMAT;
+
+		//Legacy cubes and volumes
+
+		if (offset == headerSize) {
+
+			if (caps2 & cubemap) {
+
+				if ((caps2 & allFaces) != allFaces)
+					return Helper::MISSING_FACE;
+
+				layout.isCube = true;
+				layout.layers = 6;
+			}
+
+			else if (caps2 & volume)
+				layout.length = std::max(read<u32>(file, 24), 1u);
+		}
+
+		if (!(layout.format = findFormat(dxgiFormats, dxgi)))
+			return Helper::INVALID_FORMAT;
+
+		//Every layer has the whole mip chain
+
+		layout.offsets.resize(usz(layout.mips) * layout.layers);
+
+		for (u32 layer = 0; layer < layout.layers; ++layer)
+			for (u32 mip = 0; mip < layout.mips; ++mip) {
+				layout.offsets[usz(mip) * layout.layers + layer] = offset;
+				offset += layout.getMipSize(mip);
+			}
+
+		return offset > size ? Helper::INVALID_FILE_BOUNDS : Helper::SUCCESS;
+	}
+
+	//KTX2; every mip has its own level with all layers, faces and z after each other
+
+	static constexpr u8 ktx2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	inline Helper::ErrorMessage parseKTX2(const u8 *file, usz size, ContainerLayout &layout) {
+
+		constexpr usz headerSize = 80, levelSize = 24;
+
+		if (size < headerSize)
+			return Helper::INVALID_FILE_BOUNDS;
+
+		u32 vkFormat = read<u32>(file, 12);
+
+		layout.width = read<u32>(file, 20);
+		layout.is1D = !read<u32>(file, 24);
+		layout.height = std::max(read<u32>(file, 24), 1u);
+		layout.length = std::max(read<u32>(file, 28), 1u);
+
+		u32 layers = read<u32>(file, 32), faces = read<u32>(file, 36);
+
+		layout.isArray = layers > 0;
+		layout.isCube = faces == 6;
+		layout.layers = std::max(layers, 1u) * faces;
+
+		//Levels of 0 means the mips should be generated at runtime
+
+		layout.mips = std::max(read<u32>(file, 40), 1u);
+
+		//Supercompressed data (e.g. BasisLZ or zstd) has to be decoded first
+
+		if (read<u32>(file, 44))
+			return Helper::INVALID_OPERATION;
+
+		if ((faces != 1 && faces != 6) || (layout.isCube && layout.length > 1))
+			return Helper::INVALID_TYPE;
+
+		if (!(layout.format = findFormat(vkFormats, vkFormat)))
+			return Helper::INVALID_FORMAT;
+
+		if (size < headerSize + levelSize * layout.mips)
+			return Helper::INVALID_FILE_BOUNDS;
+
+		layout.offsets.resize(usz(layout.mips) * layout.layers);
+
+		for (u32 mip = 0; mip < layout.mips; ++mip) {
+
+			u64 offset = read<u64>(file, headerSize + levelSize * mip);
+			u64 length = read<u64>(file, headerSize + levelSize * mip + 8);
+
+			usz mipSize = layout.getMipSize(mip);
+
+			if (length != u64(mipSize) * layout.layers || offset > size || length > size - offset)
+				return Helper::INVALID_FILE_BOUNDS;
+
+			for (u32 layer = 0; layer < layout.layers; ++layer)
+				layout.offsets[usz(mip) * layout.layers + layer] = usz(offset) + mipSize * layer;
+		}
+
+		return Helper::SUCCESS;
+	}
+
+	Helper::ErrorMessage Helper::convertContainer(IGXI &out, const String &path, Flags flags, u32 threads) {
+
+		MappedFile file(path);
+
+		if (!file.data())
+			return INVALID_FILE_PATH;
+
+		const u8 *data = file.data();
+		usz size = file.size();
+
+		ContainerLayout layout;
+		ErrorMessage msg;
+
+		if (size >= 4 && !std::memcmp(data, "DDS ", 4))
+			msg = parseDDS(data, size, layout);
+
+		else if (size >= sizeof(ktx2Identifier) && !std::memcmp(data, ktx2Identifier, sizeof(ktx2Identifier)))
+			msg = parseKTX2(data, size, layout);
+
+		else msg = INVALID_FILE_DATA;
+
+		if (msg)
+			return msg;
+
+		GPUFormat format = getGPUFormat(*layout.format);
+
+		if (format == GPUFormat::NONE)
+			return INVALID_FORMAT;
+
+		//u16_MAX is reserved as an error code
+
+		if (!layout.width || !layout.height || layout.width >= u16_MAX || layout.height >= u16_MAX || layout.length >= u16_MAX)
+			return INVALID_IMAGE_SIZE;
+
+		//3D textures can't be arrays
+
+		if (layout.length > 1 && layout.layers > 1)
+			return INVALID_TYPE;
+
+		if (layout.layers >= u16_MAX || layout.mips > getMipCount(u16(layout.width), u16(layout.height), u16(layout.length)))
+			return INVALID_RESOURCE_INDEX;
+
+		//Containers round mips down, IGXI rounds them up; so the chain of sizes that aren't a power of two can't be kept
+
+		for (u32 mip = 1, x = layout.width, y = layout.height, z = layout.length; mip < layout.mips; ++mip) {
+
+			x = (x + 1) / 2;
+			y = (y + 1) / 2;
+			z = (z + 1) / 2;
+
+			if (x != std::max(layout.width >> mip, 1u) || y != std::max(layout.height >> mip, 1u) || z != std::max(layout.length >> mip, 1u))
+				return INVALID_IMAGE_SIZE;
+		}
+
+		TextureType type =
+			layout.isCube ? TextureType::TEXTURE_CUBE : (
+				layout.length > 1 ? TextureType::TEXTURE_3D : (
+					layout.is1D ? TextureType::TEXTURE_1D : TextureType::TEXTURE_2D
+				)
+			);
+
+		if (layout.isArray)
+			type = TextureType(u8(type) | u8(TextureType::PROPERTY_IS_ARRAY));
+
+		//The data is stored as is, only the memory flags are used
+
+		out = {};
+		out.header.flags = IGXI::Flags::CONTAINS_DATA;
+		out.header.formats = 1;
+		out.header.usage = getUsage(flags);
+		out.header.type = type;
+		out.header.width = u16(layout.width);
+		out.header.height = u16(layout.height);
+		out.header.length = u16(layout.length);
+		out.header.layers = u16(layout.layers);
+		out.header.mips = u8(layout.mips);
+
+		out.format = { format };
+		out.data = { List<Buffer>(layout.mips) };
+
+		for (u32 mip = 0; mip < layout.mips; ++mip)
+			out.data[0][mip].resize(layout.getMipSize(mip) * layout.layers);
+
+		//Copy every mip of every layer straight from the mapped file
+
+		parallelFor(layout.offsets.size(), threads, [&](usz i) {
+
+			u32 mip = u32(i / layout.layers), layer = u32(i % layout.layers);
+			usz mipSize = layout.getMipSize(mip);
+
+			std::memcpy(out.data[0][mip].data() + mipSize * layer, data + layout.offsets[i], mipSize);
+		});
+
+		return SUCCESS;
+	}
+
+}
@@ -1,7 +1,21 @@
 #include "igxi/convert.hpp"
+#include "igxi/parallel.hpp"
+#include "igxi/kernels.hpp"
+#include "igxi/mips.hpp"
+#include "igxi/compress.hpp"
+#include "igxi/mapped_file.hpp"
+#include "igxi/png.hpp"
+#include "igxi/cache.hpp"
+#include "igxi/file_index.hpp"
+#include "igxi/cube.hpp"
+#include "igxi/resample.hpp"
+#include "igxi/flags.hpp"
 #include "system/system.hpp"
 #include "system/log.hpp"
 #include "system/local_file_system.hpp"
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
@@ -9,43 +23,12 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb/stb_image_write.h"
 
-#define STB_IMAGE_RESIZE_IMPLEMENTATION
-#include "stb/stb_image_resize.h"
-
 using namespace ignis;
 
 namespace igxi {
 
-	//Raw channel access
-
-	inline u64 readValue(usz stride, const u8 *data) {
-		switch (stride) {
-			case 1:		return *data;
-			case 2:		return *(const u16*)data;
-			case 4:		return *(const u32*)data;
-			case 8:		return *(const u64*)data;
-			default:	return 0;
-		}
-	}
-
-	inline void writeValue(usz stride, u8 *data, u64 val) {
-		switch (stride) {
-			case 1:		*data = u8(val);			break;
-			case 2:		*(u16*)data = u16(val);		break;
-			case 4:		*(u32*)data = u32(val);		break;
-			case 8:		*(u64*)data = u64(val);		break;
-			default:	0;
-		}
-	}
-
-	//Spaghetti monster of conversion between types
-
-	template<typename T>
-	inline u64 toU64(const T &t) {
-		u64 v{};
-		*(T*)&v = t;
-		return v;
-	}
+	//Conversion between types
+	//The conversion itself is done by the kernels in igxi/kernels.hpp
 
 	inline bool canConvert(GPUFormat target, GPUFormat input) {
 		return 
@@ -56,73 +39,157 @@ namespace igxi {
 			);
 	}
 
-	inline u64 convert(GPUFormat target, GPUFormat input, const u64 &val) {
+	//Get the channel count that is requested from stb (0 is the input channel count)
 
-		if (FormatHelper::getStrideBytes(target) == FormatHelper::getStrideBytes(input))
-			return val;
+	inline Helper::ErrorMessage getChannelCount(Helper::Flags flags, int &channelCount) {
+
+		switch (flags & Helper::PROPERTY_CHANNELS) {
 
-		switch (FormatHelper::getStrideBytes(target)) {
+			case 0: channelCount = 0; break;
 
-			case 2:	{
+			case Helper::IS_R: channelCount = 1; break;
+			case Helper::IS_RG: channelCount = 2; break;
+			case Helper::IS_RGB: channelCount = 3; break;
+			case Helper::IS_RGBA: channelCount = 4; break;
 
-				f16 v;
+			default: return Helper::INVALID_CHANNELS;
 
-				if(FormatHelper::getStrideBytes(input) == 4)
-					v = f16(*(const f32*)&val);
-				else
-					v = f16(*(const f64*)&val);
+		}
 
-				if (v.lacksPrecision())
-					v = f16::max();
+		return Helper::SUCCESS;
+	}
 
-				return toU64(v);
-			}
+	//Get the format an image is stored as, from the flags and the decoded channel count and type
+	//RGB8 and RGB16 don't exist, so channelCount is changed to 4 for those
 
-			case 4: {
+	inline Helper::ErrorMessage getFormat(
+		Helper::Flags flags, bool inputFloat, bool input16Bit, int &channelCount, GPUFormat &format
+	) {
 
-				if(FormatHelper::getStrideBytes(input) == 2)
-					return toU64(f32(*(const f16*)&val));
+		//Get primitive
 
-				f32 v = f32(*(const f64*)&val);
+		GPUFormatType primitive;
 
-				if ((*(flp32*)&v).lacksPrecision())
-					v = f32_MAX;
+		switch (flags & Helper::PROPERTY_PRIMTIIVE) {
 
-				return toU64(v);
-			}
+			case 0: primitive = inputFloat ? GPUFormatType::FLOAT : GPUFormatType::UNORM; break;
+			
+			case Helper::IS_SINT: primitive = GPUFormatType::SINT; break;
+			case Helper::IS_UINT: primitive = GPUFormatType::UINT; break;
+			case Helper::IS_UNORM: primitive = GPUFormatType::UNORM; break;
+			case Helper::IS_SNORM: primitive = GPUFormatType::SNORM; break;
+			case Helper::IS_FLOAT: primitive = GPUFormatType::FLOAT; break;
+			
+			default: return Helper::INVALID_PRIMITIVE;
+
+		}
+
+		//Get bits
+
+		u32 bytes;
+
+		switch (flags & Helper::PROPERTY_BITS) {
+
+			case 0: bytes = inputFloat || input16Bit ? 2 : 1; break;
+
+			case Helper::IS_8_BIT: bytes = 1; break;
+			case Helper::IS_16_BIT: bytes = 2; break;
+			case Helper::IS_32_BIT: bytes = 4; break;
+			case Helper::IS_64_BIT: bytes = 8; break;
+
+			default: return Helper::INVALID_BITS;
+
+		}
+
+		//Get format
+
+		format = GPUFormat::NONE;
+
+		if ((bytes == 1 || bytes == 2) && channelCount == 3)
+			channelCount = 4;
 
-			case 8:
+		if (flags & Helper::IS_SRGB) {
+
+			if (bytes == 1 && channelCount == 4)
+				format = GPUFormat::srgba8;
 
-				if(FormatHelper::getStrideBytes(input) == 2)
-					return toU64(f64(*(const f16*)&val));
+		} else {
 
-				return toU64(f64(*(const f32*)&val));
+			if(
+				!(bytes == 1 && primitive == GPUFormatType::FLOAT) && 
+				!(bytes > 2 && !(u8(primitive) & u8(GPUFormatType::PROPERTY_IS_UNNORMALIZED)))
+			)
+				format = GPUFormat(u16((channelCount - 1) | ((bytes - 1) << 2) | (u8(primitive) << 4)));
 
-			default: return 0;
 		}
 
+		if (GPUFormat::idByValue(format.value) >= GPUFormat::idByValue(GPUFormat::NONE))
+			return Helper::INVALID_FORMAT;
+
+		return Helper::SUCCESS;
 	}
 
 	//Load a given file and mips
-
+	//Doesn't touch any shared state, so multiple images can be loaded at the same time
+	//
+	//Once the size and format are known, getTarget(width, height, format, frame, target) is called;
+	//	it returns the memory the image should end up in (e.g. its slice in the IGXI) or an error.
+	//	The image is then copied or converted from stb's buffer straight into the target,
+	//	so there are no temporary buffers or copies in between
+	//
+	//With FRAMES_FROM_IMAGE, all frames of an animated gif are decoded in one pass and getTarget is called once per frame
+	//	(all frames have the size of the gif's canvas, so they are only checked once)
+	//
+	//If a cache is passed, the decoded image is copied from there if the same file was decoded before (with the same flags)
+	//	Only files with one frame are cached
+	//
+	template<typename GetTarget>
 	inline Helper::ErrorMessage load(
-		List<Buffer> &out, const Buffer &buf, u16 baseMip, u16 mips,
-		Helper::Flags flags, u16 &width, u16 &height, GPUFormat &format,
-		List<Array<u16, 5>> &sizes
+		const u8 *file, usz size, Helper::Flags flags, const GetTarget &getTarget, DecodeCache *cache
 	) {
 
+		//stb can only address up to INT_MAX bytes
+
+		if (!size || size > usz(u32_MAX >> 1))
+			return Helper::INVALID_FILE_BOUNDS;
+
+		//Skip decoding if it's cached
+
+		u64 key{};
+
+		if (cache) {
+
+			key = DecodeCache::getKey(file, size, flags);
+
+			DecodeCache::Header header;
+
+			if (auto cached = cache->find(key, header)) {
+
+				GPUFormat format = GPUFormat(GPUFormat::valueById(header.format));
+
+				u8 *target{};
+
+				if (Helper::ErrorMessage msg = getTarget(header.width, header.height, format, 0, target))
+					return msg;
+
+				std::memcpy(target, cached->data() + sizeof(header), cached->size() - sizeof(header));
+				return Helper::SUCCESS;
+			}
+		}
+
 		//Read image via stbi
 		//Supports jpg/png/bmp/gif/psd/pic/pnm/hdr/tga
 		//Preserve all bit depth
+		//stb returns the channel count of the file, but the data has the requested channel count (if any)
 
 		stbi__result_info ri;
 
 		stbi__context s;
-		stbi__start_mem(&s, buf.data(), int(buf.size()));
+		stbi__start_mem(&s, file, int(size));
 
 		u8 *data{};
 
-		int x{}, y{}, comp{}, stride = 1;
+		int x{}, y{}, comp{}, stride = 1, frames = 1;
 
 		const bool is1D = flags & Helper::IS_1D;
 
@@ -130,31 +197,31 @@ namespace igxi {
 
 		int channelCount;
 
-		switch (flags & Helper::PROPERTY_CHANNELS) {
-
-			case 0: channelCount = 0; break;
-
-			case Helper::IS_R: channelCount = 1; break;
-			case Helper::IS_RG: channelCount = 2; break;
-			case Helper::IS_RGB: channelCount = 3; break;
-			case Helper::IS_RGBA: channelCount = 4; break;
-
-			default: return Helper::INVALID_CHANNELS;
-
-		}
+		if (Helper::ErrorMessage msg = getChannelCount(flags, channelCount))
+			return msg;
 
 		bool inputFloat{}, input16Bit{};
 
 		if (stbi__hdr_test(&s)) {
 
 			data = (u8*) stbi__hdr_load(&s, &x, &y, &comp, channelCount, &ri);
+			comp = channelCount ? channelCount : comp;
 			stride = 4;
 			currentFormat = GPUFormat(u16((comp - 1) | (2 << 2) | (u8(GPUFormatType::FLOAT) << 4)));;
 			inputFloat = true;
 
+		} else if (flags & Helper::FRAMES_FROM_IMAGE && stbi__gif_test(&s)) {
+
+			//Gifs are decoded as RGBA8 (unless channels are requested) and the frames are stored after each other
+
+			data = stbi_load_gif_from_memory(file, int(size), nullptr, &x, &y, &frames, &comp, channelCount);
+			comp = channelCount ? channelCount : 4;
+			currentFormat = GPUFormat(u16((comp - 1) | (u8(GPUFormatType::UNORM) << 4)));
+
 		} else {
 
 			data = (u8*) stbi__load_main(&s, &x, &y, &comp, channelCount, &ri, 16);	
+			comp = channelCount ? channelCount : comp;
 			stride += int(input16Bit = ri.bits_per_channel == 16);
 			currentFormat = GPUFormat(u16((comp - 1) | ((stride - 1) << 2) | (u8(GPUFormatType::UNORM) << 4)));;
 		}
@@ -165,7 +232,7 @@ namespace igxi {
 		if (!data)
 			return Helper::INVALID_FILE_DATA;
 
-		if (!channelCount) {
+		if (!channelCount || frames <= 0 || frames >= u16_MAX) {
 			stbi_image_free(data);
 			return Helper::INVALID_FILE_DATA;
 		}
@@ -184,567 +251,1211 @@ namespace igxi {
 			return Helper::INVALID_IMAGE_SIZE;
 		}
 
-		//Get primitive
+		//Get format
 
-		GPUFormatType primitive;
+		GPUFormat format;
 
-		switch (flags & Helper::PROPERTY_PRIMTIIVE) {
+		if (Helper::ErrorMessage msg = getFormat(flags, inputFloat, input16Bit, channelCount, format)) {
+			stbi_image_free(data);
+			return msg;
+		}
 
-			case 0: primitive = inputFloat ? GPUFormatType::FLOAT : GPUFormatType::UNORM; break;
-			
-			case Helper::IS_SINT: primitive = GPUFormatType::SINT; break;
-			case Helper::IS_UINT: primitive = GPUFormatType::UINT; break;
-			case Helper::IS_UNORM: primitive = GPUFormatType::UNORM; break;
-			case Helper::IS_SNORM: primitive = GPUFormatType::SNORM; break;
-			case Helper::IS_FLOAT: primitive = GPUFormatType::FLOAT; break;
-			
-			default:
-				stbi_image_free(data);
-				return Helper::INVALID_PRIMITIVE;
+		//Pick the kernel once, instead of switching on formats for every channel
 
-		}
+		ConversionKernel kernel{};
 
-		//Get bits
+		if (format != currentFormat) {
 
-		u32 bytes;
+			kernel = canConvert(format, currentFormat) ? 
+				getConversionKernel(format, currentFormat, usz(channelCount), usz(comp)) : nullptr;
 
-		switch (flags & Helper::PROPERTY_BITS) {
+			if (!kernel) {
+				stbi_image_free(data);
+				return Helper::INCOMPATIBLE_FORMATS;
+			}
+		}
 
-			case 0: bytes = inputFloat || input16Bit ? 2 : 1; break;
+		//Write every frame into its target
 
-			case Helper::IS_8_BIT: bytes = 1; break;
-			case Helper::IS_16_BIT: bytes = 2; break;
-			case Helper::IS_32_BIT: bytes = 4; break;
-			case Helper::IS_64_BIT: bytes = 8; break;
+		u8 *target{};
 
-			default: 
+		usz pixels = usz(x) * y, frameSize = usz(stride) * comp * pixels;
+
+		for (int i = 0; i < frames; ++i) {
+
+			if (Helper::ErrorMessage msg = getTarget(u16(x), u16(y), format, u16(i), target)) {
 				stbi_image_free(data);
-				return Helper::INVALID_BITS;
+				return msg;
+			}
 
+			if (kernel)
+				kernel(data + frameSize * i, target, pixels);
+
+			else std::memcpy(target, data + frameSize * i, frameSize);
 		}
 
-		//Get format
+		stbi_image_free(data);
 
-		format = GPUFormat::NONE;
+		if (cache && frames == 1)
+			cache->store(key, u16(x), u16(y), format, target, usz(x) * y * FormatHelper::getSizeBytes(format));
 
-		if ((bytes == 1 || bytes == 2) && channelCount == 3)
-			channelCount = 4;
+		return Helper::SUCCESS;
+	}
 
-		if (flags & Helper::IS_SRGB) {
+	template<typename GetTarget>
+	inline Helper::ErrorMessage load(const String &path, Helper::Flags flags, const GetTarget &getTarget, DecodeCache *cache) {
 
-			if (bytes == 1 && channelCount == 4)
-				format = GPUFormat::srgba8;
+		//Map the file (or read it if it can't be mapped); stb decodes straight from the file's pages
 
-		} else {
+		MappedFile file(path);
 
-			if(
-				!(bytes == 1 && primitive == GPUFormatType::FLOAT) && 
-				!(bytes > 2 && !(u8(primitive) & u8(GPUFormatType::PROPERTY_IS_UNNORMALIZED)))
-			)
-				format = GPUFormat(u16((channelCount - 1) | ((bytes - 1) << 2) | (u8(primitive) << 4)));
+		if (!file.data())
+			return Helper::INVALID_FILE_PATH;
 
-		}
+		if (Helper::ErrorMessage errorMessage = load(file.data(), file.size(), flags, getTarget, cache))
+			return errorMessage;
 
-		if (GPUFormat::idByValue(format.value) >= GPUFormat::idByValue(GPUFormat::NONE)) {
-			stbi_image_free(data);
-			return Helper::INVALID_FORMAT;
-		}
+		return Helper::ErrorMessage::SUCCESS;
+	}
 
-		//Get strides
+	//Count the frames of a gif by skipping over its blocks (0 if it isn't a valid gif)
+	//Every image descriptor is a frame; the compressed data is skipped without decoding it
 
-		if (sizes.empty()) {
+	inline u16 getGifFrameCount(const u8 *file, usz size) {
 
-			u16 xx = u16(x), yy = u16(y);
+		if (size < 13 || std::memcmp(file, "GIF8", 4) || (file[4] != '7' && file[4] != '9') || file[5] != 'a')
+			return 0;
 
-			//TODO: Assumption not always correct
+		usz i = 13;
 
-			width = xx;
-			height = yy;
+		//Global color table
 
-			sizes.resize(mips);
-			out.resize(mips);
+		if (file[10] & 0x80)
+			i += 3 * (usz(2) << (file[10] & 7));
 
-			u16 j = (flags & Helper::GENERATE_MIPS) ? mips : 1;
+		//Skip sub-blocks until the terminator (size 0)
 
-			for (u16 i = 0; i < j; ++i) {
-				sizes[baseMip + i] = { u16(FormatHelper::getSizeBytes(format)), xx, yy, 1, 1 };
-				xx = u16(std::ceil((f32(xx) / 2.f)));
-				yy = u16(std::ceil((f32(yy) / 2.f)));
-			}
-		}
-		else {
-			stbi_image_free(data);
-			return Helper::INVALID_OPERATION;
-		}
+		auto skipSubBlocks = [&]() -> bool {
 
-		if (baseMip != 0) {
-			stbi_image_free(data);
-			return Helper::INVALID_OPERATION;
-		}
-			
-		//TODO:
-			/*{
+			while (i < size && file[i])
+				i += usz(file[i]) + 1;
 
-			update layers/mip
+			return i++ < size;
+		};
 
-			if (x != sizes[baseMip][1] || y != sizes[baseMip][2]) {
-				stbi_image_free(data);
-				return Helper::INVALID_IMAGE_SIZE;
-			}
-		}*/
+		u32 frames{};
 
-		if (format != currentFormat) {
+		while (i < size)
+			switch (file[i++]) {
 
-			if (!canConvert(format, currentFormat))
-				return Helper::INCOMPATIBLE_FORMATS;
+				//Extension; label followed by sub-blocks
 
-			Buffer &converted = out[baseMip] = Buffer(usz(bytes) * channelCount * x * y);
+				case 0x21:
 
-			u8 *convertedPtr = (u8*)converted.data();
+					if (++i > size || !skipSubBlocks())
+						return 0;
 
-			usz copyStride = std::min(channelCount, comp);
-			usz copyLength = copyStride * x * y;
+					break;
 
-			for (usz i = 0; i < copyLength; ++i) {
+				//Image descriptor; 9 bytes, local color table, LZW code size and sub-blocks
 
-				usz channel = i % copyStride;
-				usz xy = i / copyStride;
+				case 0x2C: {
 
-				u64 val = convert(
-					format, 
-					currentFormat,
-					readValue(stride, data + usz(stride) * (channel + xy * comp))
-				);
+					if (i + 9 > size)
+						return 0;
 
-				writeValue(bytes, convertedPtr + usz(bytes) * (channel + xy * channelCount), val);
-			}
+					u8 packed = file[i + 8];
+					i += 9;
 
-		}
-		else out[baseMip] = Buffer(data, data + usz(stride) * comp * x * y);
+					if (packed & 0x80)
+						i += 3 * (usz(2) << (packed & 7));
 
-		//Generate mips
+					if (++i > size || !skipSubBlocks() || ++frames >= u16_MAX)
+						return 0;
 
-		if (flags & Helper::GENERATE_MIPS) {
-			stbi_image_free(data);
-			return Helper::INVALID_OPERATION;
-		}
+					break;
+				}
 
-		//Use optimal format for mip generation; might be sRGB, float format, etc.
+				//Trailer
 
-		//TODO: Only supported with a few formats
-		//TODO: Use premultiplied alpha before generating mips
-		//		Get it back somehow?
+				case 0x3B:
+					return u16(frames);
 
-		//TODO: MIP_NEAREST, MIP_LINEAR, MIP_MIN, MIP_LINEAR
-		//TODO: stbir filters
-		//TODO: Report progress so you can see how much has been converted
+				default:
+					return 0;
+			}
 
-		//stbir_resize_float(...);
-		//Copy into out[baseMip + n] where n < mips
+		//Some encoders leave out the trailer
 
-		stbi_image_free(data);
-		return Helper::SUCCESS;
+		return u16(frames);
 	}
 
-	inline Helper::ErrorMessage load(
-		List<Buffer> &out, u16 baseMip, u16 mips, const String &path,
-		Helper::Flags flags, u16 &width, u16 &height, GPUFormat &format,
-		List<Array<u16, 5>> &sizes
-	) {
+	//Read the size and format of an image from its header; same as load, but without decoding it
 
-		//Get file
+	inline Helper::ErrorMessage probe(const u8 *file, usz size, Helper::Flags flags, Helper::ImageInfo &info) {
 
-		Buffer file;
+		if (!size || size > usz(u32_MAX >> 1))
+			return Helper::INVALID_FILE_BOUNDS;
 
-		{
-			IGXI::File loader(path, false);
+		int channelCount;
+
+		if (Helper::ErrorMessage msg = getChannelCount(flags, channelCount))
+			return msg;
+
+		int x{}, y{}, comp{};
+
+		if (!stbi_info_from_memory(file, int(size), &x, &y, &comp) || !comp)
+			return Helper::INVALID_FILE_DATA;
 
-			usz start{};
+		bool inputFloat = stbi_is_hdr_from_memory(file, int(size));
+		bool input16Bit = !inputFloat && stbi_is_16_bit_from_memory(file, int(size));
 
-			if (loader.readRegion(file.data(), start, loader.size()))
-				return Helper::INVALID_FILE_PATH;
+		if (!channelCount)
+			channelCount = comp;
+
+		if (flags & Helper::IS_1D) {
+			x *= y;
+			y = 1;
 		}
 
-		if (file.size() >= (usz(1) << (sizeof(int) * 8)))
-			return Helper::INVALID_FILE_BOUNDS;
+		if(x >= u16_MAX || y >= u16_MAX || x <= 0 || y <= 0)
+			return Helper::INVALID_IMAGE_SIZE;
 
-		if (Helper::ErrorMessage errorMessage = load(out, file, baseMip, mips, flags, width, height, format, sizes))
-			return errorMessage;
+		info.width = u16(x);
+		info.height = u16(y);
+		info.channels = u8(comp);
+		info.bytesPerChannel = u8(inputFloat ? 4 : (input16Bit ? 2 : 1));
+		info.frames = 1;
 
-		return Helper::ErrorMessage::SUCCESS;
+		if (flags & Helper::FRAMES_FROM_IMAGE && size >= 4 && !std::memcmp(file, "GIF8", 4))
+			if (!(info.frames = getGifFrameCount(file, size)))
+				return Helper::INVALID_FILE_DATA;
+
+		return getFormat(flags, inputFloat, input16Bit, channelCount, info.format);
 	}
 
-	//Find all files that correspond with the given path and parse their file description
+	inline Helper::ErrorMessage probe(const String &path, Helper::Flags flags, Helper::ImageInfo &info) {
 
-	/*inline Helper::ErrorMessage findFiles(
-		const String &path, Helper::Flags flags, List<String> &files
-	) {*/
+		//Only the pages of the header are read
 
-		//TODO: Find appropriate files
-		//Types:
-		//
-		//	If IS_1D is set, it will read the file as a 1D image (even if 2D)
-		//	
-		//	If IS_3D is set; see IS_ARRAY but it is interpreted as 3D
-		//		If both are set, they are merged into one bigger 3D texture
-		//	
-		//	If IS_CUBE is set it will load 6 slices:
-		//		It will look for suffix (case-insensitive)
-		//			'right'	= '+x'
-		//			'left' = '-x'
-		//			'top' = '+y'
-		//			'bottom' = '-y'
-		//			'back' = '+z'
-		//			'front' = '-z'
-		//	
-		//		If GENERATE_MIPS isn't set; all mips have to be initialized
-		//			There can be a 1 character separator after the cube face suffix
-		//			'+x' = mip 0, cube face right
-		//			'front4' = 'front_4' = 'front.4' = mip 4, cube face front
-		//	
-		//		If IS_ARRAY is set; it will require an index
-		//			E.g. 'right0', 'right.1', 'top-1', 'bottom_1'
-		//			If GENERATE_MIPS is not set, it will require the mip then a seperator and then the arraySlice
-		//				E.g. 'right0-1', 'right.0.1', 'top-1_2', etc.
-		//	
-		//	If IS_ARRAY is set, it will include files with the path name and a number after it
-		//		If a number is missing, it ignores it. All numbers are put from lowest to highest
-		//
+		MappedFile file(path);
 
-		//MISSING_FACE is if a face of the cube is missing
-		//MISSING_MIP is if GENERATE_MIP is off and one of the mips isn't provided
-		//MISSING_LAYER is if one of the layers is missing
-		//MISSING_SAMPLE is if one of the layers (samples) of the MS texture is missing
+		if (!file.data())
+			return Helper::INVALID_FILE_PATH;
 
-		//TODO: return files in order from z, layer, mip
-	//}
+		return probe(file.data(), file.size(), flags, info);
+	}
 
-	//Copy memory from temporary image into our target
+	//Probe all files in parallel; files without path are read from the old IGXI (the first one that works)
 
-	inline Helper::ErrorMessage insertInto(
-		Buffer &out, const Buffer &buf, u16 z, u16 layer, const IGXI::Header &/*header*/, const Array<u16, 5> &size
+	inline Helper::ErrorMessage probe(
+		const List<Helper::FileDesc> &files, const IGXI *old, Helper::Flags flags, 
+		List<Helper::ImageInfo> &infos, u32 threads
 	) {
 
-		if (layer >= size[4] || z >= size[3])
-			return Helper::INVALID_RESOURCE_INDEX;
+		usz count = files.size();
 
-		usz oneImg = usz(size[2]) * size[1] * size[0];
+		infos.resize(count);
 
-		if(buf.size() != oneImg)
-			return Helper::INVALID_IMAGE_SIZE;
+		List<Helper::ErrorMessage> errors(count);
+		std::atomic<usz> firstError = count;
 
-		std::memcpy(out.data() + (usz(layer) * size[3] + z) * oneImg, buf.data(), oneImg);
-		return Helper::SUCCESS;
+		parallelFor(count, threads, [&](usz i) {
+
+			if (i > firstError.load(std::memory_order_relaxed))
+				return;
+
+			const Helper::FileDesc &file = files[i];
+			Helper::ErrorMessage &msg = errors[i];
+
+			if (!file.path.empty())
+				msg = probe(file.path, flags, infos[i]);
+
+			else if (!old || old->data.empty())
+				msg = old ? Helper::INVALID_FILE_DATA : Helper::INVALID_FILE_PATH;
+
+			else for (const List<Buffer> &elem : old->data) {
+
+				if (file.iid.layer >= elem.size()) {
+					msg = Helper::INVALID_RESOURCE_INDEX;
+					continue;
+				}
+
+				if ((msg = probe(elem[file.iid.layer].data(), elem[file.iid.layer].size(), flags, infos[i])) == Helper::SUCCESS)
+					break;
+			}
+
+			if (msg)
+				atomicMin(firstError, i);
+		});
+
+		return firstError != count ? errors[firstError] : Helper::SUCCESS;
+	}
+
+	Helper::ErrorMessage Helper::probe(const List<FileDesc> &descs, List<ImageInfo> &infos, Flags flags, u32 threads) {
+		return igxi::probe(descs, nullptr, flags, infos, threads);
 	}
 
-	inline Helper::ErrorMessage insertInto(
-		IGXI &out, const Buffer &buf, u16 format, u16 z, u16 layer, u16 mip, const Array<u16, 5> &size
+	//Get the memory of an image (z, layer) in a mip of our target
+
+	inline Helper::ErrorMessage getSubresource(
+		IGXI &out, u16 format, u16 z, u16 layer, u16 mip, const Array<u16, 5> &size, usz imageSize, u8 *&target
 	) {
 
 		if (format >= out.header.formats || mip >= out.header.mips)
 			return Helper::INVALID_RESOURCE_INDEX;
 
-		return insertInto(out.data[format][mip], buf, z, layer, out.header, size);
+		if (layer >= size[4] || z >= size[3])
+			return Helper::INVALID_RESOURCE_INDEX;
+
+		usz oneImg = usz(size[2]) * size[1] * size[0];
+
+		if(imageSize != oneImg)
+			return Helper::INVALID_IMAGE_SIZE;
+
+		target = out.data[format][mip].data() + (usz(layer) * size[3] + z) * oneImg;
+		return Helper::SUCCESS;
 	}
 
 	//Convert to a valid IGXI file
 
-	Helper::ErrorMessage Helper::convert(IGXI &out, const List<FileDesc> &files, Flags flags) {
+	Helper::ErrorMessage Helper::convert(
+		IGXI &out, const List<FileDesc> &files, Flags flags, f32 quality, u32 threads, DecodeCache *cache
+	) {
 
 		if(files.empty())
 			return MISSING_PATHS;
 
-		//Get type
+		TextureType type;
+
+		if (ErrorMessage msg = getType(flags, type))
+			return msg;
+
+		GPUMemoryUsage usage = getUsage(flags);
+
+		//Get other dimensions than x & y
+
+		u16 length{}, layers{}, mips{};
+
+		for (const FileDesc &desc : files) {
+
+			if (desc.iid.z == 0xFFFF || desc.iid.layer == 0xFFFF || desc.iid.mip == 0xFF)
+				return INVALID_RESOURCE_INDEX;
+
+			length = std::max(length, u16(desc.iid.z + 1));
+			layers = std::max(layers, u16(desc.iid.layer + 1));
+			mips = std::max(mips, u16(desc.iid.mip + 1));
+		}
+
+		//Check for missing resource indices
+
+		if (flags & GENERATE_MIPS && mips != 1)
+			return TOO_MANY_MIPS;
+
+		u16 checkMipCount = flags & GENERATE_MIPS ? 1 : mips;
+
+		//Every subresource needs exactly one file; if there are more subresources than files, some are missing
+		//Otherwise, mark every subresource in a bitmap (ordered by mip, layer, z) to find duplicates and holes
+
+		u64 subresources = u64(length) * layers * checkMipCount;
+
+		if (subresources > files.size())
+			return MISSING_RESOURCE_INDEX;
+
+		List<u64> occupied(usz((subresources + 63) / 64));
+
+		for (const FileDesc &desc : files) {
+
+			u64 i = (u64(desc.iid.mip) * layers + desc.iid.layer) * length + desc.iid.z;
+			u64 bit = u64(1) << (i & 63);
+
+			if (occupied[usz(i >> 6)] & bit)
+				return CONFLICTING_RESOURCE_INDEX;
+
+			occupied[usz(i >> 6)] |= bit;
+		}
+
+		//No duplicates and at least as many subresources as files, so all of them are there
+
+		//Every file is a whole cube, so they each make 6 layers
+
+		const bool fromImage = flags & CUBE_FROM_IMAGE;
+
+		if (fromImage) {
+
+			if (!(flags & IS_CUBE) || length != 1)
+				return INVALID_TYPE;
+
+			if (u32(layers) * 6 >= 0xFFFF)
+				return INVALID_RESOURCE_INDEX;
+
+			layers = u16(layers * 6);
+		}
+
+		//Every file is a sequence of frames, which become its layers (or slices with IS_3D)
+		//How many is only known once the files are probed
+
+		const bool fromFrames = flags & FRAMES_FROM_IMAGE;
+
+		if (fromFrames && (flags & IS_CUBE || !(flags & (IS_ARRAY | IS_3D))))
+			return INVALID_TYPE;
+
+		u16 frames = 1, layersPerFile = fromImage ? 6 : 1, slicesPerFile = 1;
+
+		auto firstLayer = [&layersPerFile](const FileDesc &file) -> u16 {
+			return u16(file.iid.layer * layersPerFile);
+		};
+
+		if (flags & IS_CUBE && layers % 6)
+			return MISSING_FACE;
+
+		//Output data
+		//The input is only needed for files without a path, so it's moved out instead of copied
+
+		IGXI old = std::move(out);
+
+		out = {};
+		out.header.flags = IGXI::Flags::CONTAINS_DATA;
+		out.header.formats = 1;
+		out.header.usage = usage;
+		out.header.type = type;
+		out.header.length = length;
+		out.header.layers = layers;
+		out.header.mips = u8(mips);
+
+		//Images bigger than MAX_SIZE_* are downscaled while loading
+		//If the base mip is, the mips that are loaded are resampled to fit it
+
+		const u32 maxSize = getMaxSize(flags);
+
+		ResampleFilter resizeFilter;
+
+		if (ErrorMessage msg = getResampleFilter(flags, resizeFilter))
+			return msg;
+
+		if (resizeFilter == ResampleFilter::NONE)
+			resizeFilter = ResampleFilter::MITCHELL;
+
+		bool resized{};
+
+		List<Array<u16, 5>> sizes;
+
+		//Get the size of a file in the IGXI from the size it's decoded as
+		//Whole cubes also get the size of the image their faces are taken from (after resizing)
+
+		auto fit = [&](
+			const FileDesc &file, u16 &x, u16 &y, u16 &imageX, u16 &imageY, CubeLayout &layout
+		) -> ErrorMessage {
+
+			if (fromImage) {
+
+				layout = getCubeLayout(x, y);
+
+				if (layout == CubeLayout::NONE)
+					return INVALID_IMAGE_SIZE;
+
+				//The faces are clamped, so the image is scaled to a multiple of the max size
+
+				u16 face = getCubeFaceSize(layout, x, y);
+
+				if (maxSize && face > maxSize) {
+					x = u16(std::lround(f64(x) / face) * maxSize);
+					y = u16(std::lround(f64(y) / face) * maxSize);
+				}
+
+				imageX = x;
+				imageY = y;
+				x = y = getCubeFaceSize(layout, x, y);
+			}
+
+			else if (maxSize && !file.iid.mip && std::max(x, y) > maxSize) {
+				f64 scale = f64(maxSize) / std::max(x, y);
+				x = u16(std::max(std::lround(x * scale), 1l));
+				y = u16(std::max(std::lround(y * scale), 1l));
+			}
+
+			else if (resized && file.iid.mip && file.iid.mip < sizes.size()) {
+				x = sizes[file.iid.mip][1];
+				y = sizes[file.iid.mip][2];
+			}
+
+			return SUCCESS;
+		};
+
+		//Probe the headers of all files first
+		//Files that don't fit are then found before anything is decoded and the IGXI is allocated once
+
+		List<ImageInfo> infos;
+
+		if (ErrorMessage msg = igxi::probe(files, &old, flags, infos, threads))
+			return msg;
+
+		//Spread the frames over the layers or slices; the frames of a file are consecutive
+
+		if (fromFrames) {
+
+			frames = infos[0].frames;
+
+			for (const ImageInfo &info : infos)
+				if (info.frames != frames)
+					return CONFLICTING_IMAGE_SIZE;
+
+			//Mips of a 3D texture have less slices, so a loaded mip can't have the same frames
+
+			if (flags & IS_3D && mips > 1 && frames > 1)
+				return INVALID_OPERATION;
+
+			u16 &perFile = flags & IS_3D ? slicesPerFile : layersPerFile;
+			u16 &total = flags & IS_3D ? length : layers;
+
+			if (u32(total) * frames >= 0xFFFF)
+				return INVALID_RESOURCE_INDEX;
+
+			perFile = frames;
+			total = u16(total * frames);
+
+			out.header.length = length;
+			out.header.layers = layers;
+		}
+
+		//The base mip decides the size and format of the IGXI
+		//Every subresource has exactly one file (see above), so there is one for mip 0
+
+		usz base{};
+
+		while (files[base].iid.mip)
+			++base;
+
+		const ImageInfo &baseInfo = infos[base];
+		const GPUFormat format = baseInfo.format;
+
+		u16 width = baseInfo.width, height = baseInfo.height;
+
+		{
+			u16 imageX{}, imageY{};
+			CubeLayout layout;
+
+			if (ErrorMessage msg = fit(files[base], width, height, imageX, imageY, layout))
+				return msg;
+
+			resized = fromImage ?
+				imageX != baseInfo.width || imageY != baseInfo.height :
+				width != baseInfo.width || height != baseInfo.height;
+		}
+
+		if (resized && !canResample(format))
+			return INVALID_FORMAT;
+
+		//Generated mips go all the way down to 1x1x1
+
+		if (flags & GENERATE_MIPS)
+			mips = getMipCount(width, height, length);
+
+		sizes.resize(mips);
+
+		u16 stride = u16(FormatHelper::getSizeBytes(format));
+		u16 mx = width, my = height, mz = length;
+
+		for (Array<u16, 5> &size : sizes) {
+
+			size = { stride, mx, my, mz, layers };
+
+			mz = u16(std::ceil(f64(mz) / 2));
+			my = u16(std::ceil(f64(my) / 2));
+			mx = u16(std::ceil(f64(mx) / 2));
+		}
+
+		//Every file has to fit its subresource
+
+		for (usz i = 0; i < files.size(); ++i) {
+
+			const FileDesc &file = files[i];
+			const ImageInfo &info = infos[i];
+
+			u16 x = info.width, y = info.height, imageX{}, imageY{};
+			CubeLayout layout;
+
+			if (ErrorMessage msg = fit(file, x, y, imageX, imageY, layout))
+				return msg;
+
+			if (x != sizes[file.iid.mip][1] || y != sizes[file.iid.mip][2])
+				return CONFLICTING_IMAGE_SIZE;
+
+			if (info.format != format)
+				return CONFLICTING_IMAGE_FORMAT;
+		}
+
+		//If the result is compressed, layers are processed in batches (one layer per thread);
+		//	a batch is decoded, mipped and compressed before the next one reuses its memory
+		//	so only one batch is ever kept uncompressed
+		//With KEEP_UNCOMPRESSED, every layer is kept uncompressed anyway, so it isn't split
+
+		bool streaming{};
+		u16 batchLayers = layers, batchStart{};
+
+		if (
+			flags & DO_COMPRESSION && !(flags & KEEP_UNCOMPRESSED) && 
+			!getCompressionTargets(format, flags, quality, true).empty()
+		) {
+
+			batchLayers = u16(getThreadCount(threads, layers));
+
+			//Cubes from one image can't be split over batches and neither can prefiltered cubes
+			//The frames of a file are decoded at once, so they can't be split either
+
+			if (fromImage || flags & MIP_GGX)
+				batchLayers = u16(std::min((batchLayers + 5) / 6 * 6, i32(layers)));
+
+			else if (layersPerFile > 1)
+				batchLayers = u16(std::min(
+					(u32(batchLayers) + layersPerFile - 1) / layersPerFile * layersPerFile, u32(layers)
+				));
+
+			streaming = batchLayers < layers;
+		}
+
+		//Allocate the IGXI (or the first batch of it)
+
+		out.header.width = width;
+		out.header.height = height;
+		out.header.mips = u8(mips);
+
+		out.format = { format };
+		out.data.resize(1);
+		out.data[0].resize(mips);
+
+		for (usz mip = 0; mip < mips; ++mip) {
+			Array<u16, 5> &size = sizes[mip];
+			size[4] = batchLayers;
+			out.data[0][mip].resize(usz(size[4]) * size[3] * size[2] * size[1] * stride);
+		}
+
+		//Process files
+		//Every file is decoded into its own slice of out.data[0], so they are decoded in parallel
+		//The threads are spread over the files, unless a batch only has one (innerThreads)
+
+		u32 innerThreads = 1;
+
+		auto process = [&](usz i) -> ErrorMessage {
+
+			const FileDesc &file = files[i];
+
+			//Whole cubes are decoded into a temporary buffer first and then split into faces
+			//Images that are downscaled are decoded into a temporary buffer (one per frame) and resampled into their target after
+
+			Buffer image, decoded;
+			CubeLayout layout = CubeLayout::NONE;
+			u16 imageX{}, imageY{}, decodedX{}, decodedY{}, resizeX{}, resizeY{};
+			List<u8*> resizeTargets;
+
+			auto getTarget = [&](u16 x, u16 y, GPUFormat decodedFormat, u16 frame, u8 *&target) -> ErrorMessage {
+
+				decodedX = x;
+				decodedY = y;
+
+				if (frame >= frames)
+					return INVALID_RESOURCE_INDEX;
+
+				if (ErrorMessage msg = fit(file, x, y, imageX, imageY, layout))
+					return msg;
+
+				//Already checked by the probe, unless the file changed since
+
+				if (x != sizes[file.iid.mip][1] || y != sizes[file.iid.mip][2])
+					return CONFLICTING_IMAGE_SIZE;
+
+				if (decodedFormat != format)
+					return CONFLICTING_IMAGE_FORMAT;
+
+				u16 z = u16(file.iid.z * slicesPerFile), layer = u16(firstLayer(file) - batchStart);
+
+				(flags & IS_3D ? z : layer) += frame;
+
+				ErrorMessage msg = getSubresource(
+					out, 0, z, layer, file.iid.mip, sizes[file.iid.mip], usz(x) * y * stride, target
+				);
+
+				if (msg)
+					return msg;
+
+				//The faces are the 6 layers after the first (which can't be out of bounds, since batches are a multiple of 6)
+
+				if (fromImage) {
+					image.resize(usz(imageX) * imageY * stride);
+					target = image.data();
+				}
+
+				resizeX = fromImage ? imageX : x;
+				resizeY = fromImage ? imageY : y;
+
+				if (resizeX == decodedX && resizeY == decodedY)
+					return SUCCESS;
+
+				usz decodedSize = usz(decodedX) * decodedY * stride;
+
+				resizeTargets.resize(frames);
+				resizeTargets[frame] = target;
+
+				decoded.resize(decodedSize * frames);
+				target = decoded.data() + decodedSize * frame;
+				return SUCCESS;
+			};
+
+			//Resample the decoded image into its target and split whole cubes into faces
+
+			auto finish = [&](ErrorMessage msg) -> ErrorMessage {
+
+				if (msg)
+					return msg;
+
+				usz decodedSize = usz(decodedX) * decodedY * stride;
+
+				for (usz frame = 0; frame < resizeTargets.size(); ++frame)
+					if (resizeTargets[frame])
+						if (ErrorMessage err = resample(
+							decoded.data() + decodedSize * frame, decodedX, decodedY, resizeTargets[frame], resizeX, resizeY,
+							format, resizeFilter, innerThreads
+						))
+							return err;
+
+				if (!fromImage)
+					return SUCCESS;
+
+				u8 *faces{};
+
+				if (ErrorMessage err = getSubresource(
+					out, 0, 0, u16(firstLayer(file) - batchStart), file.iid.mip, sizes[file.iid.mip], 
+					usz(sizes[file.iid.mip][1]) * sizes[file.iid.mip][2] * sizes[file.iid.mip][0], faces
+				))
+					return err;
+
+				return toCube(image.data(), imageX, imageY, format, layout, faces, innerThreads);
+			};
+
+			if (file.path.empty()) {
+
+				//Attempt to load one of multiple specified external formats
+				//(like HDR or PNG can both be supplied, 
+				//but if the flags doesn't support one of them it will pick the other)
+
+				if (old.data.empty())
+					return Helper::INVALID_FILE_DATA;
+
+				Helper::ErrorMessage last = Helper::SUCCESS;
+
+				for(auto &elem : old.data)
+					if ((last = load(elem[file.iid.layer].data(), elem[file.iid.layer].size(), flags, getTarget, cache)) == Helper::SUCCESS)
+						break;
+
+				return finish(last);
+			}
+
+			//Attemp to load from file
+
+			return finish(load(file.path, flags, getTarget, cache));
+		};
+
+		//Only the earliest error (by file order) of a batch is reported,
+		//so files after one that failed don't have to be decoded anymore
+
+		usz count = files.size();
+
+		List<ErrorMessage> errors(count);
+		List<usz> batch;
+
+		//Compressed formats and their data for all layers; filled in batch by batch
+
+		List<CompressedFormat> targets;
+		List<GPUFormat> targetFormats;
+		List<List<Buffer>> compressed;
+
+		//Alpha only has to be checked if it changes the targets (BC1 or BC3) and then it has to be checked for every batch
+
+		bool alpha{};
+		bool checkAlpha = 
+			flags & DO_COMPRESSION && 
+			getCompressionTargets(format, flags, quality, false) != getCompressionTargets(format, flags, quality, true);
+
+		usz batches = (layers + batchLayers - 1) / batchLayers;
+
+		for (usz j = 0; j < batches; ++j) {
+
+			batchStart = u16(j * batchLayers);
+			u16 batchEnd = u16(std::min(usz(batchStart) + batchLayers, usz(layers)));
+
+			batch.clear();
+
+			for (usz i = 0; i < count; ++i)
+				if (firstLayer(files[i]) >= batchStart && firstLayer(files[i]) < batchEnd)
+					batch.push_back(i);
+
+			innerThreads = batch.size() == 1 ? threads : 1;
+
+			std::atomic<usz> firstError = count;
+
+			parallelFor(batch.size(), threads, [&](usz b) {
+
+				usz i = batch[b];
+
+				if (i > firstError.load(std::memory_order_relaxed))
+					return;
+
+				if ((errors[i] = process(i)) != SUCCESS)
+					atomicMin(firstError, i);
+			});
+
+			if (firstError != count)
+				return errors[firstError];
+
+			//Generate mips from the decoded base mip
+
+			out.header.layers = u16(batchEnd - batchStart);
+
+			if (flags & GENERATE_MIPS)
+				if (ErrorMessage msg = generateMips(out, 0, flags, threads))
+					return msg;
+
+			if (!(flags & DO_COMPRESSION))
+				continue;
+
+			//Compress into every requested format (BC and/or ASTC) from the same mips
+			//If a later batch is the first to use alpha, the batches before it were compressed without;
+			//	so they're decoded and compressed again (j wraps around to 0)
+
+			if (checkAlpha && !alpha && usesAlpha(out)) {
+
+				alpha = true;
+
+				if (j) {
+					targets.clear();
+					targetFormats.clear();
+					compressed.clear();
+					j = usz(-1);
+					continue;
+				}
+			}
+
+			if (!j) {
+
+				targets = getCompressionTargets(out.format[0], flags, quality, alpha);
+
+				for (CompressedFormat target : targets)
+					targetFormats.push_back(getGPUFormat(target));
+			}
+
+			if (targets.empty())
+				continue;
+
+			List<List<Buffer>> data;
+
+			if (ErrorMessage msg = compress(out, 0, targets, quality, data, threads))
+				return msg;
+
+			if (!streaming) {
+				compressed = std::move(data);
+				continue;
+			}
+
+			//Every layer of a mip has the same size, so the batch can be placed at its first layer
+
+			if (!j) {
+
+				compressed.resize(targets.size());
+
+				for (usz t = 0; t < targets.size(); ++t) {
+
+					compressed[t].resize(mips);
+
+					for (usz mip = 0; mip < mips; ++mip)
+						compressed[t][mip].resize(data[t][mip].size() / out.header.layers * layers);
+				}
+			}
+
+			for (usz t = 0; t < targets.size(); ++t)
+				for (usz mip = 0; mip < mips; ++mip) {
+
+					usz layerSize = compressed[t][mip].size() / layers;
+
+					std::memcpy(
+						compressed[t][mip].data() + layerSize * batchStart,
+						data[t][mip].data(), data[t][mip].size()
+					);
+				}
+		}
+
+		out.header.layers = layers;
+
+		//Replace the uncompressed staging memory by the compressed formats (or add them after it)
+
+		if (!targets.empty()) {
+
+			if (flags & KEEP_UNCOMPRESSED) {
+				out.format.insert(out.format.end(), targetFormats.begin(), targetFormats.end());
+				out.data.insert(
+					out.data.end(), std::make_move_iterator(compressed.begin()), std::make_move_iterator(compressed.end())
+				);
+			}
+
+			else {
+				out.format = std::move(targetFormats);
+				out.data = std::move(compressed);
+			}
+
+			out.header.formats = u16(out.format.size());
+		}
+
+		return SUCCESS;
+	}
+
+	//Parse descs by paths
+
+	Helper::ErrorMessage Helper::convert(IGXI &out, const List<String> &paths, Flags flags, f32 quality, u32 threads) {
+
+		//DDS and KTX2 files already contain every subresource, so they can't be combined with other files
+
+		for (const String &path : paths)
+			if (isContainerExtension(std::filesystem::path(path).extension().string()))
+				return paths.size() == 1 ? convertContainer(out, path, flags, threads) : INVALID_OPERATION;
+
+		usz j = paths.size();
+		List<FileDesc> files(j);
+
+		enum Index : u8 { SIDE, SAMPLE, SLICE, SIZE };
+
+		using Indices = Array<u16, SIZE>;
+
+		List<Indices> indices(j);
+		Indices max{};
+
+		//A cube always has 6 sides, even if some are missing
+		//Unless every file is a whole cube
+
+		if (flags & IS_CUBE && !(flags & CUBE_FROM_IMAGE))
+			max[SIDE] = 6;
+
+		for (usz i = 0; i < j; ++i) {
+
+			FileDesc &f = files[i];
+			f.path = paths[i];
+
+			ParsedFileName parsed;
+
+			if (ErrorMessage msg = parseFileName(f.path, flags, parsed))
+				return msg;
+
+			f.iid.z = parsed.z;
+			f.iid.mip = parsed.mip;
+
+			Indices &index = indices[i] = { parsed.side, parsed.sample, parsed.slice };
+
+			for (u8 k = 0; k < SIZE; ++k)
+				max[k] = std::max(u16(index[k] + 1), max[k]);
+		}
+
+		for (usz i = 0; i < j; ++i) {
+
+			auto &idx = indices[i];
+
+			auto layer = (u64(idx[SLICE]) * max[SAMPLE] + idx[SAMPLE]) * max[SIDE] + idx[SIDE];
+
+			if(layer >= 0xFFFF)
+				return INVALID_RESOURCE_INDEX;
+
+			files[i].iid.layer = u16(layer);
+		}
+
+		return convert(out, files, flags, quality, threads);
+	}
+
+	//Find paths similar to the input path; the directory is only listed once
+
+	Helper::ErrorMessage Helper::convert(IGXI &out, const FileIndex &index, const String &name, Flags flags, f32 quality, u32 threads) {
+
+		List<String> files;
+		
+		if (ErrorMessage msg = index.find(name, flags, files))
+			return msg;
+
+		return convert(out, files, flags, quality, threads);
+	}
 
-		TextureType type;
+	Helper::ErrorMessage Helper::convert(IGXI &out, const String &path, Flags flags, f32 quality, u32 threads) {
 
-		switch (flags & PROPERTY_TYPE) {
+		std::filesystem::path fsPath(path);
 
-			case 0:			type = TextureType::TEXTURE_2D;		break;
-			case IS_2D:		type = TextureType::TEXTURE_2D;		break;
-			case IS_CUBE:	type = TextureType::TEXTURE_CUBE;	break;
-			case IS_1D:		type = TextureType::TEXTURE_1D;		break;
-			case IS_3D:		type = TextureType::TEXTURE_3D;		break;
+		if (isContainerExtension(fsPath.extension().string()))
+			return convertContainer(out, path, flags, threads);
 
-			case IS_MS | IS_2D:
-			case IS_MS:		type = TextureType::TEXTURE_MS;		break;
+		FileIndex index(fsPath.parent_path().string());
+		return convert(out, index, fsPath.filename().string(), flags, quality, threads);
+	}
 
-			default:		return INVALID_TYPE;
-		}
+	//Raw data
 
+	//Get the format raw texels are converted to; the format flags override the parts of the input format they set
 
-		if (flags & IS_ARRAY) {
-			if (flags & IS_3D)	return INVALID_TYPE;
-			else				type = TextureType(u8(type) | u8(TextureType::PROPERTY_IS_ARRAY));
-		}
+	inline Helper::ErrorMessage getRawFormat(Helper::Flags flags, GPUFormat input, GPUFormat &format) {
 
-		//Get usage
+		format = input;
 
-		GPUMemoryUsage usage{};
+		if (!(flags & (Helper::PROPERTY_CHANNELS | Helper::PROPERTY_PRIMTIIVE | Helper::PROPERTY_BITS | Helper::IS_SRGB)))
+			return Helper::SUCCESS;
 
-		if (flags & MEMORY_SHARED)
-			usage = GPUMemoryUsage::SHARED;
+		int channelCount;
 
-		if (flags & MEMORY_PREFER)
-			usage |= GPUMemoryUsage::PREFER;
+		if (Helper::ErrorMessage msg = getChannelCount(flags, channelCount))
+			return msg;
 
-		if (flags & MEMORY_CPU_READ)
-			usage |= GPUMemoryUsage::CPU_READ;
+		if (!channelCount)
+			channelCount = int(FormatHelper::getChannelCount(input));
 
-		if (flags & MEMORY_CPU_WRITE)
-			usage |= GPUMemoryUsage::CPU_WRITE;
+		//Get primitive
 
-		if (flags & MEMORY_GPU_WRITE)
-			usage |= GPUMemoryUsage::GPU_WRITE;
+		GPUFormatType primitive;
 
-		//Get other dimensions than x & y
+		switch (flags & Helper::PROPERTY_PRIMTIIVE) {
 
-		u16 length{}, layers{}, mips{};
+			case 0: primitive = FormatHelper::getType(input); break;
 
-		for (const FileDesc &desc : files) {
+			case Helper::IS_SINT: primitive = GPUFormatType::SINT; break;
+			case Helper::IS_UINT: primitive = GPUFormatType::UINT; break;
+			case Helper::IS_UNORM: primitive = GPUFormatType::UNORM; break;
+			case Helper::IS_SNORM: primitive = GPUFormatType::SNORM; break;
+			case Helper::IS_FLOAT: primitive = GPUFormatType::FLOAT; break;
 
-			if (desc.iid.z == 0xFFFF || desc.iid.layer == 0xFFFF || desc.iid.mip == 0xFFF)
-				return INVALID_RESOURCE_INDEX;
+			default: return Helper::INVALID_PRIMITIVE;
 
-			length = std::max(length, u16(desc.iid.z + 1));
-			layers = std::max(layers, u16(desc.iid.layer + 1));
-			mips = std::max(mips, u16(desc.iid.mip + 1));
 		}
 
-		//Check for missing resource indices
-
-		if (flags & GENERATE_MIPS && mips != 1)
-			return TOO_MANY_MIPS;
+		//Get bits
 
-		u16 checkMipCount = flags & GENERATE_MIPS ? 1 : mips;
+		usz bytes;
 
-		for (u64 i = 0; i < u64(length) * layers * checkMipCount; ++i) {
+		switch (flags & Helper::PROPERTY_BITS) {
 
-			u16 z = u16(i % length);
-			u16 l = u16(i / length % layers);
-			u16 m = u16(i / length / layers);
+			case 0: bytes = FormatHelper::getStrideBytes(input); break;
 
-			bool contains{};
+			case Helper::IS_8_BIT: bytes = 1; break;
+			case Helper::IS_16_BIT: bytes = 2; break;
+			case Helper::IS_32_BIT: bytes = 4; break;
+			case Helper::IS_64_BIT: bytes = 8; break;
 
-			for(const FileDesc &desc : files)
-				if (desc.iid.mip == m && desc.iid.layer == l && desc.iid.z == z) {
-					contains = true;
-					break;
-				}
+			default: return Helper::INVALID_BITS;
 
-			if (!contains)
-				return MISSING_RESOURCE_INDEX;
 		}
 
-		if (flags & IS_CUBE && layers % 6)
-			return MISSING_FACE;
+		//Get format
 
-		//Output data
+		format = GPUFormat::NONE;
 
-		IGXI old = out;
+		if (flags & Helper::IS_SRGB) {
 
-		out = {};
-		out.header.flags = IGXI::Flags::CONTAINS_DATA;
-		out.header.formats = 1;
-		out.header.usage = usage;
-		out.header.type = type;
-		out.header.length = length;
-		out.header.layers = layers;
-		out.header.mips = u8(mips);
+			if (bytes == 1 && channelCount == 4)
+				format = GPUFormat::srgba8;
 
-		//Process files
+		} else if (bytes && channelCount > 0 && channelCount <= 4)
+			format = GPUFormat(u16((channelCount - 1) | ((bytes - 1) << 2) | (u8(primitive) << 4)));
 
-		bool isFirst = true;
+		if (GPUFormat::idByValue(format.value) >= GPUFormat::idByValue(GPUFormat::NONE))
+			return Helper::INVALID_FORMAT;
 
-		List<Array<u16, 5>> sizes;
+		return Helper::SUCCESS;
+	}
 
-		for (const FileDesc &file : files) {
+	Helper::ErrorMessage Helper::convertRaw(
+		IGXI &out, const String &path, const RawDesc &desc, Flags flags, f32 quality, u32 threads
+	) {
 
-			List<Buffer> fileData;
+		TextureType type;
 
-			u16 x{}, y{};
-			GPUFormat format = GPUFormat::NONE;
+		if (ErrorMessage msg = getType(flags, type))
+			return msg;
 
-			if (file.path.empty()) {
+		//Raw data is only one image per slice, it can't be split into cubes or frames or be downscaled
 
-				//Attempt to load one of multiple specified external formats
-				//(like HDR or PNG can both be supplied, 
-				//but if the flags doesn't support one of them it will pick the other)
+		if (flags & (CUBE_FROM_IMAGE | FRAMES_FROM_IMAGE | PROPERTY_MAX_SIZE))
+			return INVALID_OPERATION;
 
-				if (old.data.empty())
-					return Helper::INVALID_FILE_DATA;
+		if (flags & IS_MS)
+			return INVALID_TYPE;
 
-				Helper::ErrorMessage last = Helper::SUCCESS;
+		//Slices are z for 3D textures and layers otherwise; both are stored after each other
 
-				for(auto &elem : old.data)
-					if (
-						(last = 
-							load(
-								fileData, elem[file.iid.layer], 
-								file.iid.mip, flags & GENERATE_MIPS ? mips :  1, 
-								flags, x, y, format, sizes
-							)
-						) == Helper::SUCCESS
-					)
-						break;
+		const bool is3D = flags & IS_3D;
 
-				if (last != Helper::SUCCESS)
-					return last;
+		if (!desc.width || !desc.height || !desc.length)
+			return INVALID_IMAGE_SIZE;
 
-			}
+		if (desc.width == u16_MAX || desc.height == u16_MAX || desc.length == u16_MAX)
+			return INVALID_IMAGE_SIZE;
 
-			//Attemp to load from file
+		if (flags & IS_1D && desc.height != 1)
+			return INVALID_IMAGE_SIZE;
 
-			else if (ErrorMessage msg = load(
-				fileData, 
-				file.iid.mip, flags & GENERATE_MIPS ? mips : 1, 
-				file.path,
-				flags, x, y, format, sizes
-			))
-				return msg;
+		if (!is3D && desc.length > 1 && !(flags & (IS_ARRAY | IS_CUBE)))
+			return INVALID_TYPE;
 
-			if (isFirst) {
+		if (flags & IS_CUBE && desc.length % 6)
+			return MISSING_FACE;
 
-				isFirst = false;
-				out.header.width = x;
-				out.header.height = y;
+		//Pick the kernel once, if the texels have to be converted
 
-				out.format = { format };
-				out.data.resize(1);
-				out.data[0].resize(mips);
+		GPUFormat format;
 
-				u16 mip{};
+		if (ErrorMessage msg = getRawFormat(flags, desc.format, format))
+			return msg;
 
-				u16 stride = u16(FormatHelper::getSizeBytes(format));
-				u16 z = length;
+		usz inStride = FormatHelper::getSizeBytes(desc.format);
+		usz outStride = FormatHelper::getSizeBytes(format);
 
-				for (Buffer &b : out.data[0]) {
+		if (!inStride || !outStride)
+			return INVALID_FORMAT;
 
-					b.resize(layers * z * y * x * stride);
+		ConversionKernel kernel{};
 
-					sizes[mip] = { stride, x, y, z, layers };
+		if (format != desc.format) {
 
-					z = u16(std::ceil(f64(z) / 2));
-					y = u16(std::ceil(f64(y) / 2));
-					x = u16(std::ceil(f64(x) / 2));
-					++mip;
-				}
+			kernel = canConvert(format, desc.format) ? 
+				getConversionKernel(
+					format, desc.format, FormatHelper::getChannelCount(format), FormatHelper::getChannelCount(desc.format)
+				) : nullptr;
 
-			} else if (x != out.header.width || y != out.header.height)
-				return CONFLICTING_IMAGE_SIZE;
+			if (!kernel)
+				return INCOMPATIBLE_FORMATS;
+		}
 
-			else if(format != out.format[0])
-				return CONFLICTING_IMAGE_FORMAT;
+		//The whole desc has to be in the file
 
-			u16 mip{};
+		usz rowSize = usz(desc.width) * inStride;
+		usz rowPitch = desc.rowPitch ? desc.rowPitch : rowSize;
 
-			for (const Buffer &buf : fileData)
-				if (ErrorMessage msg = insertInto(out, buf, 0, file.iid.z, file.iid.layer, file.iid.mip + mip, sizes[mip]))
-					return msg;
-				else 
-					++mip;
-		}
+		if (rowPitch < rowSize)
+			return INVALID_IMAGE_SIZE;
 
-		//Compress
+		usz slicePitch = rowPitch * desc.height;
+		usz end = desc.offset + slicePitch * (desc.length - 1) + rowPitch * (desc.height - 1) + rowSize;
 
-		if (flags & DO_COMPRESSION) {
-			//TODO: Set format to compressed formats
-			//TODO: Convert everytime a FULL layer is added to minimize memory usage
-		}
+		MappedFile file(path);
 
-		return SUCCESS;
-	}
+		if (!file.data())
+			return INVALID_FILE_PATH;
 
-	//Parse descs by paths
+		if (end > file.size() || desc.offset >= file.size())
+			return INVALID_FILE_BOUNDS;
 
-	//TODO: Doesn't work yet! Implement
+		//Allocate the IGXI once
 
-	static Helper::ErrorMessage findSide(const String&, Helper::Flags, u16&) { return Helper::INVALID_OPERATION; }
-	static Helper::ErrorMessage findSample(const String&, Helper::Flags, u16&) { return Helper::INVALID_OPERATION; }
-	static Helper::ErrorMessage findZ(const String&, Helper::Flags, u16&) { return Helper::INVALID_OPERATION; }
-	static Helper::ErrorMessage findSlice(const String&, Helper::Flags, u16&) { return Helper::INVALID_OPERATION; }
-	static Helper::ErrorMessage findMip(const String&, Helper::Flags, u8&) { return Helper::INVALID_OPERATION; }
+		u16 length = is3D ? desc.length : 1, layers = is3D ? 1 : desc.length;
+		u16 mips = flags & GENERATE_MIPS ? getMipCount(desc.width, desc.height, length) : 1;
 
-	static Helper::ErrorMessage findFiles(const String&, Helper::Flags, List<String>&) { return Helper::INVALID_OPERATION; }
+		out = {};
+		out.header.flags = IGXI::Flags::CONTAINS_DATA;
+		out.header.formats = 1;
+		out.header.usage = getUsage(flags);
+		out.header.type = type;
+		out.header.width = desc.width;
+		out.header.height = desc.height;
+		out.header.length = length;
+		out.header.layers = layers;
+		out.header.mips = u8(mips);
 
-	Helper::ErrorMessage Helper::convert(IGXI &out, const List<String> &paths, Flags flags) {
+		out.format = { format };
+		out.data = { List<Buffer>(mips) };
 
-		usz j = paths.size();
-		List<FileDesc> files(j);
+		u16 mx = desc.width, my = desc.height, mz = length;
 
-		//usz sliceMultiplier = flags & IS_CUBE ? 6 : 1;
+		for (Buffer &mip : out.data[0]) {
 
-		enum Index : u8 { SIDE, SAMPLE, SLICE, SIZE };
+			mip.resize(usz(layers) * mz * my * mx * outStride);
 
-		using Indices = Array<u16, SIZE>;
+			mz = u16(std::ceil(f64(mz) / 2));
+			my = u16(std::ceil(f64(my) / 2));
+			mx = u16(std::ceil(f64(mx) / 2));
+		}
 
-		List<Indices> indices(j);
-		Indices max{};
+		//Copy bands of rows straight from the mapped file into mip 0
+		//The bands are spread over the threads, so the pages of the file are read in parallel
+		//Without a row pitch or conversion, a band is one memcpy
 
-		for (usz i = 0; i < j; ++i) {
+		constexpr usz band = 64;
 
-			FileDesc &f = files[i];
-			f.path = paths[i];
+		usz outRow = usz(desc.width) * outStride;
+		usz bands = (usz(desc.height) + band - 1) / band;
 
-			auto &index = indices[i];
+		const u8 *src = file.data() + desc.offset;
+		u8 *dst = out.data[0][0].data();
 
-			if (flags & IS_CUBE)
-				if (ErrorMessage msg = findSide(f.path, flags, index[SIDE]))
-					return msg;
+		parallelFor(bands * desc.length, threads, [&](usz i) {
 
-			if (flags & IS_MS)
-				if (ErrorMessage msg = findSample(f.path, flags, index[SAMPLE]))
-					return msg;
+			usz z = i / bands, y0 = i % bands * band, y1 = std::min(y0 + band, usz(desc.height));
 
-			if (flags & IS_3D)
-				if (ErrorMessage msg = findZ(f.path, flags, f.iid.z))
-					return msg;
+			const u8 *slice = src + slicePitch * z;
+			u8 *target = dst + outRow * desc.height * z;
 
-			if (flags & IS_ARRAY)
-				if (ErrorMessage msg = findSlice(f.path, flags, index[SLICE]))
-					return msg;
+			if (!kernel && rowPitch == rowSize) {
+				std::memcpy(target + outRow * y0, slice + rowPitch * y0, rowSize * (y1 - y0));
+				return;
+			}
 
-			if (!(flags & GENERATE_MIPS))
-				if (ErrorMessage msg = findMip(f.path, flags, f.iid.mip))
-					return msg;
+			for (usz y = y0; y < y1; ++y)
+				if (kernel)
+					kernel(slice + rowPitch * y, target + outRow * y, desc.width);
 
-			for (u8 k = 0; k < SIZE; ++k)
-				if (index[k] == 0xFFFF)
-					return INVALID_RESOURCE_INDEX;
-				else
-					max[k] = std::max(u16(index[k] + 1), max[k]);
-		}
+				else std::memcpy(target + outRow * y, slice + rowPitch * y, rowSize);
+		});
 
-		for (usz i = 0; i < j; ++i) {
+		if (flags & GENERATE_MIPS)
+			if (ErrorMessage msg = generateMips(out, 0, flags, threads))
+				return msg;
 
-			auto &idx = indices[i];
+		if (flags & DO_COMPRESSION)
+			return compress(out, flags, quality, threads);
 
-			auto layer = (u64(idx[SLICE]) * max[SAMPLE] + idx[SAMPLE]) * max[SIDE] + idx[SIDE];
+		return SUCCESS;
+	}
 
-			if(layer > 0xFFFF)
-				return INVALID_RESOURCE_INDEX;
+	//Convert to formats
 
-			files[i].iid.layer = u16(layer);
-		}
+	//Encoders for the external formats (in order of allFormatsByPriority)
+	//"Rows" starts at the first row that should be written, the stride can be negative
 
-		return convert(out, files, flags);
-	}
+	//stb's compressor for encodePNG (declared in igxi/png.hpp); this file has stb_image_write's implementation
 
-	//Find paths similar to the input path
+	bool stbZlib(const u8 *data, usz size, int quality, Buffer &out) {
 
-	Helper::ErrorMessage Helper::convert(IGXI &out, const String &path, Flags flags) {
+		int len{};
+		u8 *mem = stbi_zlib_compress(const_cast<u8*>(data), int(size), &len, quality);
 
-		List<String> files;
-		
-		if (ErrorMessage msg = findFiles(path, flags, files))
-			return msg;
+		if (!mem)
+			return false;
 
-		return convert(out, files, flags);
+		out.assign(mem, mem + len);
+		STBIW_FREE(mem);
+		return true;
 	}
 
-	//Convert to formats
+	using ExternalEncoder = Buffer (*)(const u8 *rows, i64 rowStride, u16 width, u16 height, GPUFormat format, f32 quality, bool maxEffort);
+
+	inline Buffer writePNG(const u8 *rows, i64 rowStride, u16 width, u16 height, GPUFormat format, f32 quality, bool maxEffort) {
+		return encodePNG(
+			rows, rowStride, width, height, 
+			u8(FormatHelper::getChannelCount(format)), u8(FormatHelper::getStrideBytes(format)), 
+			getPNGLevel(quality, maxEffort)
+		);
+	}
+
+	static constexpr ExternalEncoder externalEncoders[] = {
+		&writePNG
+	};
+
+	static_assert(
+		_countof(externalEncoders) == _countof(Helper::allFormatsByPriority),
+		"externalEncoders has to contain every external format"
+	);
 
-	inline Buffer stbiWrite(const IGXI &in, const Vec3u16 &dim, ExternalFormat externFormat, u16 formatId, u16 layer, u16 z, u16 mip, f32 quality) {
+	inline Buffer writeExternal(
+		const IGXI &in, const Vec3u16 &dim, ExternalFormat externFormat, u16 formatId, u16 layer, u16 z, u16 mip, f32 quality, bool maxEffort
+	) {
 
 		//TODO: Range checking
 
@@ -753,31 +1464,24 @@ namespace igxi {
 			return {};
 		}
 
-		GPUFormat format = in.format[formatId];
-		usz stride = FormatHelper::getSizeBytes(format);
-
-		const u8 *begin = in.data[formatId][mip].data() + (usz(layer) * dim.z + z) * dim.y * dim.z * stride;
+		auto it = std::find(std::begin(Helper::allFormatsByPriority), std::end(Helper::allFormatsByPriority), externFormat);
 
-		int len{};
-		u8 *mem{};
+		if (it == std::end(Helper::allFormatsByPriority)) {
+			oic::System::log()->error("Unsupported external format");
+			return {};
+		}
 
-		switch (externFormat) {
+		GPUFormat format = in.format[formatId];
+		usz stride = FormatHelper::getSizeBytes(format);
 
-			case ExternalFormat::PNG:
-				stbi_flip_vertically_on_write(true);
-				mem = stbi_write_png_to_mem(begin, 0, dim.x, dim.y, int(stride), &len);
-				break;
+		usz rowSize = usz(dim.x) * stride;
 
-			default:
-				oic::System::log()->error("Unsupported STBI format");
-		}
+		const u8 *begin = in.data[formatId][mip].data() + (usz(layer) * dim.z + z) * dim.y * rowSize;
 
-		if (!mem)
-			return {};
+		//The image is flipped by starting at the last row and using a negative stride
 
-		Buffer buf = Buffer(mem, mem + len);
-		stbi_image_free(mem);
-		return buf;
+		ExternalEncoder encoder = externalEncoders[it - std::begin(Helper::allFormatsByPriority)];
+		return encoder(begin + rowSize * (dim.y - 1), -i64(rowSize), dim.x, dim.y, format, quality, maxEffort);
 	}
 
 	//Wrapper
@@ -786,7 +1490,7 @@ namespace igxi {
 
 		//Validate inputs
 
-		if (quality <= 0 || quality > 1)
+		if (quality < 0 || quality > 1)
 			return false;
 
 		//Checking for custom formats
@@ -796,18 +1500,24 @@ namespace igxi {
 
 		//Checking bit depth
 
-		if(!HasFlags(exFormat, ExternalFormat::PROPERTY_SUPPORTS_1C << FormatHelper::getChannelCount(format)))
+		if(!HasFlags(exFormat, ExternalFormat::PROPERTY_SUPPORTS_1C << (FormatHelper::getChannelCount(format) - 1)))
 		   return false;
 
-		if(!HasFlags(exFormat, ExternalFormat::PROPERTY_SUPPORTS_8B << FormatHelper::getStrideBytes(format)))
+		u8 bitId{};
+
+		for (usz bytes = FormatHelper::getStrideBytes(format); bytes > 1; bytes >>= 1)
+			++bitId;
+
+		if(!HasFlags(exFormat, ExternalFormat::PROPERTY_SUPPORTS_8B << bitId))
 		   return false;
 
 		//Checking quality
+		//Lossless formats can be used for any quality; there it's how much effort is spent compressing
 
 		if (quality == 1 && !HasFlags(exFormat, ExternalFormat::PROPERTY_CAN_BE_LOSSLESS))
 			return false;
 
-		if (quality != 1 && !HasFlags(exFormat, ExternalFormat::PROPERTY_CAN_BE_LOSSY))
+		if (quality != 1 && !HasFlags(exFormat, ExternalFormat::PROPERTY_CAN_BE_LOSSY) && !HasFlags(exFormat, ExternalFormat::PROPERTY_CAN_BE_LOSSLESS))
 			return false;
 
 		//Checking format type
@@ -828,7 +1538,7 @@ namespace igxi {
 	}
 
 	Buffer Helper::toExternal(
-		const IGXI &in, ExternalFormat exFormat, GPUFormat format, const Vec3u16 &dim, u16 z, u16 layerId, u8 mip, f32 quality
+		const IGXI &in, ExternalFormat exFormat, GPUFormat format, const Vec3u16 &dim, u16 z, u16 layerId, u8 mip, f32 quality, bool maxEffort
 	) {
 
 		auto it = std::find(in.format.begin(), in.format.end(), format);
@@ -838,16 +1548,24 @@ namespace igxi {
 			return {};
 		}
 
-		return stbiWrite(in, dim, exFormat, u16(it - in.format.begin()), layerId, z, mip, quality);
+		return writeExternal(in, dim, exFormat, u16(it - in.format.begin()), layerId, z, mip, quality, maxEffort);
 	}
 
-	HashMap<ignis::GPUFormat, List<Pair<Helper::FileDesc, Buffer>>> Helper::toMemoryExternal(const IGXI &igxi, f32 quality) {
+	//An image that will be output to an external format
 
-		//TODO: Validate IGXI
+	struct ExternalImage {
+		Helper::FileDesc desc;
+		ExternalFormat exFormat;
+		GPUFormat format;
+		Vec3u16 dim;
+	};
 
-		//Output to buffers
+	//List all images of the IGXI (in order of format, mip, layer, z) and the external format they'll be written as
+	//Formats that can't be represented by any external format are put in "unsupported" instead
 
-		HashMap<GPUFormat, List<Pair<FileDesc, Buffer>>> buffers;
+	inline List<ExternalImage> listExternalImages(const IGXI &igxi, List<GPUFormat> &unsupported) {
+
+		List<ExternalImage> images;
 
 		u16 layers = igxi.header.layers, mips = igxi.header.mips, formats = igxi.header.formats;
 
@@ -859,13 +1577,15 @@ namespace igxi {
 
 			usz i{};
 
-			for (const ExternalFormat &exFormat : allFormatsByPriority)
-				if (supportsExternal(exFormat, format))
+			for (const ExternalFormat &exFormat : Helper::allFormatsByPriority)
+				if (Helper::supportsExternal(exFormat, format))
 					break;
 				else ++i;
 
-			if (i == _countof(allFormatsByPriority))
+			if (i == _countof(Helper::allFormatsByPriority)) {
+				unsupported.push_back(format);
 				continue;
+			}
 
 			for(u8 mip = 0; mip != mips; ++mip) {
 
@@ -885,12 +1605,12 @@ namespace igxi {
 							(formats > 1 ? GPUFormat::nameByValue(format.value) : "") +
 							allFormatExtensions[i];
 
-						buffers[format].push_back({
+						images.push_back({
 							{ 
 								suffix, 
-								ImageIdentifier{ z, layer, mip } 
+								Helper::ImageIdentifier{ z, layer, mip } 
 							},
-							toExternal(igxi, allFormatsByPriority[i], format, dim, z, layer, mip, quality)
+							Helper::allFormatsByPriority[i], format, dim
 						});
 					}
 
@@ -898,36 +1618,194 @@ namespace igxi {
 			}
 		}
 
+		return images;
+	}
+
+	HashMap<ignis::GPUFormat, List<Pair<Helper::FileDesc, Buffer>>> Helper::toMemoryExternal(
+		const IGXI &igxi, f32 quality, u32 threads, bool maxEffort
+	) {
+
+		//TODO: Validate IGXI
+
+		List<GPUFormat> unsupported;
+		List<ExternalImage> images = listExternalImages(igxi, unsupported);
+
+		//Output to buffers
+		//Every image gets its entry up front, so they can be encoded in parallel and still keep their order
+
+		HashMap<GPUFormat, List<Pair<FileDesc, Buffer>>> buffers;
+		List<Pair<FileDesc, Buffer>*> targets(images.size());
+
+		for (const ExternalImage &img : images)
+			buffers[img.format].push_back({ img.desc, {} });
+
+		HashMap<GPUFormat, usz> next;
+
+		for (usz i = 0; i < images.size(); ++i)
+			targets[i] = &buffers[images[i].format][next[images[i].format]++];
+
+		parallelFor(images.size(), threads, [&](usz i) {
+
+			const ExternalImage &img = images[i];
+			const ImageIdentifier &iid = img.desc.iid;
+
+			targets[i]->second = toExternal(igxi, img.exFormat, img.format, img.dim, iid.z, iid.layer, iid.mip, quality, maxEffort);
+		});
+
 		return buffers;
 	}
 
-	List<GPUFormat> Helper::toDiskExternal(const IGXI &igxi, const String &path, f32 quality) {
+	//Writes encoded images on its own thread and frees them once they're written
+	//Encoders wait in push if the writer falls too far behind, so only a couple of images are kept in memory
+	//The thread is always joined (also when an encoder throws); images that are empty or can't be written are remembered
 
-		auto res = toMemoryExternal(igxi, quality);
+	struct ExternalWriter {
 
-		if (res.size() != igxi.header.formats) {
+		ExternalWriter(const String &path, usz maxQueued): path(path), maxQueued(maxQueued), thread([this]() { write(); }) {}
 
-			List<GPUFormat> unsupported = igxi.format;
+		ExternalWriter(const ExternalWriter&) = delete;
+		ExternalWriter(ExternalWriter&&) = delete;
+		ExternalWriter &operator=(const ExternalWriter&) = delete;
+		ExternalWriter &operator=(ExternalWriter&&) = delete;
 
-			for (auto &elem : res) {
+		~ExternalWriter() {
+			finish();
+		}
 
-				auto it = std::find(unsupported.begin(), unsupported.end(), elem.first);
+		void push(usz imageId, const String &name, Buffer &&buf) {
 
-				if (it != unsupported.end())
-					unsupported.erase(it);
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				written.wait(lock, [&]() { return queue.size() < maxQueued; });
+				queue.push_back({ imageId, name, std::move(buf) });
 			}
 
-			return unsupported;
+			queued.notify_one();
+		}
+
+		//Write the images that are left and wait for the thread
+
+		void finish() {
+
+			if (!thread.joinable())
+				return;
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				done = true;
+			}
+
+			queued.notify_one();
+			thread.join();
+		}
+
+		//The images that couldn't be written, in no particular order (only valid after finish)
+
+		inline const List<usz> &getFailed() const { return failed; }
+
+	private:
+
+		struct Image {
+			usz id;
+			String name;
+			Buffer buf;
+		};
+
+		const String &path;
+		usz maxQueued;
+
+		std::mutex mutex;
+		std::condition_variable queued, written;
+		List<Image> queue;
+		List<usz> failed;
+		bool done{};
+
+		std::thread thread;
+
+		void write() {
+
+			List<Image> batch;
+
+			for (;;) {
+
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					queued.wait(lock, [&]() { return done || !queue.empty(); });
+
+					if (queue.empty())
+						return;
+
+					std::swap(batch, queue);
+				}
+
+				written.notify_all();
+
+				//The writer has to keep taking images, or the encoders waiting on it would never return
+
+				for (Image &img : batch) {
+
+					bool ok{};
+
+					try {
+						ok = !img.buf.empty() && oic::System::files()->writeNew(path + img.name, img.buf);
+					} catch (...) {}
+
+					if (!ok)
+						failed.push_back(img.id);
+				}
+
+				batch.clear();
+			}
 		}
+	};
+
+	List<GPUFormat> Helper::toDiskExternal(const IGXI &igxi, const String &path, f32 quality, u32 threads, bool maxEffort) {
+
+		//Nothing is encoded if any of the formats can't be written
+
+		List<GPUFormat> unsupported;
+		List<ExternalImage> images = listExternalImages(igxi, unsupported);
+
+		if (!unsupported.empty())
+			return unsupported;
 
-		for (auto &elem : res)
-			for (auto &img : elem.second)
-				oic::System::files()->writeNew(path + img.first.path, img.second);
+		//Images are encoded in parallel and handed to the writer
 
-		return {};
+		u32 encoders = getThreadCount(threads, images.size());
+
+		{
+			ExternalWriter writer(path, usz(encoders) * 2);
+
+			parallelFor(images.size(), encoders, [&](usz i) {
+
+				const ExternalImage &img = images[i];
+				const ImageIdentifier &iid = img.desc.iid;
+
+				writer.push(
+					i, img.desc.path, 
+					toExternal(igxi, img.exFormat, img.format, img.dim, iid.z, iid.layer, iid.mip, quality, maxEffort)
+				);
+			});
+
+			writer.finish();
+
+			//The formats of the images that failed, in the order of the IGXI
+
+			for (GPUFormat format : igxi.format)
+				for (usz i : writer.getFailed())
+					if (images[i].format == format) {
+						unsupported.push_back(format);
+						break;
+					}
+		}
+
+		return unsupported;
 	}
 
-	Texture::Info Helper::convert(const IGXI &in, const Graphics &g, GPUFormat hint) {
+	//Find the format that should be loaded; the hinted one or the first one supported by the device
+	//Compressed formats go first, so an uncompressed format kept by KEEP_UNCOMPRESSED is only the fallback
+
+	inline u16 pickFormat(const IGXI &in, const Graphics &g, GPUFormat hint) {
 
 		u16 formatId = in.header.formats;
 
@@ -945,24 +1823,38 @@ namespace igxi {
 				}
 		}
 
-		else for(u16 i = 0; i < in.header.formats; ++i)
-			if (g.supportsFormat(in.format[i])) {
-				formatId = i;
+		else for (bool compressed : { true, false }) {
+
+			for (u16 i = 0; i < in.header.formats; ++i)
+				if ((!compressed || isCompressed(in.format[i])) && g.supportsFormat(in.format[i])) {
+					formatId = i;
+					break;
+				}
+
+			if (formatId != in.header.formats)
 				break;
-			}
+		}
 
 		if(formatId == in.header.formats)
 			oic::System::log()->fatal("Unsupported GPUFormats in texture by device");
 
-		GPUFormat format = in.format[formatId];
+		return formatId;
+	}
 
-		Texture::Info inf = Texture::Info(
+	inline Texture::Info makeInfo(const IGXI &in, u16 formatId) {
+		return Texture::Info(
 			in.header.type, 
 			Vec3u16(in.header.width, in.header.height, in.header.length), 
-			format, in.header.usage,
+			in.format[formatId], in.header.usage,
 			in.header.mips, in.header.layers, 
 			1, true
 		);
+	}
+
+	Texture::Info Helper::convert(const IGXI &in, const Graphics &g, GPUFormat hint) {
+
+		u16 formatId = pickFormat(in, g, hint);
+		Texture::Info inf = makeInfo(in, formatId);
 
 		if (u8(in.header.flags) & u8(IGXI::Flags::CONTAINS_DATA))
 			inf.init(in.data[formatId]);
@@ -970,6 +1862,24 @@ namespace igxi {
 		return inf;
 	}
 
+	Texture::Info Helper::convert(IGXI &&in, const Graphics &g, GPUFormat hint) {
+
+		u16 formatId = pickFormat(in, g, hint);
+		Texture::Info inf = makeInfo(in, formatId);
+
+		if (!(u8(in.header.flags) & u8(IGXI::Flags::CONTAINS_DATA)))
+			return inf;
+
+		//The IGXI isn't needed anymore, so other formats are freed before the mips are copied
+		//	and the mips are freed right after, so only the loaded format is ever kept twice
+
+		List<Buffer> mips = std::move(in.data[formatId]);
+		List<List<Buffer>>().swap(in.data);
+
+		inf.init(mips);
+		return inf;
+	}
+
 	oicExposedEnum(ErrorMessageExposed, u8,
 
 		Success,
@@ -988,6 +1898,8 @@ namespace igxi {
 		Invalid_file_name_slice,
 		Invalid_file_name_mip,
 		Invalid_operation,
+		Incompatible_formats,
+		Invalid_mip_filter,
 
 		Missing_face = 0x21,
 		Missing_paths,
@@ -1001,20 +1913,40 @@ namespace igxi {
 	);
 
 	Texture::Info Helper::loadMemoryExternal(const Buffer &data, const Graphics &g, Flags flags) {
+		return loadMemoryExternal(Buffer(data), g, flags);
+	}
+
+	Texture::Info Helper::loadMemoryExternal(Buffer &&data, const Graphics &g, Flags flags) {
 
 		IGXI out;
-		out.data.push_back({ data });
+		out.data.push_back({});
+		out.data[0].push_back(std::move(data));
 
 		ErrorMessage errorMessage = convert(out, List<FileDesc>{ {} }, flags);
 
 		if (errorMessage != SUCCESS)
 			oic::System::log()->fatal(ErrorMessageExposed::nameByValue((ErrorMessageExposed::_E)errorMessage));
 
-		return convert(out, g);
+		return convert(std::move(out), g);
 	}
 
 	Texture::Info Helper::loadDiskExternal(const String &path, const Graphics &g, Flags flags) {
-		return loadMemoryExternal(oic::System::files()->readToBuffer(path), g, flags);
+
+		//Virtual files (~/) only exist in the file system, so they're read through it
+		//Real files are decoded from the mapped file, instead of reading them into memory first
+
+		std::error_code error;
+
+		if (path.empty() || path[0] == '~' || !std::filesystem::is_regular_file(path, error))
+			return loadMemoryExternal(oic::System::files()->readToBuffer(path), g, flags);
+
+		IGXI out;
+		ErrorMessage errorMessage = convert(out, List<FileDesc>{ { path, {} } }, flags);
+
+		if (errorMessage != SUCCESS)
+			oic::System::log()->fatal(ErrorMessageExposed::nameByValue((ErrorMessageExposed::_E)errorMessage));
+
+		return convert(std::move(out), g);
 	}
 
 }
\ No newline at end of file
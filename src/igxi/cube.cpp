@@ -0,0 +1,334 @@
+#include "igxi/cube.hpp"
+#include "igxi/kernels.hpp"
+#include "igxi/srgb.hpp"
+#include "igxi/parallel.hpp"
+
+using namespace ignis;
+
+namespace igxi {
+
+	static constexpr f64 pi = 3.14159265358979323846;
+
+	//Layout
+
+	CubeLayout getCubeLayout(u16 width, u16 height) {
+
+		if (!width || !height)
+			return CubeLayout::NONE;
+
+		//A panorama needs a face of at least 1x1 (width / 4)
+
+		if (width == height * 2)
+			return width >= 4 ? CubeLayout::EQUIRECTANGULAR : CubeLayout::NONE;
+
+		if (width * 3 == height * 4)
+			return CubeLayout::HORIZONTAL_CROSS;
+
+		if (width * 4 == height * 3)
+			return CubeLayout::VERTICAL_CROSS;
+
+		return CubeLayout::NONE;
+	}
+
+	u16 getCubeFaceSize(CubeLayout layout, u16 width, u16) {
+
+		switch (layout) {
+			case CubeLayout::EQUIRECTANGULAR:	return u16(width / 4);
+			case CubeLayout::HORIZONTAL_CROSS:	return u16(width / 4);
+			case CubeLayout::VERTICAL_CROSS:	return u16(width / 3);
+			default:							return 0;
+		}
+	}
+
+	//Channels to and from f32
+
+	template<typename T, bool isSrgb>
+	inline f32 toFloat(T v) {
+
+		if constexpr (isSrgb)
+			return getSrgbTables().toLinear[v];
+
+		else return f32(v);
+	}
+
+	template<typename T, bool isSrgb>
+	inline T fromFloat(f32 v) {
+
+		if constexpr (isSrgb)
+			return getSrgbTables().toSrgb(v);
+
+		else if constexpr (std::is_same_v<T, f16>)
+			return ConvertPrimitive<f16, f32>::apply(v);
+
+		else if constexpr (std::is_floating_point_v<T>)
+			return T(v);
+
+		//Rounded half away from zero, like std::round (but without a call to roundf)
+
+		else {
+			f32 clamped = std::clamp(v, f32(std::numeric_limits<T>::min()), f32(std::numeric_limits<T>::max()));
+			return T(clamped + (clamped < 0 ? -.5f : .5f));
+		}
+	}
+
+	//Where the pixels of the faces are in an equirectangular panorama (u and v are 0 -> 1)
+	//Every face has the same pixel positions, so the angles are calculated once instead of per face:
+	//	the sides (+x, -x, +z, -z) are rotations of each other; u only depends on the column (with an offset per face)
+	//	and v is the same for each of them
+	//	-y is +y mirrored; u of -y is u of +y on the mirrored row and v of -y is 1 - v of +y
+
+	struct PanoramaTables {
+
+		List<f32> sideU, sideV, topU, topV;
+
+		PanoramaTables(u16 faceSize, u32 threads): 
+			sideU(faceSize), sideV(usz(faceSize) * faceSize), topU(sideV.size()), topV(sideV.size()) {
+
+			auto coord = [faceSize](u16 i) { return (i + .5f) / faceSize * 2 - 1; };
+
+			//-z is the center of the panorama (u = .5), so a side is -atan(s) around its center
+
+			for (u16 x = 0; x < faceSize; ++x)
+				sideU[x] = f32(.5 - std::atan(f64(coord(x))) / (2 * pi));
+
+			parallelFor(faceSize, threads, [&](usz y) {
+
+				f64 t = coord(u16(y));
+
+				for (u16 x = 0; x < faceSize; ++x) {
+
+					f64 s = coord(x);
+					usz i = y * faceSize + x;
+
+					//The side's direction is (s, -t, 1) rotated around y and +y's direction is (s, 1, t)
+
+					sideV[i] = f32(std::atan2(std::sqrt(1 + s * s), -t) / pi);
+					topU[i] = f32(std::atan2(s, -t) / (2 * pi) + .5);
+					topV[i] = f32(std::atan2(std::sqrt(s * s + t * t), 1.) / pi);
+				}
+			});
+		}
+	};
+
+	//u of the sides of the cube relative to -z (in order of +x, -x, +y, -y, +z, -z)
+
+	static constexpr f32 sideOffsets[6] = { .25f, -.25f, 0, 0, .5f, 0 };
+
+	//Sample a row of a face from an equirectangular panorama
+	//"Us" and "vs" are the positions of the row in the panorama (0 -> 1); u + uOffset and vBias + vScale * v are sampled
+	//The weights are the same for every channel, so the channel loop can be vectorized
+
+	template<typename T, usz C, bool isSrgb>
+	void sampleRow(
+		const u8 *srcData, u16 width, u16 height, u16 faceSize,
+		const f32 *us, f32 uOffset, const f32 *vs, f32 vBias, f32 vScale, u8 *dstData
+	) {
+
+		const T *src = (const T*) srcData;
+		T *dst = (T*) dstData;
+
+		for (u16 x = 0; x < faceSize; ++x) {
+
+			f32 px = (us[x] + uOffset) * width - .5f, py = (vBias + vScale * vs[x]) * height - .5f;
+
+			//u + uOffset is -.25 -> 1.5 and v is 0 -> 1, so px + width and py + 1 are positive
+			//	and the floor is a truncation (which doesn't need a call to floorf without SSE4.1)
+
+			i32 ix = i32(px + width) - width, iy = i32(py + 1) - 1;
+			f32 fx = px - f32(ix), fy = py - f32(iy);
+
+			//Wrap around horizontally (at most once), clamp vertically
+
+			i32 x0 = ix < 0 ? ix + width : (ix >= width ? ix - width : ix), x1 = x0 + 1 == width ? 0 : x0 + 1;
+			i32 y0 = std::clamp(iy, 0, height - 1), y1 = std::clamp(iy + 1, 0, height - 1);
+
+			const T *p00 = src + (usz(y0) * width + x0) * C, *p01 = src + (usz(y0) * width + x1) * C;
+			const T *p10 = src + (usz(y1) * width + x0) * C, *p11 = src + (usz(y1) * width + x1) * C;
+
+			f32 w00 = (1 - fx) * (1 - fy), w01 = fx * (1 - fy), w10 = (1 - fx) * fy, w11 = fx * fy;
+
+			T *out = dst + usz(x) * C;
+
+			for (usz c = 0; c < C; ++c) {
+
+				//Alpha isn't gamma corrected
+
+				if constexpr (isSrgb)
+					if (c == 3) {
+						out[c] = fromFloat<T, false>(w00 * p00[c] + w01 * p01[c] + w10 * p10[c] + w11 * p11[c]);
+						continue;
+					}
+
+				out[c] = fromFloat<T, isSrgb>(
+					w00 * toFloat<T, isSrgb>(p00[c]) + w01 * toFloat<T, isSrgb>(p01[c]) +
+					w10 * toFloat<T, isSrgb>(p10[c]) + w11 * toFloat<T, isSrgb>(p11[c])
+				);
+			}
+		}
+	}
+
+	using SampleRow = void (*)(
+		const u8 *src, u16 width, u16 height, u16 faceSize,
+		const f32 *us, f32 uOffset, const f32 *vs, f32 vBias, f32 vScale, u8 *dst
+	);
+
+	template<typename T, bool isSrgb = false>
+	inline SampleRow getSampleRow(usz C) {
+		switch (C) {
+			case 1:		return &sampleRow<T, 1, isSrgb>;
+			case 2:		return &sampleRow<T, 2, isSrgb>;
+			case 3:		return &sampleRow<T, 3, isSrgb>;
+			default:	return &sampleRow<T, 4, isSrgb>;
+		}
+	}
+
+	inline SampleRow getSampleRow(GPUFormat format) {
+
+		usz stride = FormatHelper::getStrideBytes(format);
+
+		if (!stride)
+			return nullptr;
+
+		usz C = FormatHelper::getSizeBytes(format) / stride;
+
+		if (C - 1 >= 4)
+			return nullptr;
+
+		if (format == GPUFormat::srgba8)
+			return getSampleRow<u8, true>(C);
+
+		switch (FormatHelper::getType(format)) {
+
+			case GPUFormatType::UNORM:
+			case GPUFormatType::UINT:
+
+				switch (stride) {
+					case 1:		return getSampleRow<u8>(C);
+					case 2:		return getSampleRow<u16>(C);
+					default:	return nullptr;
+				}
+
+			case GPUFormatType::SNORM:
+			case GPUFormatType::SINT:
+
+				switch (stride) {
+					case 1:		return getSampleRow<i8>(C);
+					case 2:		return getSampleRow<i16>(C);
+					default:	return nullptr;
+				}
+
+			case GPUFormatType::FLOAT:
+
+				switch (stride) {
+					case 2:		return getSampleRow<f16>(C);
+					case 4:		return getSampleRow<f32>(C);
+					default:	return nullptr;
+				}
+
+			default:
+				return nullptr;
+		}
+	}
+
+	//Cross cells per face (column, row) and whether the face is upside down
+
+	struct CrossCell {
+		u8 x, y;
+		bool flip;
+	};
+
+	static constexpr CrossCell horizontalCross[6] = {
+		{ 2, 1, false }, { 0, 1, false }, { 1, 0, false }, { 1, 2, false }, { 1, 1, false }, { 3, 1, false }
+	};
+
+	static constexpr CrossCell verticalCross[6] = {
+		{ 2, 1, false }, { 0, 1, false }, { 1, 0, false }, { 1, 2, false }, { 1, 1, false }, { 1, 3, true }
+	};
+
+	Helper::ErrorMessage toCube(
+		const u8 *src, u16 width, u16 height, GPUFormat format, CubeLayout layout, u8 *faces, u32 threads
+	) {
+
+		if (getCubeLayout(width, height) != layout || layout == CubeLayout::NONE)
+			return Helper::INVALID_IMAGE_SIZE;
+
+		//The angles of a panorama are only right if it's exactly 2:1; a stretched one would give skewed faces
+
+		if (layout == CubeLayout::EQUIRECTANGULAR && usz(width) != usz(height) * 2)
+			return Helper::INVALID_IMAGE_SIZE;
+
+		u16 faceSize = getCubeFaceSize(layout, width, height);
+
+		if (!faceSize)
+			return Helper::INVALID_IMAGE_SIZE;
+
+		usz stride = FormatHelper::getSizeBytes(format);
+		usz faceRow = usz(faceSize) * stride, srcRow = usz(width) * stride;
+		usz faceBytes = faceRow * faceSize;
+
+		//Crosses are already made of faces
+
+		if (layout != CubeLayout::EQUIRECTANGULAR) {
+
+			const CrossCell *cells = layout == CubeLayout::HORIZONTAL_CROSS ? horizontalCross : verticalCross;
+
+			parallelFor(usz(faceSize) * 6, threads, [&](usz i) {
+
+				usz face = i / faceSize, y = i % faceSize;
+				const CrossCell &cell = cells[face];
+
+				u8 *dst = faces + face * faceBytes + y * faceRow;
+
+				if (!cell.flip) {
+					std::memcpy(dst, src + (usz(cell.y) * faceSize + y) * srcRow + cell.x * faceRow, faceRow);
+					return;
+				}
+
+				//Upside down; the row and the pixels in it are reversed
+
+				const u8 *srcLine = src + (usz(cell.y) * faceSize + faceSize - 1 - y) * srcRow + cell.x * faceRow;
+
+				for (usz x = 0; x < faceSize; ++x)
+					std::memcpy(dst + x * stride, srcLine + (faceSize - 1 - x) * stride, stride);
+			});
+
+			return Helper::SUCCESS;
+		}
+
+		SampleRow sample = getSampleRow(format);
+
+		if (!sample)
+			return Helper::INVALID_FORMAT;
+
+		PanoramaTables tables(faceSize, threads);
+
+		parallelFor(usz(faceSize) * 6, threads, [&](usz i) {
+
+			u8 face = u8(i / faceSize);
+			u16 y = u16(i % faceSize);
+
+			u8 *dst = faces + face * faceBytes + y * faceRow;
+			usz row = usz(y) * faceSize, mirrored = usz(faceSize - 1 - y) * faceSize;
+
+			switch (face) {
+
+				case 2:
+					sample(src, width, height, faceSize, tables.topU.data() + row, 0, tables.topV.data() + row, 0, 1, dst);
+					break;
+
+				case 3:
+					sample(src, width, height, faceSize, tables.topU.data() + mirrored, 0, tables.topV.data() + row, 1, -1, dst);
+					break;
+
+				default:
+					sample(
+						src, width, height, faceSize, 
+						tables.sideU.data(), sideOffsets[face], tables.sideV.data() + row, 0, 1, dst
+					);
+			}
+		});
+
+		return Helper::SUCCESS;
+	}
+
+}
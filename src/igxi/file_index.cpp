@@ -0,0 +1,225 @@
+#include "igxi/file_index.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+namespace fs = std::filesystem;
+
+namespace igxi {
+
+	//Name parsing
+
+	inline String toLower(String str) {
+
+		for (char &c : str)
+			c = char(std::tolower(u8(c)));
+
+		return str;
+	}
+
+	inline bool isSeparator(char c) {
+		return c == '.' || c == '_' || c == '-';
+	}
+
+	//Cube faces in order of side; both names refer to the same side
+
+	static constexpr const char *faceNames[6][2] = {
+		{ "right", "+x" },
+		{ "left", "-x" },
+		{ "top", "+y" },
+		{ "bottom", "-y" },
+		{ "back", "+z" },
+		{ "front", "-z" }
+	};
+
+	//Match a face that ends at "end"; returns where it starts or String::npos
+
+	inline usz findFace(const String &lower, usz end, u16 &side) {
+
+		for (u16 i = 0; i < 6; ++i)
+			for (const char *name : faceNames[i]) {
+
+				usz len = std::strlen(name);
+
+				if (len <= end && lower.compare(end - len, len, name) == 0) {
+					side = i;
+					return end - len;
+				}
+			}
+
+		return String::npos;
+	}
+
+	bool isSupportedExtension(const String &extension) {
+
+		static const List<String> extensions {
+			".png", ".jpg", ".jpeg", ".bmp", ".gif", ".pic", ".pnm", ".ppm", ".pgm", ".tga", ".psd", ".hdr", ".dds", ".ktx2"
+		};
+
+		return std::find(extensions.begin(), extensions.end(), toLower(extension)) != extensions.end();
+	}
+
+	bool isContainerExtension(const String &extension) {
+		String lower = toLower(extension);
+		return lower == ".dds" || lower == ".ktx2";
+	}
+
+	Helper::ErrorMessage parseFileName(const String &path, Helper::Flags flags, ParsedFileName &out) {
+
+		String stem = fs::path(path).stem().string();
+		String lower = toLower(stem);
+
+		//Numbers are read from the back; z, mip, slice then sample
+
+		enum Index : u8 { Z, MIP, SLICE, SAMPLE, SIZE };
+
+		static constexpr Helper::ErrorMessage errors[SIZE] = {
+			Helper::INVALID_FILE_NAME_SLICE,
+			Helper::INVALID_FILE_NAME_MIP,
+			Helper::INVALID_FILE_NAME_SLICE,
+			Helper::INVALID_FILE_NAME_SLICE
+		};
+
+		//With FRAMES_FROM_IMAGE, the frames of the file are its slices
+
+		const bool fromFrames = flags & Helper::FRAMES_FROM_IMAGE;
+
+		bool required[SIZE] = {
+			flags & Helper::IS_3D && !fromFrames,
+			!(flags & Helper::GENERATE_MIPS),
+			flags & Helper::IS_ARRAY && !fromFrames,
+			bool(flags & Helper::IS_MS)
+		};
+
+		u32 values[SIZE]{};
+		usz end = stem.size();
+		bool anyNumber{};
+
+		for (u8 k = SIZE; k-- > 0; ) {
+
+			if (!required[k])
+				continue;
+
+			//Every number but the first (in the name) is preceded by a separator
+			//So the separator after this one is consumed first
+
+			if (anyNumber) {
+
+				if (!end || !isSeparator(stem[end - 1]))
+					return errors[k];
+
+				--end;
+			}
+
+			usz start = end;
+
+			while (start && std::isdigit(u8(stem[start - 1])))
+				--start;
+
+			//u16_MAX is reserved as an error code
+
+			if (start == end || end - start > 5)
+				return errors[k];
+
+			values[k] = u32(std::stoul(stem.substr(start, end - start)));
+
+			if (values[k] >= (k == MIP ? 0xFFu : 0xFFFFu))
+				return errors[k];
+
+			end = start;
+			anyNumber = true;
+		}
+
+		//The face can be followed by a separator (if there are numbers)
+
+		bool hasFace = (flags & Helper::IS_CUBE) && !(flags & Helper::CUBE_FROM_IMAGE);
+
+		if (hasFace) {
+
+			usz start = findFace(lower, end, out.side);
+
+			if (start == String::npos && anyNumber && end && isSeparator(stem[end - 1]))
+				start = findFace(lower, end - 1, out.side);
+
+			if (start == String::npos)
+				return Helper::INVALID_FILE_NAME_FACE;
+
+			end = start;
+		}
+
+		//The base can be followed by a separator too
+
+		if ((anyNumber || hasFace) && end && isSeparator(stem[end - 1]))
+			--end;
+
+		out.base = stem.substr(0, end);
+		out.z = u16(values[Z]);
+		out.mip = u8(values[MIP]);
+		out.slice = u16(values[SLICE]);
+		out.sample = u16(values[SAMPLE]);
+		return Helper::SUCCESS;
+	}
+
+	//Index
+
+	FileIndex::FileIndex(const String &dir): directory(dir) {
+
+		//Iterated by hand, since a range-for throws if an increment fails (e.g. an unreadable entry)
+
+		std::error_code error;
+
+		fs::directory_iterator it(directory.empty() ? "." : directory, error), end;
+
+		for (; !error && it != end; it.increment(error)) {
+
+			const fs::directory_entry &entry = *it;
+			std::error_code fileError;
+
+			if (!entry.is_regular_file(fileError) || !isSupportedExtension(entry.path().extension().string()))
+				continue;
+
+			String name = entry.path().filename().string();
+			files.push_back({ toLower(name), (fs::path(directory) / name).string() });
+		}
+
+		std::sort(files.begin(), files.end());
+	}
+
+	Helper::ErrorMessage FileIndex::find(const String &name, Helper::Flags flags, List<String> &paths) const {
+
+		String lower = toLower(name);
+
+		//Only names that start with the base can belong to it
+
+		auto it = std::lower_bound(
+			files.begin(), files.end(), lower, 
+			[](const Pair<String, String> &file, const String &prefix) { return file.first < prefix; }
+		);
+
+		paths.clear();
+
+		for (; it != files.end() && it->first.compare(0, lower.size(), lower) == 0; ++it) {
+
+			//A DDS or KTX2 file is the whole texture, so its name doesn't have any indices
+
+			if (isContainerExtension(fs::path(it->second).extension().string())) {
+
+				if (toLower(fs::path(it->second).stem().string()) == lower)
+					paths.push_back(it->second);
+
+				continue;
+			}
+
+			//Files that don't fit the naming scheme belong to another texture (e.g. "sky_normal.png" for "sky")
+
+			ParsedFileName parsed;
+
+			if (parseFileName(it->second, flags, parsed) == Helper::SUCCESS && toLower(parsed.base) == lower)
+				paths.push_back(it->second);
+		}
+
+		return paths.empty() ? Helper::MISSING_PATHS : Helper::SUCCESS;
+	}
+
+}
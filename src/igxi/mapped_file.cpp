@@ -0,0 +1,140 @@
+#include "igxi/mapped_file.hpp"
+#include "igxi/igxi.hpp"
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <Windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace igxi {
+
+	MappedFile::MappedFile(const String &path) {
+
+		//Files that exist but can't be mapped (e.g. empty files or pipes) are read instead
+
+		if (!map(path))
+			read(path);
+	}
+
+	MappedFile::~MappedFile() {
+
+		if (!mapped)
+			return;
+
+		#ifdef _WIN32
+			UnmapViewOfFile(view);
+		#else
+			munmap(const_cast<u8*>(view), length);
+		#endif
+	}
+
+	#ifdef _WIN32
+
+		bool MappedFile::map(const String &path) {
+
+			HANDLE file = CreateFileA(
+				path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+			);
+
+			//Files that can't be opened can't be read either
+
+			if (file == INVALID_HANDLE_VALUE)
+				return true;
+
+			LARGE_INTEGER size{};
+
+			if (!GetFileSizeEx(file, &size) || !size.QuadPart) {
+				CloseHandle(file);
+				return false;
+			}
+
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			CloseHandle(file);
+
+			if (!mapping)
+				return false;
+
+			//The view keeps the mapping alive
+
+			void *ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+
+			if (!ptr)
+				return false;
+
+			view = (const u8*) ptr;
+			length = usz(size.QuadPart);
+			mapped = true;
+			return true;
+		}
+
+	#else
+
+		bool MappedFile::map(const String &path) {
+
+			int file = open(path.c_str(), O_RDONLY);
+
+			//Files that can't be opened can't be read either
+
+			if (file < 0)
+				return true;
+
+			struct stat info{};
+
+			if (fstat(file, &info) || !S_ISREG(info.st_mode) || info.st_size <= 0) {
+				close(file);
+				return false;
+			}
+
+			//The mapping stays valid after the file is closed
+
+			void *ptr = mmap(nullptr, usz(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			close(file);
+
+			if (ptr == MAP_FAILED)
+				return false;
+
+			//Decoders mostly read front to back
+
+			madvise(ptr, usz(info.st_size), MADV_SEQUENTIAL);
+
+			view = (const u8*) ptr;
+			length = usz(info.st_size);
+			mapped = true;
+			return true;
+		}
+
+	#endif
+
+	bool MappedFile::read(const String &path) {
+
+		IGXI::File loader(path, false);
+
+		usz start{};
+		fallback.resize(loader.size());
+
+		if (loader.readRegion(fallback.data(), start, loader.size())) {
+			fallback.clear();
+			return false;
+		}
+
+		//data() should only be null if the file couldn't be opened
+
+		static const u8 empty{};
+
+		view = fallback.empty() ? &empty : fallback.data();
+		length = fallback.size();
+		return true;
+	}
+
+}
@@ -0,0 +1,809 @@
+#include "igxi/mips.hpp"
+#include "igxi/prefilter.hpp"
+#include "igxi/resample.hpp"
+#include "igxi/kernels.hpp"
+#include "igxi/srgb.hpp"
+#include "igxi/parallel.hpp"
+
+using namespace ignis;
+
+namespace igxi {
+
+	enum class MipFilter : u8 {
+		LINEAR,
+		NEAREST,
+		MIN,
+		MAX,
+		PREMULTIPLIED
+	};
+
+	//Filters over n samples
+
+	template<typename T>
+	struct Arithmetic { using Type = T; };
+
+	template<>
+	struct Arithmetic<f16> { using Type = f32; };
+
+	template<typename T, usz n>
+	inline T average(const T *s) {
+
+		if constexpr (std::is_same_v<T, f16> || std::is_floating_point_v<T>) {
+
+			//Pairwise, so vectorized kernels give the same result
+
+			using Sum = typename Arithmetic<T>::Type;
+
+			Sum sum[n];
+
+			for (usz i = 0; i < n; ++i)
+				sum[i] = Sum(s[i]);
+
+			for (usz step = 1; step < n; step *= 2)
+				for (usz i = 0; i + step < n; i += step * 2)
+					sum[i] += sum[i + step];
+
+			return ConvertPrimitive<T, Sum>::apply(sum[0] * (Sum(1) / n));
+		}
+
+		else {
+
+			constexpr bool isSigned = std::is_signed_v<T>;
+
+			using Sum = std::conditional_t<
+				sizeof(T) <= 2,
+				std::conditional_t<isSigned, i32, u32>,
+				std::conditional_t<isSigned, i64, u64>
+			>;
+
+			//64-bit values can overflow, so sum up the quotients and remainders separately
+
+			Sum quotient{}, remainder{};
+
+			for (usz i = 0; i < n; ++i)
+				if constexpr (sizeof(T) == 8) {
+					quotient += s[i] / Sum(n);
+					remainder += s[i] % Sum(n);
+				}
+				else remainder += s[i];
+
+			//Round half away from zero
+
+			if constexpr (isSigned)
+				if (remainder < 0)
+					return T(quotient - (-remainder + Sum(n / 2)) / Sum(n));
+
+			return T(quotient + (remainder + Sum(n / 2)) / Sum(n));
+		}
+	}
+
+	template<usz n>
+	inline u8 averageSrgb(const u8 *s) {
+
+		const SrgbTables &tables = getSrgbTables();
+
+		f32 sum{};
+
+		for (usz i = 0; i < n; ++i)
+			sum += tables.toLinear[s[i]];
+
+		return tables.toSrgb(sum * (1.f / n));
+	}
+
+	template<typename T, usz n, bool isMax>
+	inline T minMax(const T *s) {
+
+		using A = typename Arithmetic<T>::Type;
+
+		usz j{};
+		A best = A(s[0]);
+
+		for (usz i = 1; i < n; ++i) {
+
+			A v = A(s[i]);
+
+			if (isMax ? v > best : v < best) {
+				best = v;
+				j = i;
+			}
+		}
+
+		return s[j];
+	}
+
+	//Average of n rgba pixels weighted by alpha; the same as premultiplying, averaging and dividing by the alpha again
+	//If all of them are transparent, the color is the plain average so it doesn't turn black
+	//
+	//The alpha is the plain average (the same as MIP_LINEAR), only the color is weighted
+	//Up to 16-bit is done in f32, that's exact for the sums of 8-bit so the SSE2 kernel gives the same result
+
+	template<typename T, usz n, bool srgb>
+	inline void averagePremultiplied(const T (&s)[4][n], T *out) {
+
+		using F = std::conditional_t<sizeof(T) <= 2, f32, f64>;
+
+		const SrgbTables *tables = srgb ? &getSrgbTables() : nullptr;
+
+		F weights[n], weight{};
+
+		for (usz i = 0; i < n; ++i) {
+			weights[i] = std::max(F(s[3][i]), F(0));
+			weight += weights[i];
+		}
+
+		for (usz c = 0; c < 3; ++c) {
+
+			F sum{}, plain{};
+
+			for (usz i = 0; i < n; ++i) {
+
+				F v;
+
+				if constexpr (srgb)
+					v = F(tables->toLinear[s[c][i]]);
+
+				else v = F(s[c][i]);
+
+				sum += v * weights[i];
+				plain += v;
+			}
+
+			F v = weight > 0 ? sum / weight : plain * (F(1) / n);
+
+			if constexpr (srgb)
+				out[c] = T(tables->toSrgb(f32(v)));
+
+			else if constexpr (std::is_same_v<T, f16>)
+				out[c] = ConvertPrimitive<T, f32>::apply(f32(v));
+
+			else if constexpr (std::is_floating_point_v<T>)
+				out[c] = T(v);
+
+			else out[c] = T(std::clamp(
+				std::floor(v + F(.5)), F(std::numeric_limits<T>::min()), F(std::numeric_limits<T>::max())
+			));
+		}
+
+		out[3] = average<T, n>(s[3]);
+	}
+
+	//Reduce one row of a mip
+	//Every output pixel is made from 2 pixels of each of the source rows
+	//2 rows for 1D/2D textures and 4 rows (2 rows of 2 slices) for 3D textures
+
+	using RowKernel = void (*)(const u8 *const *rows, u8 *dst, usz dstWidth, usz srcWidth);
+
+	template<typename T, MipFilter filter, bool srgb, usz C, usz rowCount>
+	inline void reducePixels(const u8 *const *rows, u8 *dst, usz begin, usz end, usz srcWidth) {
+
+		constexpr usz n = rowCount * 2;
+
+		T *out = (T*) dst;
+
+		for (usz i = begin; i < end; ++i) {
+
+			usz x0 = i * 2, x1 = std::min(x0 + 1, srcWidth - 1);
+
+			if constexpr (filter == MipFilter::PREMULTIPLIED && C == 4) {
+
+				T s[4][n];
+
+				for (usz c = 0; c < 4; ++c)
+					for (usz r = 0; r < rowCount; ++r) {
+						const T *row = (const T*) rows[r];
+						s[c][r * 2] = row[x0 * 4 + c];
+						s[c][r * 2 + 1] = row[x1 * 4 + c];
+					}
+
+				averagePremultiplied<T, n, srgb>(s, out + i * 4);
+				continue;
+			}
+
+			for (usz c = 0; c < C; ++c) {
+
+				T s[n];
+
+				for (usz r = 0; r < rowCount; ++r) {
+					const T *row = (const T*) rows[r];
+					s[r * 2] = row[x0 * C + c];
+					s[r * 2 + 1] = row[x1 * C + c];
+				}
+
+				T &o = out[i * C + c];
+
+				if constexpr (filter == MipFilter::NEAREST)
+					o = s[0];
+
+				else if constexpr (filter == MipFilter::MIN)
+					o = minMax<T, n, false>(s);
+
+				else if constexpr (filter == MipFilter::MAX)
+					o = minMax<T, n, true>(s);
+
+				else if constexpr (srgb)
+					o = c == 3 ? average<T, n>(s) : averageSrgb<n>(s);
+
+				//Without alpha, premultiplying doesn't change anything
+
+				else o = average<T, n>(s);
+			}
+		}
+	}
+
+	template<typename T, MipFilter filter, bool srgb, usz C, usz rowCount>
+	inline void reduceRow(const u8 *const *rows, u8 *dst, usz dstWidth, usz srcWidth) {
+		reducePixels<T, filter, srgb, C, rowCount>(rows, dst, 0, dstWidth, srcWidth);
+	}
+
+	//Vectorized 2x2 (or 2x2x2 for 3D textures) kernels for the most common formats
+	//They give the same results as reducePixels; the rows that aren't vectorized are left to it
+
+	#ifdef IGXI_SSE2
+
+		//Average of the 2x2 blocks in 4 rgba8 pixels of each row (2 or 4 rows); returns 2 pixels as u16
+
+		template<usz rowCount>
+		inline __m128i averageRgba8(const __m128i (&v)[rowCount]) {
+
+			const __m128i zero = _mm_setzero_si128();
+
+			__m128i lo = zero, hi = zero;
+
+			for (usz r = 0; r < rowCount; ++r) {
+				lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v[r], zero));		//Pixel 0, 1
+				hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v[r], zero));		//Pixel 2, 3
+			}
+
+			__m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));		//Pixel 0 + 1, 2 + 3
+
+			//(sum + n / 2) / n, with n = rowCount * 2
+
+			constexpr int shift = rowCount == 2 ? 2 : 3;
+
+			return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(i16(rowCount))), shift);
+		}
+
+		//Min or max of the 2x2 blocks in 4 rgba8 pixels of each row; returns 2 pixels in the low 64 bits
+
+		template<bool isMax, usz rowCount>
+		inline __m128i minMaxRgba8(const __m128i (&v)[rowCount]) {
+
+			__m128i res = v[0];
+
+			for (usz r = 1; r < rowCount; ++r)
+				res = isMax ? _mm_max_epu8(res, v[r]) : _mm_min_epu8(res, v[r]);
+
+			res = isMax ? _mm_max_epu8(res, _mm_srli_si128(res, 4)) : _mm_min_epu8(res, _mm_srli_si128(res, 4));
+
+			return _mm_shuffle_epi32(res, _MM_SHUFFLE(3, 1, 2, 0));
+		}
+
+		template<MipFilter filter, usz rowCount>
+		inline void reduceRowRgba8(const u8 *const *rows, u8 *dst, usz dstWidth, usz srcWidth) {
+
+			usz i{};
+
+			//4 output pixels at a time, as long as all 8 source pixels are in bounds
+
+			for (; i + 4 <= dstWidth && i * 2 + 8 <= srcWidth; i += 4) {
+
+				__m128i a[rowCount], b[rowCount];
+
+				for (usz r = 0; r < rowCount; ++r) {
+					a[r] = _mm_loadu_si128((const __m128i*)(rows[r] + i * 8));
+					b[r] = _mm_loadu_si128((const __m128i*)(rows[r] + i * 8 + 16));
+				}
+
+				__m128i res;
+
+				if constexpr (filter == MipFilter::LINEAR)
+					res = _mm_packus_epi16(averageRgba8<rowCount>(a), averageRgba8<rowCount>(b));
+
+				else {
+					constexpr bool isMax = filter == MipFilter::MAX;
+					res = _mm_unpacklo_epi64(minMaxRgba8<isMax, rowCount>(a), minMaxRgba8<isMax, rowCount>(b));
+				}
+
+				_mm_storeu_si128((__m128i*)(dst + i * 4), res);
+			}
+
+			reducePixels<u8, filter, false, 4, rowCount>(rows, dst, i, dstWidth, srcWidth);
+		}
+
+		//Pairwise like average, so it's the same in f32: ((r0 + r1) + (r2 + r3)) / n
+
+		template<usz rowCount>
+		inline void reduceRowRgba32f(const u8 *const *rows, u8 *dst, usz dstWidth, usz srcWidth) {
+
+			f32 *out = (f32*) dst;
+
+			const __m128 scale = _mm_set1_ps(1.f / (rowCount * 2));
+
+			usz i{};
+
+			for (; i < dstWidth && i * 2 + 2 <= srcWidth; ++i) {
+
+				__m128 pairs[rowCount];
+
+				for (usz r = 0; r < rowCount; ++r) {
+					const f32 *row = (const f32*) rows[r];
+					pairs[r] = _mm_add_ps(_mm_loadu_ps(row + i * 8), _mm_loadu_ps(row + i * 8 + 4));
+				}
+
+				__m128 sum = _mm_add_ps(pairs[0], pairs[1]);
+
+				if constexpr (rowCount == 4)
+					sum = _mm_add_ps(sum, _mm_add_ps(pairs[2], pairs[3]));
+
+				_mm_storeu_ps(out + i * 4, _mm_mul_ps(sum, scale));
+			}
+
+			reducePixels<f32, MipFilter::LINEAR, false, 4, rowCount>(rows, dst, i, dstWidth, srcWidth);
+		}
+
+		//Alpha weighted average of rgba8 (see averagePremultiplied), one output pixel at a time
+
+		template<usz rowCount>
+		inline void reduceRowRgba8Premultiplied(const u8 *const *rows, u8 *dst, usz dstWidth, usz srcWidth) {
+
+			constexpr usz n = rowCount * 2;
+
+			const __m128i zero = _mm_setzero_si128();
+			const __m128 zerof = _mm_setzero_ps(), half = _mm_set1_ps(.5f), scale = _mm_set1_ps(1.f / n);
+			const __m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+
+			usz i{};
+
+			for (; i < dstWidth && i * 2 + 2 <= srcWidth; ++i) {
+
+				//Every sum is exact in f32, so the order doesn't matter
+
+				__m128 weight = zerof, plain = zerof, sum = zerof;
+
+				for (usz r = 0; r < rowCount; ++r) {
+
+					__m128i pair = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(rows[r] + i * 8)), zero);
+
+					__m128 p0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(pair, zero));
+					__m128 p1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(pair, zero));
+
+					__m128 a0 = _mm_shuffle_ps(p0, p0, _MM_SHUFFLE(3, 3, 3, 3));
+					__m128 a1 = _mm_shuffle_ps(p1, p1, _MM_SHUFFLE(3, 3, 3, 3));
+
+					weight = _mm_add_ps(weight, _mm_add_ps(a0, a1));
+					plain = _mm_add_ps(plain, _mm_add_ps(p0, p1));
+					sum = _mm_add_ps(sum, _mm_add_ps(_mm_mul_ps(p0, a0), _mm_mul_ps(p1, a1)));
+				}
+
+				//Color is sum / weight (or the plain average if transparent), alpha is (sum + n / 2) / n
+
+				__m128 opaque = _mm_cmpgt_ps(weight, zerof);
+
+				__m128 color = _mm_or_ps(
+					_mm_and_ps(opaque, _mm_div_ps(sum, _mm_max_ps(weight, _mm_set1_ps(1)))),
+					_mm_andnot_ps(opaque, _mm_mul_ps(plain, scale))
+				);
+
+				color = _mm_add_ps(color, half);
+
+				__m128 alpha = _mm_mul_ps(_mm_add_ps(weight, _mm_set1_ps(f32(n / 2))), scale);
+				__m128 res = _mm_or_ps(_mm_andnot_ps(alphaMask, color), _mm_and_ps(alphaMask, alpha));
+
+				__m128i packed = _mm_cvttps_epi32(res);
+				packed = _mm_packus_epi16(_mm_packs_epi32(packed, packed), zero);
+
+				i32 pixel = _mm_cvtsi128_si32(packed);
+				std::memcpy(dst + i * 4, &pixel, 4);
+			}
+
+			reducePixels<u8, MipFilter::PREMULTIPLIED, false, 4, rowCount>(rows, dst, i, dstWidth, srcWidth);
+		}
+
+		template<typename T, usz rowCount>
+		inline RowKernel getRowKernelRgba(MipFilter filter) {
+
+			if constexpr (std::is_same_v<T, u8>)
+				switch (filter) {
+					case MipFilter::LINEAR:			return &reduceRowRgba8<MipFilter::LINEAR, rowCount>;
+					case MipFilter::MIN:			return &reduceRowRgba8<MipFilter::MIN, rowCount>;
+					case MipFilter::MAX:			return &reduceRowRgba8<MipFilter::MAX, rowCount>;
+					case MipFilter::PREMULTIPLIED:	return &reduceRowRgba8Premultiplied<rowCount>;
+					default:						break;
+				}
+
+			if constexpr (std::is_same_v<T, f32>)
+				if (filter == MipFilter::LINEAR)
+					return &reduceRowRgba32f<rowCount>;
+
+			return nullptr;
+		}
+
+	#endif
+
+	//Pick a row kernel
+
+	template<typename T, MipFilter filter, bool srgb>
+	inline RowKernel getRowKernel(usz C, bool is3D) {
+
+		static constexpr RowKernel kernels[2][4] = {
+			{
+				&reduceRow<T, filter, srgb, 1, 2>, &reduceRow<T, filter, srgb, 2, 2>,
+				&reduceRow<T, filter, srgb, 3, 2>, &reduceRow<T, filter, srgb, 4, 2>
+			},
+			{
+				&reduceRow<T, filter, srgb, 1, 4>, &reduceRow<T, filter, srgb, 2, 4>,
+				&reduceRow<T, filter, srgb, 3, 4>, &reduceRow<T, filter, srgb, 4, 4>
+			}
+		};
+
+		return kernels[is3D][C - 1];
+	}
+
+	template<typename T>
+	inline RowKernel getRowKernel(MipFilter filter, usz C, bool is3D) {
+
+		#ifdef IGXI_SSE2
+
+			if (C == 4)
+				if (RowKernel kernel = is3D ? getRowKernelRgba<T, 4>(filter) : getRowKernelRgba<T, 2>(filter))
+					return kernel;
+
+		#endif
+
+		switch (filter) {
+			case MipFilter::LINEAR:		return getRowKernel<T, MipFilter::LINEAR, false>(C, is3D);
+			case MipFilter::NEAREST:	return getRowKernel<T, MipFilter::NEAREST, false>(C, is3D);
+			case MipFilter::MIN:		return getRowKernel<T, MipFilter::MIN, false>(C, is3D);
+			case MipFilter::MAX:		return getRowKernel<T, MipFilter::MAX, false>(C, is3D);
+			default:					return getRowKernel<T, MipFilter::PREMULTIPLIED, false>(C, is3D);
+		}
+	}
+
+	inline RowKernel getRowKernel(GPUFormat format, MipFilter filter, bool is3D) {
+
+		usz stride = FormatHelper::getStrideBytes(format);
+
+		if (!stride)
+			return nullptr;
+
+		usz C = FormatHelper::getSizeBytes(format) / stride;
+
+		if (C - 1 >= 4)
+			return nullptr;
+
+		//sRGB has to be averaged in linear space, the rest doesn't care about gamma
+
+		if (format == GPUFormat::srgba8)
+			switch (filter) {
+				case MipFilter::LINEAR:			return getRowKernel<u8, MipFilter::LINEAR, true>(C, is3D);
+				case MipFilter::PREMULTIPLIED:	return getRowKernel<u8, MipFilter::PREMULTIPLIED, true>(C, is3D);
+				default:						return getRowKernel<u8>(filter, C, is3D);
+			}
+
+		switch (FormatHelper::getType(format)) {
+
+			case GPUFormatType::UNORM:
+			case GPUFormatType::UINT:
+
+				switch (stride) {
+					case 1:		return getRowKernel<u8>(filter, C, is3D);
+					case 2:		return getRowKernel<u16>(filter, C, is3D);
+					case 4:		return getRowKernel<u32>(filter, C, is3D);
+					case 8:		return getRowKernel<u64>(filter, C, is3D);
+					default:	return nullptr;
+				}
+
+			case GPUFormatType::SNORM:
+			case GPUFormatType::SINT:
+
+				switch (stride) {
+					case 1:		return getRowKernel<i8>(filter, C, is3D);
+					case 2:		return getRowKernel<i16>(filter, C, is3D);
+					case 4:		return getRowKernel<i32>(filter, C, is3D);
+					case 8:		return getRowKernel<i64>(filter, C, is3D);
+					default:	return nullptr;
+				}
+
+			case GPUFormatType::FLOAT:
+
+				switch (stride) {
+					case 2:		return getRowKernel<f16>(filter, C, is3D);
+					case 4:		return getRowKernel<f32>(filter, C, is3D);
+					case 8:		return getRowKernel<f64>(filter, C, is3D);
+					default:	return nullptr;
+				}
+
+			default:
+				return nullptr;
+		}
+	}
+
+	//Keep the alpha test coverage of the base mip by rescaling the alpha of a mip
+	//The coverage is the fraction of alpha >= alphaTestReference, so the scale is picked from a histogram of the mip:
+	//	the alpha at which the same fraction passes is moved onto the reference
+
+	static constexpr f32 alphaTestReference = .5f;
+
+	using CoverageKernel = void (*)(const u8 *base, usz baseCount, u8 *mip, usz count);
+
+	template<typename T>
+	inline void preserveCoverage(const u8 *base, usz baseCount, u8 *mip, usz count) {
+
+		constexpr bool isFloat = std::is_same_v<T, f16> || std::is_floating_point_v<T>;
+		constexpr usz bins = std::is_same_v<T, u8> ? 256 : 4096;
+
+		const f32 one = isFloat ? 1.f : f32(std::numeric_limits<T>::max());
+		const f32 reference = alphaTestReference * one;
+
+		const T *src = (const T*) base;
+		T *dst = (T*) mip;
+
+		usz covered{};
+
+		for (usz i = 0; i < baseCount; ++i)
+			covered += f32(src[i * 4 + 3]) >= reference;
+
+		usz target = usz((f64(covered) * count + baseCount / 2) / baseCount);
+
+		if (!target)
+			return;
+
+		List<usz> histogram(bins);
+
+		for (usz i = 0; i < count; ++i) {
+			f32 alpha = std::clamp(f32(dst[i * 4 + 3]) / one, 0.f, 1.f);
+			++histogram[usz(alpha * (bins - 1) + .5f)];
+		}
+
+		//Find the bin where the passed texels reach the target
+		//Many texels can share an alpha, so leaving that bin out (passing from the bin above it) can be closer
+
+		usz bin = bins - 1, passed{};
+
+		for (; bin > 0; --bin)
+			if ((passed += histogram[bin]) >= target)
+				break;
+
+		if (!bin)
+			return;
+
+		usz threshold = target - (passed - histogram[bin]) < passed - target ? bin + 1 : bin;
+
+		//The lower edge of the threshold bin is moved onto the reference, so the texels of that bin pass
+		//	(moving the bin itself there can round them just under it)
+
+		f32 scale = alphaTestReference * (bins - 1) / (threshold - .5f);
+
+		for (usz i = 0; i < count; ++i) {
+
+			f32 alpha = std::min(f32(dst[i * 4 + 3]) * scale, one);
+			T &a = dst[i * 4 + 3];
+
+			if constexpr (std::is_same_v<T, f16>)
+				a = ConvertPrimitive<f16, f32>::apply(alpha);
+
+			else if constexpr (isFloat)
+				a = T(alpha);
+
+			else a = T(alpha + .5f);
+		}
+	}
+
+	inline CoverageKernel getCoverageKernel(GPUFormat format) {
+
+		switch (FormatHelper::getType(format)) {
+
+			case GPUFormatType::UNORM:
+
+				switch (FormatHelper::getStrideBytes(format)) {
+					case 1:		return &preserveCoverage<u8>;
+					case 2:		return &preserveCoverage<u16>;
+					default:	return nullptr;
+				}
+
+			case GPUFormatType::FLOAT:
+
+				switch (FormatHelper::getStrideBytes(format)) {
+					case 2:		return &preserveCoverage<f16>;
+					case 4:		return &preserveCoverage<f32>;
+					case 8:		return &preserveCoverage<f64>;
+					default:	return nullptr;
+				}
+
+			default:
+				return nullptr;
+		}
+	}
+
+	//Generate the mip chain
+
+	//TODO: Report progress so you can see how much has been converted
+
+	Helper::ErrorMessage generateMips(IGXI &out, u16 formatId, Helper::Flags flags, u32 threads) {
+
+		if (formatId >= out.header.formats || formatId >= out.data.size())
+			return Helper::INVALID_RESOURCE_INDEX;
+
+		MipFilter filter;
+
+		switch (flags & (Helper::MIP_NEAREST | Helper::MIP_MIN | Helper::MIP_MAX | Helper::MIP_GGX)) {
+			case Helper::MIP_LINEAR:	filter = MipFilter::LINEAR;		break;
+			case Helper::MIP_NEAREST:	filter = MipFilter::NEAREST;	break;
+			case Helper::MIP_MIN:		filter = MipFilter::MIN;		break;
+			case Helper::MIP_MAX:		filter = MipFilter::MAX;		break;
+
+			case Helper::MIP_GGX:
+
+				if (flags & (Helper::MIP_PREMULTIPLY | Helper::MIP_PRESERVE_COVERAGE))
+					return Helper::INVALID_MIP_FILTER;
+
+				return prefilterCube(out, formatId, threads);
+
+			default:
+				return Helper::INVALID_MIP_FILTER;
+		}
+
+		ResampleFilter resampleFilter;
+
+		if (Helper::ErrorMessage msg = getResampleFilter(flags, resampleFilter))
+			return msg;
+
+		bool resampled = resampleFilter != ResampleFilter::NONE;
+
+		if (resampled && filter != MipFilter::LINEAR)
+			return Helper::INVALID_MIP_FILTER;
+
+		if (flags & Helper::MIP_PREMULTIPLY) {
+
+			if (filter != MipFilter::LINEAR || resampled)
+				return Helper::INVALID_MIP_FILTER;
+
+			filter = MipFilter::PREMULTIPLIED;
+		}
+
+		GPUFormat format = out.format[formatId];
+
+		bool is3D = out.header.type == TextureType::TEXTURE_3D;
+
+		if (resampled && is3D)
+			return Helper::INVALID_MIP_FILTER;
+
+		RowKernel kernel = resampled ? nullptr : getRowKernel(format, filter, is3D);
+
+		if (resampled ? !canResample(format) : !kernel)
+			return Helper::INVALID_FORMAT;
+
+		List<Buffer> &data = out.data[formatId];
+
+		usz mips = std::min(usz(out.header.mips), data.size());
+		usz stride = FormatHelper::getSizeBytes(format);
+		usz layers = out.header.layers;
+
+		//Alpha test coverage only applies to formats with alpha
+
+		CoverageKernel coverage{};
+
+		if (flags & Helper::MIP_PRESERVE_COVERAGE && stride == FormatHelper::getStrideBytes(format) * 4)
+			if (!(coverage = getCoverageKernel(format)))
+				return Helper::INVALID_FORMAT;
+
+		List<Array<u16, 3>> dims(mips);
+		dims[0] = { out.header.width, out.header.height, out.header.length };
+
+		for (usz i = 1; i < mips; ++i)
+			for (usz j = 0; j < 3; ++j)
+				dims[i][j] = u16((dims[i - 1][j] + 1) / 2);
+
+		//Reduce a range of rows of a mip from the previous mip
+		//Rows are ordered (layer, z, y)
+
+		auto reduceRows = [&](usz mip, usz begin, usz end) {
+
+			const Array<u16, 3> &src = dims[mip - 1], &dst = dims[mip];
+
+			const u8 *srcData = data[mip - 1].data();
+			u8 *dstData = data[mip].data();
+
+			usz srcRow = usz(src[0]) * stride, dstRow = usz(dst[0]) * stride;
+
+			for (usz row = begin; row < end; ++row) {
+
+				usz y = row % dst[1], z = row / dst[1] % dst[2], layer = row / dst[1] / dst[2];
+
+				usz y0 = y * 2, y1 = std::min(y0 + 1, usz(src[1]) - 1);
+				usz z0 = z * 2, z1 = std::min(z0 + 1, usz(src[2]) - 1);
+
+				auto srcAt = [&](usz zz, usz yy) {
+					return srcData + ((layer * src[2] + zz) * src[1] + yy) * srcRow;
+				};
+
+				const u8 *rows[4] = { srcAt(z0, y0), srcAt(z0, y1), srcAt(z1, y0), srcAt(z1, y1) };
+				kernel(rows, dstData + row * dstRow, dst[0], src[0]);
+			}
+		};
+
+		//Rescale the alpha of a mip of a layer; every mip is filtered from the unscaled previous one
+
+		auto keepCoverage = [&](usz mip, usz layer) {
+
+			usz baseCount = usz(dims[0][0]) * dims[0][1] * dims[0][2];
+			usz count = usz(dims[mip][0]) * dims[mip][1] * dims[mip][2];
+
+			coverage(
+				data[0].data() + layer * baseCount * stride, baseCount,
+				data[mip].data() + layer * count * stride, count
+			);
+		};
+
+		for (usz mip = 1; mip < mips; ++mip)
+			if (data[mip].size() < usz(dims[mip][0]) * dims[mip][1] * dims[mip][2] * layers * stride)
+				return Helper::INVALID_IMAGE_SIZE;
+
+		//Resample every layer of a mip from the previous one; resample splits the rows over the threads
+
+		if (resampled) {
+
+			for (usz mip = 1; mip < mips; ++mip) {
+
+				const Array<u16, 3> &src = dims[mip - 1], &dst = dims[mip];
+
+				usz srcLayer = usz(src[0]) * src[1] * stride, dstLayer = usz(dst[0]) * dst[1] * stride;
+
+				for (usz layer = 0; layer < layers; ++layer)
+					if (Helper::ErrorMessage msg = resample(
+						data[mip - 1].data() + layer * srcLayer, src[0], src[1],
+						data[mip].data() + layer * dstLayer, dst[0], dst[1],
+						format, resampleFilter, threads
+					))
+						return msg;
+			}
+
+			if (coverage)
+				parallelFor(layers * (mips - 1), threads, [&](usz i) {
+					keepCoverage(i % (mips - 1) + 1, i / (mips - 1));
+				});
+
+			return Helper::SUCCESS;
+		}
+
+		//Enough layers to keep every thread busy; one layer's full chain per job
+
+		if (layers >= getThreadCount(threads, u32_MAX)) {
+
+			parallelFor(layers, threads, [&](usz layer) {
+
+				for (usz mip = 1; mip < mips; ++mip) {
+					usz rows = usz(dims[mip][1]) * dims[mip][2];
+					reduceRows(mip, layer * rows, (layer + 1) * rows);
+				}
+
+				if (coverage)
+					for (usz mip = 1; mip < mips; ++mip)
+						keepCoverage(mip, layer);
+			});
+
+			return Helper::SUCCESS;
+		}
+
+		//Otherwise split every mip into bands of rows
+
+		constexpr usz band = 16;
+
+		for (usz mip = 1; mip < mips; ++mip) {
+
+			usz rows = usz(dims[mip][1]) * dims[mip][2] * layers;
+
+			parallelFor((rows + band - 1) / band, threads, [&](usz i) {
+				reduceRows(mip, i * band, std::min((i + 1) * band, rows));
+			});
+		}
+
+		if (coverage)
+			parallelFor(layers * (mips - 1), threads, [&](usz i) {
+				keepCoverage(i % (mips - 1) + 1, i / (mips - 1));
+			});
+
+		return Helper::SUCCESS;
+	}
+
+}
\ No newline at end of file
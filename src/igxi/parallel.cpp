@@ -0,0 +1,117 @@
+#include "igxi/parallel.hpp"
+#include <algorithm>
+
+namespace igxi {
+
+	ThreadPool &ThreadPool::get() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+	ThreadPool::ThreadPool() {
+
+		u32 count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+		workers.reserve(count);
+
+		for (u32 i = 0; i < count; ++i)
+			workers.emplace_back([this]() { work(); });
+	}
+
+	ThreadPool::~ThreadPool() {
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+
+		wake.notify_all();
+
+		for (std::thread &t : workers)
+			t.join();
+	}
+
+	ThreadPool::Loop *ThreadPool::find() {
+
+		for (usz i = loops.size(); i > 0; --i) {
+
+			Loop *loop = loops[i - 1];
+
+			if (loop->helpers < loop->maxHelpers && loop->next.load(std::memory_order_relaxed) < loop->count)
+				return loop;
+		}
+
+		return nullptr;
+	}
+
+	void ThreadPool::execute(Loop &loop) {
+
+		for (usz i; (i = loop.next.fetch_add(1, std::memory_order_relaxed)) < loop.count; )
+			try {
+				loop.call(loop.func, i);
+			}
+
+			//Keep the first exception and stop handing out indices; run() rethrows it on the calling thread
+
+			catch (...) {
+
+				std::lock_guard<std::mutex> lock(mutex);
+
+				if (!loop.error)
+					loop.error = std::current_exception();
+
+				loop.next.store(loop.count, std::memory_order_relaxed);
+			}
+	}
+
+	void ThreadPool::work() {
+
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (true) {
+
+			Loop *loop{};
+			wake.wait(lock, [&]() { return stop || (loop = find()); });
+
+			if (!loop)
+				return;
+
+			++loop->helpers;
+			lock.unlock();
+
+			execute(*loop);
+
+			lock.lock();
+
+			if (!--loop->helpers)
+				finished.notify_all();
+		}
+	}
+
+	void ThreadPool::run(usz count, u32 threads, Call call, const void *func) {
+
+		Loop loop{ count, {}, call, func, 0, std::min(threads, size()) - 1, {} };
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			loops.push_back(&loop);
+		}
+
+		if (loop.maxHelpers == 1)
+			wake.notify_one();
+
+		else wake.notify_all();
+
+		execute(loop);
+
+		//Every index is taken; once no other thread is still running one, the loop can be removed
+
+		std::unique_lock<std::mutex> lock(mutex);
+		loops.erase(std::find(loops.begin(), loops.end(), &loop));
+		finished.wait(lock, [&]() { return !loop.helpers; });
+		lock.unlock();
+
+		if (loop.error)
+			std::rethrow_exception(loop.error);
+	}
+
+}
@@ -0,0 +1,495 @@
+#include "igxi/png.hpp"
+#include <bit>
+#include <cstring>
+
+namespace igxi {
+
+	//Checksums
+
+	struct CRCTable {
+
+		u32 table[256];
+
+		constexpr CRCTable(): table{} {
+			for (u32 i = 0; i < 256; ++i) {
+
+				u32 c = i;
+
+				for (u32 j = 0; j < 8; ++j)
+					c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+
+				table[i] = c;
+			}
+		}
+	};
+
+	static constexpr CRCTable crcTable{};
+
+	inline u32 crc32(const u8 *data, usz size, u32 crc = 0) {
+
+		crc = ~crc;
+
+		for (usz i = 0; i < size; ++i)
+			crc = crcTable.table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+		return ~crc;
+	}
+
+	inline u32 adler32(const u8 *data, usz size) {
+
+		u32 a = 1, b = 0;
+
+		//5552 is the most bytes that can be summed before b can overflow
+
+		while (size) {
+
+			usz n = std::min(size, usz(5552));
+			size -= n;
+
+			for (usz i = 0; i < n; ++i) {
+				a += data[i];
+				b += a;
+			}
+
+			a %= 65521;
+			b %= 65521;
+			data += n;
+		}
+
+		return (b << 16) | a;
+	}
+
+	inline void writeBE(Buffer &out, u32 v) {
+		out.push_back(u8(v >> 24));
+		out.push_back(u8(v >> 16));
+		out.push_back(u8(v >> 8));
+		out.push_back(u8(v));
+	}
+
+	inline void writeChunk(Buffer &out, const char *type, const u8 *data, usz size) {
+
+		writeBE(out, u32(size));
+
+		usz start = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data, data + size);
+
+		writeBE(out, crc32(out.data() + start, size + 4));
+	}
+
+	//Filters
+
+	inline u8 paeth(i32 a, i32 b, i32 c) {
+
+		i32 p = a + b - c;
+		i32 pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+
+		if (pa <= pb && pa <= pc)
+			return u8(a);
+
+		return u8(pb <= pc ? b : c);
+	}
+
+	//Filters; prev is null for the first row
+
+	inline u8 predict(u8 filter, const u8 *row, const u8 *prev, usz i, usz bpp) {
+
+		u8 a = i >= bpp ? row[i - bpp] : 0;
+		u8 b = prev ? prev[i] : 0;
+		u8 c = prev && i >= bpp ? prev[i - bpp] : 0;
+
+		switch (filter) {
+			case 1:		return a;
+			case 2:		return b;
+			case 3:		return u8((u32(a) + b) >> 1);
+			case 4:		return paeth(a, b, c);
+			default:	return 0;
+		}
+	}
+
+	inline void filterRow(u8 filter, const u8 *row, const u8 *prev, usz size, usz bpp, u8 *out) {
+		for (usz i = 0; i < size; ++i)
+			out[i] = u8(row[i] - predict(filter, row, prev, i, bpp));
+	}
+
+	//Sum of the absolute (signed) values; lower generally compresses better
+
+	inline u64 filterCost(const u8 *row, usz size) {
+
+		u64 cost{};
+
+		for (usz i = 0; i < size; ++i)
+			cost += u64(std::abs(i32(i8(row[i]))));
+
+		return cost;
+	}
+
+	//Estimate the best filter from every 4th pixel, instead of filtering the row 5 times
+
+	inline u8 guessFilter(const u8 *row, const u8 *prev, usz size, usz bpp) {
+
+		u8 best{};
+		u64 bestCost{};
+
+		for (u8 filter = 0; filter < 5; ++filter) {
+
+			u64 cost{};
+
+			for (usz i = 0; i < size; i += bpp * 4)
+				for (usz j = i, end = std::min(i + bpp, size); j < end; ++j)
+					cost += u64(std::abs(i32(i8(row[j] - predict(filter, row, prev, j, bpp)))));
+
+			if (!filter || cost < bestCost) {
+				bestCost = cost;
+				best = filter;
+			}
+		}
+
+		return best;
+	}
+
+	//Deflate without compression; blocks of up to 65535 bytes
+
+	inline void storeZlib(const u8 *data, usz size, Buffer &out) {
+
+		out.push_back(0x78);
+		out.push_back(0x01);
+
+		usz offset{};
+
+		do {
+
+			usz n = std::min(size - offset, usz(65535));
+			bool last = offset + n == size;
+
+			out.push_back(u8(last));
+			out.push_back(u8(n));
+			out.push_back(u8(n >> 8));
+			out.push_back(u8(~n));
+			out.push_back(u8(~n >> 8));
+
+			out.insert(out.end(), data + offset, data + offset + n);
+			offset += n;
+
+		} while (offset != size);
+
+		writeBE(out, adler32(data, size));
+	}
+
+	//Fast deflate; one block with the fixed Huffman codes and greedy matches
+	//"Depth" is how many earlier positions with the same hash are checked per match
+
+	struct BitWriter {
+
+		Buffer &out;
+		u64 bits{};
+		u32 count{};
+
+		inline void write(u32 v, u32 n) {
+
+			bits |= u64(v) << count;
+			count += n;
+
+			while (count >= 8) {
+				out.push_back(u8(bits));
+				bits >>= 8;
+				count -= 8;
+			}
+		}
+
+		inline void flush() {
+
+			if (count)
+				out.push_back(u8(bits));
+
+			bits = count = 0;
+		}
+	};
+
+	//Huffman codes are stored starting at the most significant bit, so they're reversed for the bit writer
+
+	static constexpr u32 reverseBits(u32 v, u32 n) {
+
+		u32 r{};
+
+		for (u32 i = 0; i < n; ++i, v >>= 1)
+			r = (r << 1) | (v & 1);
+
+		return r;
+	}
+
+	struct FixedCodes {
+
+		u16 code[288];
+		u8 length[288];
+
+		constexpr FixedCodes(): code{}, length{} {
+			for (u32 i = 0; i < 288; ++i) {
+
+				u32 c, n;
+
+				if (i < 144)		{ c = 0x30 + i;				n = 8; }
+				else if (i < 256)	{ c = 0x190 + i - 144;		n = 9; }
+				else if (i < 280)	{ c = i - 256;				n = 7; }
+				else				{ c = 0xC0 + i - 280;		n = 8; }
+
+				code[i] = u16(reverseBits(c, n));
+				length[i] = u8(n);
+			}
+		}
+	};
+
+	static constexpr FixedCodes fixedCodes{};
+
+	inline void writeSymbol(BitWriter &bits, u32 symbol) {
+		bits.write(fixedCodes.code[symbol], fixedCodes.length[symbol]);
+	}
+
+	inline void writeMatch(BitWriter &bits, u32 length, u32 distance) {
+
+		//Length 3-258; symbols 257-264 have no extra bits and every next 4 have one more
+
+		u32 x = length - 3;
+
+		if (length == 258)
+			writeSymbol(bits, 285);
+
+		else if (x < 8)
+			writeSymbol(bits, 257 + x);
+
+		else {
+			u32 n = u32(std::bit_width(x)) - 1;
+			writeSymbol(bits, 257 + 4 * (n - 1) + ((x >> (n - 2)) & 3));
+			bits.write(x & ((1u << (n - 2)) - 1), n - 2);
+		}
+
+		//Distance 1-32768; codes 0-3 have no extra bits and every next 2 have one more
+
+		x = distance - 1;
+
+		if (x < 4)
+			bits.write(reverseBits(x, 5), 5);
+
+		else {
+			u32 n = u32(std::bit_width(x)) - 1;
+			bits.write(reverseBits(2 * n + ((x >> (n - 1)) & 1), 5), 5);
+			bits.write(x & ((1u << (n - 1)) - 1), n - 1);
+		}
+	}
+
+	inline void fastZlib(const u8 *data, usz size, u32 depth, Buffer &out) {
+
+		static constexpr usz window = 32768, minMatch = 3, maxMatch = 258;
+		static constexpr u32 hashBits = 15;
+
+		out.push_back(0x78);
+		out.push_back(0x01);
+
+		BitWriter bits{ out };
+		bits.write(1, 1);		//Last block
+		bits.write(1, 2);		//Fixed codes
+
+		//Positions are stored +1, so 0 means none; prev chains the earlier positions with the same hash
+
+		List<u32> head(usz(1) << hashBits), prev(window);
+
+		auto hashAt = [data](usz i) -> u32 {
+			u32 v = u32(data[i]) | (u32(data[i + 1]) << 8) | (u32(data[i + 2]) << 16);
+			return (v * 0x9E3779B1) >> (32 - hashBits);
+		};
+
+		auto insert = [&](usz i) {
+			u32 &h = head[hashAt(i)];
+			prev[i & (window - 1)] = h;
+			h = u32(i + 1);
+		};
+
+		usz i{};
+
+		while (i + minMatch <= size) {
+
+			usz bestLength{}, bestDistance{};
+			usz limit = std::min(maxMatch, size - i);
+
+			u32 candidate = head[hashAt(i)];
+
+			for (u32 tries = 0; candidate && tries < depth; ++tries) {
+
+				usz j = candidate - 1;
+
+				if (i - j > window)
+					break;
+
+				usz length{};
+
+				while (length < limit && data[j + length] == data[i + length])
+					++length;
+
+				if (length > bestLength) {
+
+					bestLength = length;
+					bestDistance = i - j;
+
+					if (length == limit)
+						break;
+				}
+
+				u32 next = prev[j & (window - 1)];
+
+				//The slot can be reused by a newer position once the chain is longer than the window
+
+				if (next >= candidate)
+					break;
+
+				candidate = next;
+			}
+
+			if (bestLength >= minMatch) {
+
+				writeMatch(bits, u32(bestLength), u32(bestDistance));
+
+				for (usz j = i, end = std::min(i + bestLength, size - minMatch + 1); j < end; ++j)
+					insert(j);
+
+				i += bestLength;
+				continue;
+			}
+
+			insert(i);
+			writeSymbol(bits, data[i]);
+			++i;
+		}
+
+		for (; i < size; ++i)
+			writeSymbol(bits, data[i]);
+
+		writeSymbol(bits, 256);
+		bits.flush();
+
+		writeBE(out, adler32(data, size));
+	}
+
+	Buffer encodePNG(const u8 *rows, i64 rowStride, u16 width, u16 height, u8 channels, u8 bytesPerChannel, u8 level) {
+
+		static constexpr u8 colorTypes[] = { 0, 4, 2, 6 };
+
+		if (!width || !height || !channels || channels > 4 || (bytesPerChannel != 1 && bytesPerChannel != 2))
+			return {};
+
+		usz bpp = usz(channels) * bytesPerChannel;
+		usz rowSize = bpp * width;
+
+		//Every row starts with its filter type
+
+		usz filteredSize = (rowSize + 1) * height;
+
+		//stb can only address up to INT_MAX bytes
+
+		if (filteredSize > usz(u32_MAX >> 1))
+			return {};
+
+		Buffer filtered(filteredSize);
+		Buffer swapped(bytesPerChannel == 2 ? rowSize * 2 : 0);
+		Buffer candidate(level == 9 ? rowSize : 0);
+
+		const u8 *prev{};
+
+		for (u16 y = 0; y < height; ++y) {
+
+			const u8 *row = rows + i64(y) * rowStride;
+
+			//PNG is big endian; alternate between two rows, so the previous one is kept
+
+			if (bytesPerChannel == 2) {
+
+				u8 *dst = swapped.data() + (y & 1) * rowSize;
+
+				for (usz i = 0; i < rowSize; i += 2) {
+					dst[i] = row[i + 1];
+					dst[i + 1] = row[i];
+				}
+
+				row = dst;
+			}
+
+			u8 *out = filtered.data() + usz(y) * (rowSize + 1);
+
+			if (!level) {
+				out[0] = 0;
+				std::memcpy(out + 1, row, rowSize);
+			}
+
+			//Paeth is a good fit for most images, so it's used when there's no time to pick a filter
+
+			else if (level == 1) {
+				out[0] = 4;
+				filterRow(4, row, prev, rowSize, bpp, out + 1);
+			}
+
+			//Only the highest level tries every filter on the whole row
+
+			else if (level < 9) {
+				out[0] = guessFilter(row, prev, rowSize, bpp);
+				filterRow(out[0], row, prev, rowSize, bpp, out + 1);
+			}
+
+			else {
+
+				u64 bestCost{};
+
+				for (u8 filter = 0; filter < 5; ++filter) {
+
+					filterRow(filter, row, prev, rowSize, bpp, candidate.data());
+
+					u64 cost = filterCost(candidate.data(), rowSize);
+
+					if (!filter || cost < bestCost) {
+						bestCost = cost;
+						out[0] = filter;
+						std::memcpy(out + 1, candidate.data(), rowSize);
+					}
+				}
+			}
+
+			prev = row;
+		}
+
+		//Compress
+
+		Buffer idat;
+
+		if (!level)
+			storeZlib(filtered.data(), filtered.size(), idat);
+
+		else if (level < 4)
+			fastZlib(filtered.data(), filtered.size(), 1u << (2 * (level - 1)), idat);
+
+		else {
+
+			//stb's quality is the length of the hash chains it searches (it uses at least 5)
+
+			if (!stbZlib(filtered.data(), filtered.size(), level * 2, idat))
+				return {};
+		}
+
+		//Write chunks
+
+		static constexpr u8 signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+		Buffer png(signature, signature + sizeof(signature));
+		png.reserve(sizeof(signature) + 12 * 3 + 13 + idat.size());
+
+		u8 header[13]{};
+		header[2] = u8(width >> 8);		header[3] = u8(width);
+		header[6] = u8(height >> 8);	header[7] = u8(height);
+		header[8] = u8(bytesPerChannel * 8);
+		header[9] = colorTypes[channels - 1];
+
+		writeChunk(png, "IHDR", header, sizeof(header));
+		writeChunk(png, "IDAT", idat.data(), idat.size());
+		writeChunk(png, "IEND", nullptr, 0);
+
+		return png;
+	}
+
+}
@@ -0,0 +1,461 @@
+#include "igxi/prefilter.hpp"
+#include "igxi/cube.hpp"
+#include "igxi/kernels.hpp"
+#include "igxi/parallel.hpp"
+
+using namespace ignis;
+
+namespace igxi {
+
+	static constexpr f32 pi = 3.14159265358979f;
+
+	//Texels to and from rgba f32 (missing channels are 0, missing alpha is 1)
+
+	using LoadTexels = void (*)(const u8 *src, f32 *dst, usz count);
+	using StoreTexels = void (*)(const f32 *src, u8 *dst, usz count);
+
+	template<typename T, usz C>
+	inline void loadTexels(const u8 *src, f32 *dst, usz count) {
+
+		const T *s = (const T*) src;
+
+		for (usz i = 0; i < count; ++i)
+			for (usz c = 0; c < 4; ++c)
+				dst[i * 4 + c] = c < C ? f32(s[i * C + c]) : (c == 3 ? 1.f : 0.f);
+	}
+
+	template<typename T, usz C>
+	inline void storeTexels(const f32 *src, u8 *dst, usz count) {
+
+		T *d = (T*) dst;
+
+		for (usz i = 0; i < count; ++i)
+			for (usz c = 0; c < C; ++c)
+				if constexpr (std::is_same_v<T, f16>)
+					d[i * C + c] = ConvertPrimitive<f16, f32>::apply(src[i * 4 + c]);
+
+				else d[i * C + c] = T(src[i * 4 + c]);
+	}
+
+	template<typename T>
+	inline bool getTexelKernels(usz C, LoadTexels &load, StoreTexels &store) {
+
+		static constexpr LoadTexels loads[4] = {
+			&loadTexels<T, 1>, &loadTexels<T, 2>, &loadTexels<T, 3>, &loadTexels<T, 4>
+		};
+
+		static constexpr StoreTexels stores[4] = {
+			&storeTexels<T, 1>, &storeTexels<T, 2>, &storeTexels<T, 3>, &storeTexels<T, 4>
+		};
+
+		load = loads[C - 1];
+		store = stores[C - 1];
+		return true;
+	}
+
+	//Only float formats; HDR data is what needs prefiltering and unorm would clip the result anyway
+
+	inline bool getTexelKernels(GPUFormat format, LoadTexels &load, StoreTexels &store) {
+
+		usz stride = FormatHelper::getStrideBytes(format);
+
+		if (!stride || FormatHelper::getType(format) != GPUFormatType::FLOAT)
+			return false;
+
+		usz C = FormatHelper::getSizeBytes(format) / stride;
+
+		if (C - 1 >= 4)
+			return false;
+
+		switch (stride) {
+			case 2:		return getTexelKernels<f16>(C, load, store);
+			case 4:		return getTexelKernels<f32>(C, load, store);
+			default:	return false;
+		}
+	}
+
+	inline bool isCube(const IGXI &igxi) {
+		return (u8(igxi.header.type) & ~u8(TextureType::PROPERTY_IS_ARRAY)) == u8(TextureType::TEXTURE_CUBE);
+	}
+
+	//Validate a cube in the given format and get its texel kernels
+
+	inline Helper::ErrorMessage getCubeKernels(const IGXI &igxi, u16 formatId, LoadTexels &load, StoreTexels &store) {
+
+		if (formatId >= igxi.header.formats || formatId >= igxi.data.size() || igxi.data[formatId].empty())
+			return Helper::INVALID_RESOURCE_INDEX;
+
+		if (!isCube(igxi) || igxi.header.layers % 6 || igxi.header.width != igxi.header.height)
+			return Helper::INVALID_TYPE;
+
+		if (igxi.header.length != 1)
+			return Helper::INVALID_TYPE;
+
+		if (!getTexelKernels(igxi.format[formatId], load, store))
+			return Helper::INVALID_FORMAT;
+
+		usz size = igxi.header.width;
+		usz stride = FormatHelper::getSizeBytes(igxi.format[formatId]);
+
+		if (igxi.data[formatId][0].size() < size * size * igxi.header.layers * stride)
+			return Helper::INVALID_IMAGE_SIZE;
+
+		return Helper::SUCCESS;
+	}
+
+	//One cube as rgba f32 with a box filtered chain, to pick samples from by solid angle
+	//Every mip is laid out as [face][y][x][4]
+
+	struct RadianceCube {
+
+		List<List<f32>> mips;
+		List<usz> sizes;
+
+		//Bilinear sample of one mip, clamped to the face
+
+		inline void sample(usz mip, const f32 *dir, f32 *res) const {
+
+			f32 s, t;
+			u8 face = getCubeFace(dir, s, t);
+
+			usz size = sizes[mip];
+			const f32 *texels = mips[mip].data() + face * size * size * 4;
+
+			f32 fx = std::clamp((s + 1) * .5f * size - .5f, 0.f, f32(size - 1));
+			f32 fy = std::clamp((t + 1) * .5f * size - .5f, 0.f, f32(size - 1));
+
+			usz x0 = usz(fx), y0 = usz(fy);
+			usz x1 = std::min(x0 + 1, size - 1), y1 = std::min(y0 + 1, size - 1);
+
+			f32 wx = fx - x0, wy = fy - y0;
+
+			const f32 *p00 = texels + (y0 * size + x0) * 4, *p01 = texels + (y0 * size + x1) * 4;
+			const f32 *p10 = texels + (y1 * size + x0) * 4, *p11 = texels + (y1 * size + x1) * 4;
+
+			for (usz c = 0; c < 4; ++c)
+				res[c] =
+					(p00[c] * (1 - wx) + p01[c] * wx) * (1 - wy) +
+					(p10[c] * (1 - wx) + p11[c] * wx) * wy;
+		}
+
+		//Trilinear sample between two mips
+
+		inline void sample(f32 lod, const f32 *dir, f32 *res) const {
+
+			usz mip = usz(lod);
+
+			sample(mip, dir, res);
+
+			if (mip + 1 >= mips.size())
+				return;
+
+			f32 w = lod - mip, next[4];
+			sample(mip + 1, dir, next);
+
+			for (usz c = 0; c < 4; ++c)
+				res[c] += (next[c] - res[c]) * w;
+		}
+	};
+
+	//A sample of the GGX lobe around +z (N = V) and the mip it should be read from
+
+	struct LobeSample {
+		f32 dir[3], weight, lod;
+	};
+
+	inline f32 radicalInverse(u32 i) {
+
+		i = (i << 16) | (i >> 16);
+		i = ((i & 0x55555555) << 1) | ((i & 0xAAAAAAAA) >> 1);
+		i = ((i & 0x33333333) << 2) | ((i & 0xCCCCCCCC) >> 2);
+		i = ((i & 0x0F0F0F0F) << 4) | ((i & 0xF0F0F0F0) >> 4);
+		i = ((i & 0x00FF00FF) << 8) | ((i & 0xFF00FF00) >> 8);
+
+		return f32(i) * 2.3283064365386963e-10f;
+	}
+
+	//Hammersley points mapped to half vectors of the lobe and reflected around them
+	//The samples are the same for every texel, so they're made once per mip
+
+	inline List<LobeSample> getLobeSamples(f32 roughness, u32 count, usz baseSize, usz mips) {
+
+		f32 a = roughness * roughness, a2 = a * a;
+
+		//Solid angle of a texel of mip 0
+
+		f32 texelAngle = 4 * pi / (6.f * baseSize * baseSize);
+
+		List<LobeSample> samples;
+		samples.reserve(count);
+
+		for (u32 i = 0; i < count; ++i) {
+
+			f32 phi = 2 * pi * (i + .5f) / count;
+			f32 xi = radicalInverse(i);
+
+			f32 cosTheta = std::sqrt((1 - xi) / (1 + (a2 - 1) * xi));
+			f32 sinTheta = std::sqrt(std::max(1 - cosTheta * cosTheta, 0.f));
+
+			//L = 2 * dot(N, H) * H - N, with N = (0, 0, 1)
+
+			f32 h[3] = { sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta };
+
+			LobeSample sample{ { 2 * cosTheta * h[0], 2 * cosTheta * h[1], 2 * cosTheta * h[2] - 1 }, 0, 0 };
+
+			f32 nDotL = sample.dir[2];
+
+			if (nDotL <= 0)
+				continue;
+
+			//pdf(L) = D(H) * NdotH / (4 * VdotH) = D(H) / 4, since N = V
+
+			f32 d = a2 / std::max(pi * std::pow(cosTheta * cosTheta * (a2 - 1) + 1, 2.f), 1e-20f);
+			f32 sampleAngle = 1 / (count * d * .25f + 1e-20f);
+
+			sample.weight = nDotL;
+			sample.lod = std::clamp(.5f * std::log2(sampleAngle / texelAngle) + 1, 0.f, f32(mips - 1));
+
+			samples.push_back(sample);
+		}
+
+		return samples;
+	}
+
+	Helper::ErrorMessage prefilterCube(IGXI &out, u16 formatId, u32 threads, u32 samples) {
+
+		LoadTexels load;
+		StoreTexels store;
+
+		if (Helper::ErrorMessage msg = getCubeKernels(out, formatId, load, store))
+			return msg;
+
+		List<Buffer> &data = out.data[formatId];
+
+		usz mips = std::min(usz(out.header.mips), data.size());
+		usz cubes = out.header.layers / 6;
+		usz stride = FormatHelper::getSizeBytes(out.format[formatId]);
+
+		if (mips <= 1 || !samples)
+			return Helper::SUCCESS;
+
+		List<usz> sizes(mips);
+		sizes[0] = out.header.width;
+
+		for (usz mip = 1; mip < mips; ++mip)
+			sizes[mip] = (sizes[mip - 1] + 1) / 2;
+
+		for (usz mip = 1; mip < mips; ++mip)
+			if (data[mip].size() < sizes[mip] * sizes[mip] * out.header.layers * stride)
+				return Helper::INVALID_IMAGE_SIZE;
+
+		List<List<LobeSample>> lobes(mips);
+
+		for (usz mip = 1; mip < mips; ++mip)
+			lobes[mip] = getLobeSamples(f32(mip) / (mips - 1), samples, sizes[0], mips);
+
+		for (usz cube = 0; cube < cubes; ++cube) {
+
+			//Box filter the chain of the cube
+
+			RadianceCube radiance{ List<List<f32>>(mips), sizes };
+
+			for (usz mip = 0; mip < mips; ++mip)
+				radiance.mips[mip].resize(6 * sizes[mip] * sizes[mip] * 4);
+
+			usz faceTexels = sizes[0] * sizes[0];
+
+			parallelFor(6, threads, [&](usz face) {
+				load(
+					data[0].data() + ((cube * 6 + face) * faceTexels) * stride,
+					radiance.mips[0].data() + face * faceTexels * 4,
+					faceTexels
+				);
+			});
+
+			for (usz mip = 1; mip < mips; ++mip) {
+
+				usz src = sizes[mip - 1], dst = sizes[mip];
+
+				const f32 *prev = radiance.mips[mip - 1].data();
+				f32 *next = radiance.mips[mip].data();
+
+				parallelFor(6 * dst, threads, [&](usz row) {
+
+					usz face = row / dst, y = row % dst;
+					usz y0 = y * 2, y1 = std::min(y0 + 1, src - 1);
+
+					for (usz x = 0; x < dst; ++x) {
+
+						usz x0 = x * 2, x1 = std::min(x0 + 1, src - 1);
+
+						const f32 *p00 = prev + ((face * src + y0) * src + x0) * 4;
+						const f32 *p01 = prev + ((face * src + y0) * src + x1) * 4;
+						const f32 *p10 = prev + ((face * src + y1) * src + x0) * 4;
+						const f32 *p11 = prev + ((face * src + y1) * src + x1) * 4;
+
+						for (usz c = 0; c < 4; ++c)
+							next[((face * dst + y) * dst + x) * 4 + c] = (p00[c] + p01[c] + p10[c] + p11[c]) * .25f;
+					}
+				});
+			}
+
+			//Convolve every texel of every mip (except mip 0) with its lobe, one row per job
+
+			for (usz mip = 1; mip < mips; ++mip) {
+
+				usz size = sizes[mip];
+				const List<LobeSample> &lobe = lobes[mip];
+
+				u8 *dst = data[mip].data() + cube * 6 * size * size * stride;
+
+				parallelFor(6 * size, threads, [&](usz row) {
+
+					usz face = row / size, y = row % size;
+					f32 t = (y + .5f) / size * 2 - 1;
+
+					List<f32> result(size * 4);
+
+					for (usz x = 0; x < size; ++x) {
+
+						//Tangent frame around the normal
+
+						f32 s = (x + .5f) / size * 2 - 1, n[3];
+						getCubeDirection(u8(face), s, t, n);
+
+						f32 len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+						for (usz i = 0; i < 3; ++i)
+							n[i] /= len;
+
+						f32 up[3] = { 0, 0, 1 };
+
+						if (std::abs(n[2]) > .999f) {
+							up[0] = 1;
+							up[2] = 0;
+						}
+
+						f32 tx[3] = { up[1] * n[2] - up[2] * n[1], up[2] * n[0] - up[0] * n[2], up[0] * n[1] - up[1] * n[0] };
+						f32 txLen = std::sqrt(tx[0] * tx[0] + tx[1] * tx[1] + tx[2] * tx[2]);
+
+						for (usz i = 0; i < 3; ++i)
+							tx[i] /= txLen;
+
+						f32 ty[3] = { n[1] * tx[2] - n[2] * tx[1], n[2] * tx[0] - n[0] * tx[2], n[0] * tx[1] - n[1] * tx[0] };
+
+						//Sum the lobe
+
+						f32 sum[4]{}, weight{};
+
+						for (const LobeSample &sample : lobe) {
+
+							f32 dir[3], color[4];
+
+							for (usz i = 0; i < 3; ++i)
+								dir[i] = tx[i] * sample.dir[0] + ty[i] * sample.dir[1] + n[i] * sample.dir[2];
+
+							radiance.sample(sample.lod, dir, color);
+
+							for (usz c = 0; c < 4; ++c)
+								sum[c] += color[c] * sample.weight;
+
+							weight += sample.weight;
+						}
+
+						for (usz c = 0; c < 4; ++c)
+							result[x * 4 + c] = weight > 0 ? sum[c] / weight : 0;
+					}
+
+					store(result.data(), dst + (face * size + y) * size * stride, size);
+				});
+			}
+		}
+
+		return Helper::SUCCESS;
+	}
+
+	Helper::ErrorMessage getIrradianceSH(const IGXI &in, u16 formatId, u16 cube, f32 (&sh)[9][3], u32 threads) {
+
+		LoadTexels load;
+		StoreTexels store;
+
+		if (Helper::ErrorMessage msg = getCubeKernels(in, formatId, load, store))
+			return msg;
+
+		if (usz(cube) * 6 >= in.header.layers)
+			return Helper::INVALID_RESOURCE_INDEX;
+
+		usz size = in.header.width;
+		usz stride = FormatHelper::getSizeBytes(in.format[formatId]);
+
+		const u8 *src = in.data[formatId][0].data() + usz(cube) * 6 * size * size * stride;
+
+		//Project every texel weighted by its solid angle; one partial sum per row so the result is deterministic
+
+		List<f32> partial(6 * size * 28);
+
+		parallelFor(6 * size, threads, [&](usz row) {
+
+			usz face = row / size, y = row % size;
+			f32 t = (y + .5f) / size * 2 - 1;
+
+			List<f32> texels(size * 4);
+			load(src + row * size * stride, texels.data(), size);
+
+			f32 *res = partial.data() + row * 28;
+
+			for (usz x = 0; x < size; ++x) {
+
+				f32 s = (x + .5f) / size * 2 - 1, d[3];
+				getCubeDirection(u8(face), s, t, d);
+
+				f32 len2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2], len = std::sqrt(len2);
+
+				//Solid angle of the texel; its area on the face is (2 / size)^2
+
+				f32 angle = 4.f / (size * size * len2 * len);
+
+				for (usz i = 0; i < 3; ++i)
+					d[i] /= len;
+
+				f32 basis[9] = {
+					.282095f,
+					.488603f * d[1], .488603f * d[2], .488603f * d[0],
+					1.092548f * d[0] * d[1], 1.092548f * d[1] * d[2],
+					.315392f * (3 * d[2] * d[2] - 1),
+					1.092548f * d[0] * d[2], .546274f * (d[0] * d[0] - d[1] * d[1])
+				};
+
+				const f32 *color = texels.data() + x * 4;
+
+				for (usz i = 0; i < 9; ++i)
+					for (usz c = 0; c < 3; ++c)
+						res[i * 3 + c] += color[c] * basis[i] * angle;
+
+				res[27] += angle;
+			}
+		});
+
+		f32 sum[28]{};
+
+		for (usz row = 0; row < 6 * size; ++row)
+			for (usz i = 0; i < 28; ++i)
+				sum[i] += partial[row * 28 + i];
+
+		//Normalize to exactly 4pi and convolve with the cosine lobe (pi, 2pi / 3 and pi / 4 per band)
+
+		static constexpr f32 bands[9] = {
+			pi,
+			2 * pi / 3, 2 * pi / 3, 2 * pi / 3,
+			pi / 4, pi / 4, pi / 4, pi / 4, pi / 4
+		};
+
+		f32 norm = sum[27] > 0 ? 4 * pi / sum[27] : 0;
+
+		for (usz i = 0; i < 9; ++i)
+			for (usz c = 0; c < 3; ++c)
+				sh[i][c] = sum[i * 3 + c] * norm * bands[i];
+
+		return Helper::SUCCESS;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,391 @@
+#include "igxi/resample.hpp"
+#include "igxi/kernels.hpp"
+#include "igxi/srgb.hpp"
+#include "igxi/parallel.hpp"
+#include <cmath>
+
+using namespace ignis;
+
+namespace igxi {
+
+	static constexpr f64 pi = 3.14159265358979323846;
+
+	Helper::ErrorMessage getResampleFilter(Helper::Flags flags, ResampleFilter &filter) {
+
+		switch (flags & (Helper::MIP_MITCHELL | Helper::MIP_LANCZOS | Helper::MIP_KAISER)) {
+			case 0:						filter = ResampleFilter::NONE;		break;
+			case Helper::MIP_MITCHELL:	filter = ResampleFilter::MITCHELL;	break;
+			case Helper::MIP_LANCZOS:	filter = ResampleFilter::LANCZOS;	break;
+			case Helper::MIP_KAISER:	filter = ResampleFilter::KAISER;	break;
+			default:					return Helper::INVALID_MIP_FILTER;
+		}
+
+		return Helper::SUCCESS;
+	}
+
+	//Filter functions
+
+	inline f64 sinc(f64 x) {
+
+		if (std::abs(x) < 1e-8)
+			return 1;
+
+		return std::sin(pi * x) / (pi * x);
+	}
+
+	//Modified Bessel function of the first kind (order 0), as a power series
+
+	inline f64 besselI0(f64 x) {
+
+		f64 sum = 1, term = 1, quarter = x * x / 4;
+
+		for (u32 k = 1; k < 32 && term > sum * 1e-12; ++k) {
+			term *= quarter / (f64(k) * k);
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	inline f64 getRadius(ResampleFilter filter) {
+		return filter == ResampleFilter::MITCHELL ? 2 : 3;
+	}
+
+	inline f64 evaluate(ResampleFilter filter, f64 x) {
+
+		x = std::abs(x);
+
+		switch (filter) {
+
+			case ResampleFilter::MITCHELL: {
+
+				constexpr f64 B = 1. / 3, C = 1. / 3;
+
+				if (x < 1)
+					return ((12 - 9 * B - 6 * C) * x * x * x + (-18 + 12 * B + 6 * C) * x * x + (6 - 2 * B)) / 6;
+
+				if (x < 2)
+					return (
+						(-B - 6 * C) * x * x * x + (6 * B + 30 * C) * x * x +
+						(-12 * B - 48 * C) * x + (8 * B + 24 * C)
+					) / 6;
+
+				return 0;
+			}
+
+			case ResampleFilter::LANCZOS:
+				return x < 3 ? sinc(x) * sinc(x / 3) : 0;
+
+			default: {
+
+				constexpr f64 alpha = 4;
+
+				if (x >= 3)
+					return 0;
+
+				f64 t = x / 3;
+				return sinc(x) * besselI0(alpha * std::sqrt(1 - t * t)) / besselI0(alpha);
+			}
+		}
+	}
+
+	//Weights of every output pixel along one axis
+	//Every output pixel i reads taps source pixels from first[i]; clamped edges are folded into the window
+
+	struct WeightTable {
+
+		List<usz> first;
+		List<f32> weights;
+		usz taps;
+
+		WeightTable(ResampleFilter filter, usz srcSize, usz dstSize) {
+
+			f64 ratio = f64(srcSize) / dstSize;
+			f64 scale = std::max(ratio, 1.);
+			f64 support = getRadius(filter) * scale;
+
+			taps = std::min(usz(std::ceil(support * 2)) + 2, srcSize);
+
+			first.resize(dstSize);
+			weights.resize(dstSize * taps);
+
+			List<f64> window(taps);
+
+			for (usz i = 0; i < dstSize; ++i) {
+
+				f64 center = (i + .5) * ratio;
+
+				i64 lo = i64(std::ceil(center - support - .5));
+				i64 hi = i64(std::floor(center + support - .5));
+
+				usz start = usz(std::clamp(lo, i64(0), i64(srcSize - taps)));
+				first[i] = start;
+
+				std::fill(window.begin(), window.end(), 0.);
+
+				f64 sum{};
+
+				for (i64 j = lo; j <= hi; ++j) {
+
+					f64 w = evaluate(filter, (j + .5 - center) / scale);
+
+					if (w == 0)
+						continue;
+
+					usz k = usz(std::clamp(j, i64(0), i64(srcSize - 1))) - start;
+
+					if (k >= taps)
+						continue;
+
+					window[k] += w;
+					sum += w;
+				}
+
+				//Can only happen when the source pixels are exactly on zeros of the filter
+
+				if (sum == 0) {
+					window[usz(std::clamp(i64(center), i64(start), i64(start + taps - 1))) - start] = 1;
+					sum = 1;
+				}
+
+				for (usz k = 0; k < taps; ++k)
+					weights[i * taps + k] = f32(window[k] / sum);
+			}
+		}
+	};
+
+	//Rows to and from f32 (sRGB color in linear space)
+
+	using LoadRow = void (*)(const u8 *src, f32 *dst, usz width, usz C);
+	using StoreRow = void (*)(const f32 *src, u8 *dst, usz width, usz C);
+
+	template<typename T, bool srgb>
+	inline void loadRow(const u8 *src, f32 *dst, usz width, usz C) {
+
+		const T *s = (const T*) src;
+
+		if constexpr (srgb) {
+
+			const SrgbTables &tables = getSrgbTables();
+
+			for (usz i = 0; i < width * C; ++i)
+				dst[i] = i % C == 3 ? f32(s[i]) : tables.toLinear[s[i]];
+		}
+
+		else for (usz i = 0; i < width * C; ++i)
+			dst[i] = f32(s[i]);
+	}
+
+	template<typename T, bool srgb>
+	inline void storeRow(const f32 *src, u8 *dst, usz width, usz C) {
+
+		T *d = (T*) dst;
+
+		const SrgbTables &tables = getSrgbTables();
+
+		for (usz i = 0; i < width * C; ++i) {
+
+			f32 v = src[i];
+
+			if constexpr (srgb)
+				d[i] = i % C == 3 ? T(std::clamp(v + .5f, 0.f, 255.f)) : tables.toSrgb(v);
+
+			else if constexpr (std::is_same_v<T, f16>)
+				d[i] = ConvertPrimitive<f16, f32>::apply(v);
+
+			else if constexpr (std::is_floating_point_v<T>)
+				d[i] = T(v);
+
+			//Negative lobes can over- and undershoot
+
+			else d[i] = T(std::clamp(
+				std::round(v), f32(std::numeric_limits<T>::min()), f32(std::numeric_limits<T>::max())
+			));
+		}
+	}
+
+	inline bool getRowKernels(GPUFormat format, LoadRow &load, StoreRow &store) {
+
+		if (format == GPUFormat::srgba8) {
+			load = &loadRow<u8, true>;
+			store = &storeRow<u8, true>;
+			return true;
+		}
+
+		usz stride = FormatHelper::getStrideBytes(format);
+
+		switch (FormatHelper::getType(format)) {
+
+			case GPUFormatType::UNORM:
+			case GPUFormatType::UINT:
+
+				switch (stride) {
+					case 1:		load = &loadRow<u8, false>;		store = &storeRow<u8, false>;	return true;
+					case 2:		load = &loadRow<u16, false>;	store = &storeRow<u16, false>;	return true;
+					default:	return false;
+				}
+
+			case GPUFormatType::SNORM:
+			case GPUFormatType::SINT:
+
+				switch (stride) {
+					case 1:		load = &loadRow<i8, false>;		store = &storeRow<i8, false>;	return true;
+					case 2:		load = &loadRow<i16, false>;	store = &storeRow<i16, false>;	return true;
+					default:	return false;
+				}
+
+			case GPUFormatType::FLOAT:
+
+				switch (stride) {
+					case 2:		load = &loadRow<f16, false>;	store = &storeRow<f16, false>;	return true;
+					case 4:		load = &loadRow<f32, false>;	store = &storeRow<f32, false>;	return true;
+					default:	return false;
+				}
+
+			default:
+				return false;
+		}
+	}
+
+	bool canResample(GPUFormat format) {
+
+		LoadRow load;
+		StoreRow store;
+
+		usz stride = FormatHelper::getStrideBytes(format);
+		return stride && FormatHelper::getSizeBytes(format) / stride <= 4 && getRowKernels(format, load, store);
+	}
+
+	//Horizontal pass of one row
+
+	inline void filterRow(const f32 *src, f32 *dst, const WeightTable &table, usz width, usz C) {
+
+		usz taps = table.taps;
+
+		#ifdef IGXI_SSE2
+
+			if (C == 4) {
+
+				for (usz i = 0; i < width; ++i) {
+
+					const f32 *s = src + table.first[i] * 4;
+					const f32 *w = table.weights.data() + i * taps;
+
+					__m128 sum = _mm_setzero_ps();
+
+					for (usz t = 0; t < taps; ++t)
+						sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(w[t]), _mm_loadu_ps(s + t * 4)));
+
+					_mm_storeu_ps(dst + i * 4, sum);
+				}
+
+				return;
+			}
+
+		#endif
+
+		for (usz i = 0; i < width; ++i) {
+
+			const f32 *s = src + table.first[i] * C;
+			const f32 *w = table.weights.data() + i * taps;
+
+			for (usz c = 0; c < C; ++c) {
+
+				f32 sum{};
+
+				for (usz t = 0; t < taps; ++t)
+					sum += w[t] * s[t * C + c];
+
+				dst[i * C + c] = sum;
+			}
+		}
+	}
+
+	//Vertical pass; dst += weight * src over a whole row
+
+	inline void accumulateRow(const f32 *src, f32 *dst, f32 weight, usz count) {
+
+		usz i{};
+
+		#ifdef IGXI_SSE2
+
+			__m128 w = _mm_set1_ps(weight);
+
+			for (; i + 4 <= count; i += 4)
+				_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(w, _mm_loadu_ps(src + i))));
+
+		#endif
+
+		for (; i < count; ++i)
+			dst[i] += weight * src[i];
+	}
+
+	Helper::ErrorMessage resample(
+		const u8 *src, u16 srcWidth, u16 srcHeight, u8 *dst, u16 dstWidth, u16 dstHeight,
+		GPUFormat format, ResampleFilter filter, u32 threads
+	) {
+
+		if (!srcWidth || !srcHeight || !dstWidth || !dstHeight)
+			return Helper::INVALID_IMAGE_SIZE;
+
+		LoadRow load;
+		StoreRow store;
+
+		usz stride = FormatHelper::getStrideBytes(format);
+
+		if (!stride || filter >= ResampleFilter::NONE || !getRowKernels(format, load, store))
+			return Helper::INVALID_FORMAT;
+
+		usz C = FormatHelper::getSizeBytes(format) / stride;
+
+		if (C - 1 >= 4)
+			return Helper::INVALID_FORMAT;
+
+		usz pixel = C * stride;
+		usz srcRow = usz(srcWidth) * pixel, dstRow = usz(dstWidth) * pixel;
+
+		WeightTable horizontal(filter, srcWidth, dstWidth), vertical(filter, srcHeight, dstHeight);
+
+		//Output rows are split into bands, each band keeps the last filtered source rows in a ring
+		//Source rows only go up, so every one is filtered horizontally once per band
+
+		constexpr usz band = 64;
+
+		usz bands = (usz(dstHeight) + band - 1) / band;
+		usz width = usz(dstWidth) * C, taps = vertical.taps;
+
+		parallelFor(bands, threads, [&](usz b) {
+
+			usz y0 = b * band, y1 = std::min(y0 + band, usz(dstHeight));
+
+			List<f32> loaded(usz(srcWidth) * C);
+			List<f32> ring(taps * width);
+			List<f32> result(width);
+
+			usz next = vertical.first[y0];
+
+			for (usz y = y0; y < y1; ++y) {
+
+				usz first = vertical.first[y];
+
+				for (next = std::max(next, first); next < first + taps; ++next) {
+					load(src + next * srcRow, loaded.data(), srcWidth, C);
+					filterRow(loaded.data(), ring.data() + next % taps * width, horizontal, dstWidth, C);
+				}
+
+				std::fill(result.begin(), result.end(), 0.f);
+
+				const f32 *w = vertical.weights.data() + y * taps;
+
+				for (usz t = 0; t < taps; ++t)
+					if (w[t] != 0)
+						accumulateRow(ring.data() + (first + t) % taps * width, result.data(), w[t], width);
+
+				store(result.data(), dst + y * dstRow, dstWidth, C);
+			}
+		});
+
+		return Helper::SUCCESS;
+	}
+
+}
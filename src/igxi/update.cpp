@@ -0,0 +1,204 @@
+#include "igxi/convert.hpp"
+#include "igxi/compress.hpp"
+
+using namespace ignis;
+
+namespace igxi {
+
+	//Find which compressed format a GPUFormat of the IGXI is; COUNT if it isn't one
+
+	inline CompressedFormat findCompressedFormat(GPUFormat format) {
+
+		for (u8 i = 0; i < u8(CompressedFormat::COUNT); ++i)
+			if (getGPUFormat(CompressedFormat(i)) == format)
+				return CompressedFormat(i);
+
+		return CompressedFormat::COUNT;
+	}
+
+	//Compress the changed layers into the compressed formats the IGXI already has, instead of picking them again
+	//Layers without alpha can go into a format with alpha (e.g. an opaque layer of a BC3 array),
+	//	but layers with alpha can't go into formats picked without it (BC1); that needs a full conversion
+
+	inline Helper::ErrorMessage compressInto(
+		IGXI &partial, const IGXI &in, Helper::Flags flags, f32 quality, u32 threads
+	) {
+
+		//Formats that can't be compressed stay uncompressed, like they do in convert
+
+		GPUFormat format = partial.format[0];
+		List<CompressedFormat> withAlpha = getCompressionTargets(format, flags, quality, true);
+
+		if (withAlpha.empty())
+			return Helper::SUCCESS;
+
+		usz first = flags & Helper::KEEP_UNCOMPRESSED ? 1 : 0;
+
+		if (in.format.size() <= first)
+			return Helper::CONFLICTING_IMAGE_FORMAT;
+
+		List<CompressedFormat> targets;
+
+		for (usz i = first; i < in.format.size(); ++i) {
+
+			CompressedFormat target = findCompressedFormat(in.format[i]);
+
+			if (target == CompressedFormat::COUNT)
+				return Helper::CONFLICTING_IMAGE_FORMAT;
+
+			targets.push_back(target);
+		}
+
+		if (
+			targets != withAlpha &&
+			(usesAlpha(partial) || targets != getCompressionTargets(format, flags, quality, false))
+		)
+			return Helper::CONFLICTING_IMAGE_FORMAT;
+
+		List<List<Buffer>> data;
+
+		if (Helper::ErrorMessage msg = compress(partial, 0, targets, quality, data, threads))
+			return msg;
+
+		partial.format.resize(first + targets.size());
+		partial.data.resize(first + targets.size());
+
+		for (usz i = 0; i < targets.size(); ++i) {
+			partial.format[first + i] = in.format[first + i];
+			partial.data[first + i] = std::move(data[i]);
+		}
+
+		partial.header.formats = u16(partial.format.size());
+		return Helper::SUCCESS;
+	}
+
+	Helper::ErrorMessage Helper::update(
+		IGXI &inout, const List<FileDesc> &changed, Flags flags, f32 quality, u32 threads, DecodeCache *cache
+	) {
+
+		if (changed.empty())
+			return SUCCESS;
+
+		if (!(u8(inout.header.flags) & u8(IGXI::Flags::CONTAINS_DATA)) || inout.data.size() != inout.header.formats)
+			return INVALID_FILE_DATA;
+
+		//A prefiltered mip depends on every face of its cube, so changed faces need a full conversion
+
+		if (flags & MIP_GGX && !(flags & CUBE_FROM_IMAGE))
+			return INVALID_OPERATION;
+
+		//3D textures only have one layer and their mips combine slices, so they're always converted completely
+		//The slices that didn't change can't be taken from the (possibly compressed) IGXI, so all of them have to be passed
+
+		if (flags & IS_3D && !(flags & FRAMES_FROM_IMAGE)) {
+
+			List<bool> slices(inout.header.length);
+
+			for (const FileDesc &desc : changed)
+				if (!desc.iid.mip) {
+
+					if (desc.iid.z >= slices.size())
+						return INVALID_RESOURCE_INDEX;
+
+					slices[desc.iid.z] = true;
+				}
+
+			if (std::find(slices.begin(), slices.end(), false) != slices.end())
+				return MISSING_RESOURCE_INDEX;
+		}
+
+		//Find the changed layers and give them a slot in the partial IGXI (in order of layer)
+		//With CUBE_FROM_IMAGE, a layer of a file is a whole cube (6 layers)
+		//With FRAMES_FROM_IMAGE, it's one layer per frame (which is only known once the files are converted)
+
+		usz layersPerFile = flags & CUBE_FROM_IMAGE ? 6 : 1;
+
+		List<u16> layers;
+
+		for (const FileDesc &desc : changed) {
+
+			if (desc.path.empty())
+				return INVALID_FILE_PATH;
+
+			if (usz(desc.iid.layer) * layersPerFile >= inout.header.layers)
+				return INVALID_RESOURCE_INDEX;
+
+			layers.push_back(desc.iid.layer);
+		}
+
+		std::sort(layers.begin(), layers.end());
+		layers.erase(std::unique(layers.begin(), layers.end()), layers.end());
+
+		List<FileDesc> files = changed;
+
+		for (FileDesc &desc : files)
+			desc.iid.layer = u16(std::lower_bound(layers.begin(), layers.end(), desc.iid.layer) - layers.begin());
+
+		//A couple faces of a cube aren't a cube anymore, so they're converted as a 2D array
+		//Unless every file is a whole cube, then it stays a cube array
+		//3D textures are converted completely (see above)
+
+		Flags partialFlags = flags;
+
+		if (flags & CUBE_FROM_IMAGE)
+			partialFlags = Flags(flags | IS_ARRAY);
+
+		else if (!(flags & IS_3D))
+			partialFlags = Flags((flags & ~(PROPERTY_TYPE & ~IS_1D)) | IS_ARRAY);
+
+		//The layers are compressed afterwards, into the formats the IGXI already has (see compressInto)
+
+		if (flags & DO_COMPRESSION)
+			partialFlags = Flags(partialFlags & ~(DO_COMPRESSION | KEEP_UNCOMPRESSED));
+
+		IGXI partial;
+
+		if (ErrorMessage msg = convert(partial, files, partialFlags, quality, threads, cache))
+			return msg;
+
+		if (flags & FRAMES_FROM_IMAGE && !(flags & IS_3D)) {
+
+			layersPerFile = partial.header.layers / layers.size();
+
+			if (usz(layers.back() + 1) * layersPerFile > inout.header.layers)
+				return CONFLICTING_IMAGE_SIZE;
+		}
+
+		//The layers have to fit in the existing IGXI
+
+		if (partial.header.width != inout.header.width || partial.header.height != inout.header.height)
+			return CONFLICTING_IMAGE_SIZE;
+
+		if (partial.header.length != inout.header.length || partial.header.mips != inout.header.mips)
+			return CONFLICTING_IMAGE_SIZE;
+
+		if (flags & DO_COMPRESSION)
+			if (ErrorMessage msg = compressInto(partial, inout, flags, quality, threads))
+				return msg;
+
+		if (partial.format != inout.format)
+			return CONFLICTING_IMAGE_FORMAT;
+
+		//Every layer of a mip has the same size, so each one can be copied to its place
+
+		for (usz f = 0; f < inout.data.size(); ++f)
+			for (usz mip = 0; mip < inout.header.mips; ++mip) {
+
+				Buffer &dst = inout.data[f][mip];
+				const Buffer &src = partial.data[f][mip];
+
+				usz layerSize = dst.size() / inout.header.layers;
+
+				if (src.size() != layerSize * layers.size() * layersPerFile)
+					return INVALID_IMAGE_SIZE;
+
+				for (usz i = 0; i < layers.size() * layersPerFile; ++i) {
+					usz layer = layers[i / layersPerFile] * layersPerFile + i % layersPerFile;
+					std::memcpy(dst.data() + layerSize * layer, src.data() + layerSize * i, layerSize);
+				}
+			}
+
+		return SUCCESS;
+	}
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "test.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+//Replaces the global operator new/delete, to count every allocation through new (so every Buffer and List)
+//Only include this in the one source file of a test or benchmark, since it defines the operators
+
+namespace igxi::test {
+
+	struct Allocations {
+
+		std::atomic<usz> current, peak, count;
+
+		//The size is stored in front of the allocation, so delete knows how much is freed
+
+		inline void *allocate(std::size_t size) {
+
+			void *ptr = std::malloc(size + alignof(std::max_align_t));
+
+			if (!ptr)
+				throw std::bad_alloc();
+
+			*(std::size_t*) ptr = size;
+
+			++count;
+
+			usz now = current += size;
+			usz last = peak.load();
+
+			while (now > last && !peak.compare_exchange_weak(last, now)) {}
+
+			return (u8*) ptr + alignof(std::max_align_t);
+		}
+
+		inline void deallocate(void *ptr) {
+
+			if (!ptr)
+				return;
+
+			ptr = (u8*) ptr - alignof(std::max_align_t);
+			current -= *(std::size_t*) ptr;
+			std::free(ptr);
+		}
+
+	};
+
+	inline Allocations allocations{};
+
+	//Peak memory (above what was allocated before) and number of allocations of a function
+
+	struct AllocationStats {
+		usz peak, count;
+	};
+
+	template<typename Func>
+	inline AllocationStats measureAllocations(const Func &func) {
+
+		usz start = allocations.current, count = allocations.count;
+		allocations.peak = start;
+
+		func();
+
+		return { allocations.peak - start, allocations.count - count };
+	}
+
+}
+
+void *operator new(std::size_t size) { return igxi::test::allocations.allocate(size); }
+void *operator new[](std::size_t size) { return igxi::test::allocations.allocate(size); }
+void operator delete(void *ptr) noexcept { igxi::test::allocations.deallocate(ptr); }
+void operator delete[](void *ptr) noexcept { igxi::test::allocations.deallocate(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { igxi::test::allocations.deallocate(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { igxi::test::allocations.deallocate(ptr); }
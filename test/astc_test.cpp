@@ -0,0 +1,299 @@
+#include "test.hpp"
+#include "igxi/astc.hpp"
+
+using namespace igxi;
+
+//Reference decoder (from the Khronos data format spec) for LDR blocks with one partition and one plane
+//That's every block the encoder writes, except for weight ranges with trits or quints (which it never uses)
+
+struct BitReader {
+
+	const u8 *data;
+	usz offset{};
+
+	inline u32 read(usz bits) {
+
+		u32 v{};
+
+		for (usz i = 0; i < bits; ++i, ++offset)
+			v |= u32((data[offset >> 3] >> (offset & 7)) & 1) << i;
+
+		return v;
+	}
+};
+
+//Returns false if the block isn't one that's supported
+
+static bool decodeASTC(const u8 *in, u8 blockWidth, u8 blockHeight, u8 (*out)[4]) {
+
+	BitReader reader{ in };
+	u32 mode = reader.read(11);
+
+	//Void extent; a single 16-bit color
+
+	if ((mode & 0x1FF) == 0x1FC) {
+
+		if (mode & 0x200)		//HDR
+			return false;
+
+		for (usz i = 0; i < usz(blockWidth) * blockHeight; ++i)
+			for (usz c = 0; c < 4; ++c)
+				out[i][c] = in[9 + c * 2];		//The high byte of the unorm16
+
+		return true;
+	}
+
+	//Grid size and weight range
+
+	u32 r, gridWidth, gridHeight, a = (mode >> 5) & 3, b = (mode >> 7) & 3;
+	bool highPrecision, dualPlane;
+
+	if (mode & 3) {
+
+		r = ((mode >> 4) & 1) | ((mode & 3) << 1);
+		highPrecision = (mode >> 9) & 1;
+		dualPlane = (mode >> 10) & 1;
+
+		switch ((mode >> 2) & 3) {
+			case 0:		gridWidth = b + 4;	gridHeight = a + 2;		break;
+			case 1:		gridWidth = b + 8;	gridHeight = a + 2;		break;
+			case 2:		gridWidth = a + 2;	gridHeight = b + 8;		break;
+
+			default:
+
+				if ((mode >> 8) & 1) {
+					gridWidth = (b & 1) + 2;
+					gridHeight = a + 2;
+				}
+
+				else {
+					gridWidth = a + 2;
+					gridHeight = (b & 1) + 6;
+				}
+		}
+	}
+
+	else {
+
+		r = ((mode >> 4) & 1) | (((mode >> 2) & 3) << 1);
+		highPrecision = false;
+		dualPlane = false;
+
+		switch ((mode >> 7) & 3) {
+			case 0:		gridWidth = 12;		gridHeight = a + 2;									break;
+			case 1:		gridWidth = a + 2;	gridHeight = 12;									break;
+			case 2:		gridWidth = a + 6;	gridHeight = ((mode >> 9) & 3) + 6;					break;
+			default:	gridWidth = (mode >> 5) & 1 ? 10 : 6;	gridHeight = (mode >> 5) & 1 ? 6 : 10;	break;
+		}
+	}
+
+	//Only ranges of 2^n levels; 2, 4, 8 (low precision) and 16, 32 (high)
+
+	static constexpr u32 lowBits[8] = { 0, 0, 1, 0, 2, 0, 0, 3 }, highBits[8] = { 0, 0, 0, 0, 4, 0, 0, 5 };
+	u32 weightBits = highPrecision ? highBits[r] : lowBits[r];
+
+	if (dualPlane || !weightBits || gridWidth > blockWidth || gridHeight > blockHeight)
+		return false;
+
+	//One partition and direct LDR RGB (8) or RGBA (12) endpoints; 256 levels if the remaining bits allow it
+
+	if (reader.read(2))
+		return false;
+
+	u32 endpointMode = reader.read(4);
+
+	if (endpointMode != 8 && endpointMode != 12)
+		return false;
+
+	u32 values = endpointMode == 8 ? 6 : 8;
+	u32 gridSize = gridWidth * gridHeight;
+
+	if (128 - 17 - gridSize * weightBits < values * 8)
+		return false;
+
+	i32 v[8]{};
+
+	for (u32 i = 0; i < values; ++i)
+		v[i] = i32(reader.read(8));
+
+	if (values == 6)
+		v[6] = v[7] = 255;
+
+	i32 e0[4], e1[4];
+
+	if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+		for (usz c = 0; c < 4; ++c) {
+			e0[c] = v[c * 2];
+			e1[c] = v[c * 2 + 1];
+		}
+
+	//Swapped with blue contraction
+
+	else {
+
+		for (usz c = 0; c < 4; ++c) {
+			e0[c] = v[c * 2 + 1];
+			e1[c] = v[c * 2];
+		}
+
+		for (i32 *e : { e0, e1 }) {
+			e[0] = (e[0] + e[2]) >> 1;
+			e[1] = (e[1] + e[2]) >> 1;
+		}
+	}
+
+	//Weights are stored backwards from the end of the block
+
+	u8 reversed[16];
+
+	for (usz i = 0; i < 16; ++i) {
+
+		u8 byte = in[15 - i], rev{};
+
+		for (usz j = 0; j < 8; ++j)
+			rev |= u8(((byte >> j) & 1) << (7 - j));
+
+		reversed[i] = rev;
+	}
+
+	BitReader weightReader{ reversed };
+	i32 weights[144];
+
+	for (u32 i = 0; i < gridSize; ++i) {
+
+		u32 q = weightReader.read(weightBits);
+		i32 w{};
+
+		for (i32 shift = 6 - i32(weightBits); shift > -i32(weightBits); shift -= i32(weightBits))
+			w |= shift >= 0 ? i32(q << shift) : i32(q >> -shift);
+
+		weights[i] = w > 32 ? w + 1 : w;
+	}
+
+	//Bilinear infill of the grid to the texels and LDR interpolation (unorm16 -> top byte)
+
+	i32 ds = (1024 + blockWidth / 2) / (blockWidth - 1);
+	i32 dt = (1024 + blockHeight / 2) / (blockHeight - 1);
+
+	for (i32 t = 0; t < blockHeight; ++t)
+		for (i32 s = 0; s < blockWidth; ++s) {
+
+			i32 gs = (ds * s * i32(gridWidth - 1) + 32) >> 6;
+			i32 gt = (dt * t * i32(gridHeight - 1) + 32) >> 6;
+			i32 js = gs >> 4, fs = gs & 15, jt = gt >> 4, ft = gt & 15;
+
+			i32 w11 = (fs * ft + 8) >> 4, w10 = ft - w11, w01 = fs - w11, w00 = 16 - fs - ft + w11;
+			i32 v0 = js + jt * i32(gridWidth);
+
+			auto at = [&](i32 i) { return i < i32(gridSize) ? weights[i] : 0; };
+
+			i32 w = (at(v0) * w00 + at(v0 + 1) * w01 + at(v0 + i32(gridWidth)) * w10 + at(v0 + i32(gridWidth) + 1) * w11 + 8) >> 4;
+
+			for (usz c = 0; c < 4; ++c) {
+				i32 c0 = (e0[c] << 8) | e0[c], c1 = (e1[c] << 8) | e1[c];
+				out[t * blockWidth + s][c] = u8(((c0 * (64 - w) + c1 * w + 32) >> 6) >> 8);
+			}
+		}
+
+	return true;
+}
+
+struct Error {
+	bool decoded;
+	f64 rmse;
+	i32 max;
+};
+
+static Error roundTrip(const u8 (*px)[4], u8 blockWidth, u8 blockHeight, u8 iterations) {
+
+	u8 encoded[16];
+	u8 decoded[64][4]{};
+
+	encodeASTC(px, blockWidth, blockHeight, encoded, iterations);
+
+	if (!decodeASTC(encoded, blockWidth, blockHeight, decoded))
+		return { false, 0, 0 };
+
+	usz count = usz(blockWidth) * blockHeight;
+	f64 sqError{};
+	i32 maxError{};
+
+	for (usz i = 0; i < count; ++i)
+		for (usz c = 0; c < 4; ++c) {
+			i32 d = std::abs(i32(px[i][c]) - decoded[i][c]);
+			sqError += f64(d) * d;
+			maxError = std::max(maxError, d);
+		}
+
+	return { true, std::sqrt(sqError / f64(count * 4)), maxError };
+}
+
+int main() {
+
+	static constexpr u8 sizes[] = { 4, 6, 8 };
+
+	u8 px[64][4];
+
+	for (u8 size : sizes) {
+
+		IGXI_CHECK(supportsASTC(size, size));
+
+		usz count = usz(size) * size;
+
+		//A single color is a void extent block and exact
+
+		for (usz i = 0; i < count; ++i)
+			for (usz c = 0; c < 4; ++c)
+				px[i][c] = u8(17 + c * 60);
+
+		Error solid = roundTrip(px, size, size, 0);
+		IGXI_CHECK(solid.decoded && solid.max == 0);
+
+		//A gradient is one line through RGB(A), so it's only limited by the weight levels
+		//The fast preset uses the grid with the fewest levels (4 for RGBA)
+
+		for (bool alpha : { false, true })
+			for (u8 iterations : { u8(0), u8(2) }) {
+
+				for (usz i = 0; i < count; ++i) {
+					usz t = (i % size + i / size) * 255 / (2 * (size - 1));
+					px[i][0] = u8(20 + t * 200 / 255);
+					px[i][1] = u8(240 - t * 180 / 255);
+					px[i][2] = u8(t * 100 / 255);
+					px[i][3] = alpha ? u8(255 - t / 2) : 255;
+				}
+
+				Error gradient = roundTrip(px, size, size, iterations);
+
+				IGXI_CHECK(gradient.decoded);
+				IGXI_CHECK(gradient.rmse < (iterations ? 8 : 24));
+			}
+
+		//Noise; refinement shouldn't make it worse
+
+		u32 state = 777;
+		f64 fast{}, refined{};
+
+		for (u32 j = 0; j < 64; ++j) {
+
+			for (usz i = 0; i < count; ++i)
+				for (usz c = 0; c < 4; ++c) {
+					state = state * 1664525 + 1013904223;
+					px[i][c] = c == 3 ? 255 : u8(state >> 24);
+				}
+
+			Error a = roundTrip(px, size, size, 0), b = roundTrip(px, size, size, 2);
+
+			IGXI_CHECK(a.decoded && b.decoded);
+
+			fast += a.rmse;
+			refined += b.rmse;
+		}
+
+		IGXI_CHECK(refined <= fast * 1.01);
+	}
+
+	IGXI_CHECK(!supportsASTC(5, 5));
+
+	return test::result();
+}
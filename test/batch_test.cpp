@@ -0,0 +1,119 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+#include "igxi/cache.hpp"
+#include "igxi/png.hpp"
+
+using namespace igxi;
+
+//A batch has to give every job the same IGXI (and error) as converting the jobs one after another
+
+static String writeImage(const String &dir, const String &name, u16 width, u16 height, u32 seed) {
+
+	Buffer image(usz(width) * height * 4);
+
+	for (usz i = 0; i < image.size(); ++i) {
+		seed = seed * 1664525 + 1013904223;
+		image[i] = i % 4 == 3 ? 255 : u8(seed >> 24);
+	}
+
+	String path = dir + "/" + name + ".png";
+	IGXI_CHECK(test::writeFile(path, encodePNG(image.data(), i64(width) * 4, width, height, 4, 1, 1)));
+	return path;
+}
+
+static bool equal(const IGXI &a, const IGXI &b) {
+	return
+		a.header.width == b.header.width && a.header.height == b.header.height &&
+		a.header.length == b.header.length && a.header.layers == b.header.layers &&
+		a.header.mips == b.header.mips && a.header.formats == b.header.formats &&
+		a.format == b.format && a.data == b.data;
+}
+
+int main() {
+
+	String dir = test::getDirectory("batch");
+
+	//Mixed sizes: a big compressed array, a few small textures, a 3D texture and jobs that fail
+
+	List<Helper::Job> jobs;
+
+	const Helper::Flags compressed = Helper::Flags(Helper::IS_ARRAY | Helper::DEFAULT);
+	const Helper::Flags mipped = Helper::Flags(Helper::IS_2D | Helper::GENERATE_MIPS);
+
+	{
+		Helper::Job job{ {}, {}, compressed, .25f };
+
+		for (u16 layer = 0; layer < 6; ++layer)
+			job.files.push_back({ writeImage(dir, "big" + std::to_string(layer), 256, 128, layer), { 0, layer, 0 } });
+
+		jobs.push_back(std::move(job));
+	}
+
+	for (u32 i = 0; i < 8; ++i) {
+		String path = writeImage(dir, "small" + std::to_string(i), u16(1 + i * 5), u16(3 + i), 100 + i);
+		jobs.push_back({ {}, { { path, {} } }, mipped, 1 });
+	}
+
+	{
+		Helper::Job job{ {}, {}, Helper::Flags(Helper::IS_3D | Helper::GENERATE_MIPS), 1 };
+
+		for (u16 z = 0; z < 5; ++z)
+			job.files.push_back({ writeImage(dir, "volume" + std::to_string(z), 33, 17, 200 + z), { z, 0, 0 } });
+
+		jobs.push_back(std::move(job));
+	}
+
+	//The same file twice (shared by the cache), a missing file and conflicting sizes
+
+	jobs.push_back({ {}, { { dir + "/small3.png", {} } }, mipped, 1 });
+	jobs.push_back({ {}, { { dir + "/missing.png", {} } }, mipped, 1 });
+
+	jobs.push_back({
+		{}, { { dir + "/small1.png", { 0, 0, 0 } }, { dir + "/small2.png", { 0, 1, 0 } } },
+		Helper::Flags(Helper::IS_ARRAY | Helper::IS_2D), 1
+	});
+
+	//Sequentially, with a single thread
+
+	List<IGXI> expected(jobs.size());
+	List<Helper::ErrorMessage> expectedErrors(jobs.size());
+
+	for (usz i = 0; i < jobs.size(); ++i)
+		expectedErrors[i] = Helper::convert(expected[i], jobs[i].files, jobs[i].flags, jobs[i].quality, 1);
+
+	IGXI_CHECK(expectedErrors[jobs.size() - 2] == Helper::INVALID_FILE_PATH);
+	IGXI_CHECK(expectedErrors[jobs.size() - 1] == Helper::CONFLICTING_IMAGE_SIZE);
+
+	//As a batch, with and without a cache, with different thread counts
+
+	for (u32 threads : { 1u, 3u, 8u, 0u })
+		for (bool cached : { false, true }) {
+
+			List<Helper::Job> batch = jobs;
+
+			std::unique_ptr<DecodeCache> cache;
+
+			if (cached)
+				cache = std::make_unique<DecodeCache>(test::getDirectory("batch-cache"), u64(1) << 30);
+
+			List<Helper::ErrorMessage> errors = Helper::convertBatch(batch, threads, cache.get());
+
+			IGXI_CHECK(errors == expectedErrors);
+
+			for (usz i = 0; i < jobs.size(); ++i)
+				if (errors[i] == Helper::SUCCESS && !equal(batch[i].out, expected[i])) {
+					std::fprintf(stderr, "Job %zu with %u threads (cached: %i) is different\n", i, threads, int(cached));
+					IGXI_CHECK(false);
+				}
+		}
+
+	//No jobs, no errors
+
+	List<Helper::Job> none;
+	IGXI_CHECK(Helper::convertBatch(none).empty());
+
+	std::error_code error;
+	std::filesystem::remove_all(dir, error);
+
+	return test::result();
+}
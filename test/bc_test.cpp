@@ -0,0 +1,259 @@
+#include "test.hpp"
+#include "igxi/bc.hpp"
+
+using namespace igxi;
+
+//Reference decoders (from the D3D/Khronos specs), so the encoders are checked against the bit layout a GPU reads
+
+static void decodeBC1(const u8 *in, u8 (*out)[4], bool forceFourColors = false) {
+
+	u16 c[2] = { u16(in[0] | (in[1] << 8)), u16(in[2] | (in[3] << 8)) };
+	i32 colors[4][4]{};
+
+	for (usz i = 0; i < 2; ++i) {
+		i32 r = (c[i] >> 11) & 31, g = (c[i] >> 5) & 63, b = c[i] & 31;
+		colors[i][0] = (r << 3) | (r >> 2);
+		colors[i][1] = (g << 2) | (g >> 4);
+		colors[i][2] = (b << 3) | (b >> 2);
+		colors[i][3] = 255;
+	}
+
+	bool four = forceFourColors || c[0] > c[1];
+
+	for (usz j = 0; j < 3; ++j) {
+		colors[2][j] = four ? (2 * colors[0][j] + colors[1][j]) / 3 : (colors[0][j] + colors[1][j]) / 2;
+		colors[3][j] = four ? (colors[0][j] + 2 * colors[1][j]) / 3 : 0;
+	}
+
+	colors[2][3] = 255;
+	colors[3][3] = four ? 255 : 0;
+
+	u32 indices = u32(in[4] | (in[5] << 8) | (in[6] << 16) | (u32(in[7]) << 24));
+
+	for (usz i = 0; i < 16; ++i)
+		for (usz j = 0; j < 4; ++j)
+			out[i][j] = u8(colors[(indices >> (i * 2)) & 3][j]);
+}
+
+static void decodeBC4(const u8 *in, u8 (*out)[4], usz channel) {
+
+	i32 v[8] = { in[0], in[1] };
+
+	if (v[0] > v[1])
+		for (i32 i = 1; i < 7; ++i)
+			v[i + 1] = ((7 - i) * v[0] + i * v[1]) / 7;
+
+	else {
+
+		for (i32 i = 1; i < 5; ++i)
+			v[i + 1] = ((5 - i) * v[0] + i * v[1]) / 5;
+
+		v[6] = 0;
+		v[7] = 255;
+	}
+
+	u64 indices{};
+
+	for (usz i = 0; i < 6; ++i)
+		indices |= u64(in[2 + i]) << (i * 8);
+
+	for (usz i = 0; i < 16; ++i)
+		out[i][channel] = u8(v[(indices >> (i * 3)) & 7]);
+}
+
+static void decodeBC7Mode6(const u8 *in, u8 (*out)[4]) {
+
+	static constexpr i32 weights[] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	usz offset{};
+
+	auto read = [&](usz bits) -> u32 {
+
+		u32 v{};
+
+		for (usz i = 0; i < bits; ++i, ++offset)
+			v |= u32((in[offset >> 3] >> (offset & 7)) & 1) << i;
+
+		return v;
+	};
+
+	IGXI_CHECK(read(7) == 0x40);		//Mode 6
+
+	i32 e[2][4];
+
+	for (usz c = 0; c < 4; ++c)
+		for (usz i = 0; i < 2; ++i)
+			e[i][c] = i32(read(7)) << 1;
+
+	for (usz i = 0; i < 2; ++i) {
+
+		u32 p = read(1);
+
+		for (usz c = 0; c < 4; ++c)
+			e[i][c] |= i32(p);
+	}
+
+	for (usz i = 0; i < 16; ++i) {
+
+		i32 w = weights[read(i ? 4 : 3)];
+
+		for (usz c = 0; c < 4; ++c)
+			out[i][c] = u8(((64 - w) * e[0][c] + w * e[1][c] + 32) >> 6);
+	}
+}
+
+//Compare the channels that are encoded
+
+static void compare(const Block &block, const u8 (*decoded)[4], usz firstChannel, usz channels, f64 &sqError, i32 &maxError) {
+	for (usz i = 0; i < 16; ++i)
+		for (usz c = firstChannel; c < firstChannel + channels; ++c) {
+			i32 d = std::abs(i32(block.px[i][c]) - decoded[i][c]);
+			sqError += f64(d) * d;
+			maxError = std::max(maxError, d);
+		}
+}
+
+enum class Codec { BC1, BC3, BC4, BC5, BC7 };
+
+struct Error {
+	f64 rmse;
+	i32 max;
+};
+
+static Error roundTrip(const Block &block, Codec codec, u8 iterations) {
+
+	u8 encoded[16]{};
+	u8 decoded[16][4]{};
+
+	f64 sqError{};
+	i32 maxError{};
+	usz channels{};
+
+	switch (codec) {
+
+		case Codec::BC1:
+			encodeBC1(block, encoded, iterations);
+			decodeBC1(encoded, decoded);
+			compare(block, decoded, 0, channels = 3, sqError, maxError);
+			break;
+
+		case Codec::BC3:
+			encodeBC3(block, encoded, iterations);
+			decodeBC4(encoded, decoded, 3);
+			decodeBC1(encoded + 8, decoded, true);
+
+			//BC1 writes alpha as well, so the alpha from the BC4 block is decoded again after
+
+			decodeBC4(encoded, decoded, 3);
+			compare(block, decoded, 0, channels = 4, sqError, maxError);
+			break;
+
+		case Codec::BC4:
+			encodeBC4(block, encoded, iterations);
+			decodeBC4(encoded, decoded, 0);
+			compare(block, decoded, 0, channels = 1, sqError, maxError);
+			break;
+
+		case Codec::BC5:
+			encodeBC5(block, encoded, iterations);
+			decodeBC4(encoded, decoded, 0);
+			decodeBC4(encoded + 8, decoded, 1);
+			compare(block, decoded, 0, channels = 2, sqError, maxError);
+			break;
+
+		case Codec::BC7:
+			encodeBC7(block, encoded, iterations);
+			decodeBC7Mode6(encoded, decoded);
+			compare(block, decoded, 0, channels = 4, sqError, maxError);
+			break;
+	}
+
+	return { std::sqrt(sqError / f64(16 * channels)), maxError };
+}
+
+int main() {
+
+	static constexpr Codec codecs[] = { Codec::BC1, Codec::BC3, Codec::BC4, Codec::BC5, Codec::BC7 };
+
+	//A solid color is (almost) exact; BC1 can only be as exact as 565
+
+	for (Codec codec : codecs)
+		for (u32 seed = 0; seed < 64; ++seed) {
+
+			Block block;
+
+			for (usz i = 0; i < 16; ++i)
+				for (usz c = 0; c < 4; ++c)
+					block.px[i][c] = u8(seed * 37 + c * 101);
+
+			if (codec == Codec::BC1)
+				for (usz i = 0; i < 16; ++i)
+					block.px[i][3] = 255;
+
+			Error error = roundTrip(block, codec, 2);
+			i32 limit = codec == Codec::BC1 || codec == Codec::BC3 ? 4 : codec == Codec::BC7 ? 1 : 0;
+
+			IGXI_CHECK(error.max <= limit);
+		}
+
+	//Gradients and two colors are on a line, so they're only limited by the number of levels between the endpoints
+	//A ramp of 16 values over 4 (BC1/BC3), 8 (BC4/BC5) or 16 (BC7) levels
+
+	for (Codec codec : codecs)
+		for (u8 iterations : { u8(0), u8(2) }) {
+
+			f64 limit = codec == Codec::BC7 ? 2 : codec == Codec::BC4 || codec == Codec::BC5 ? 10 : 18;
+
+			Block block;
+
+			for (usz i = 0; i < 16; ++i) {
+				block.px[i][0] = u8(i * 16);
+				block.px[i][1] = u8(255 - i * 12);
+				block.px[i][2] = u8(40 + i * 8);
+				block.px[i][3] = codec == Codec::BC1 ? 255 : u8(i * 16 + 15);
+			}
+
+			IGXI_CHECK(roundTrip(block, codec, iterations).rmse < limit);
+
+			for (usz i = 0; i < 16; ++i)
+				for (usz c = 0; c < 4; ++c)
+					block.px[i][c] = (i ^ (i >> 2)) & 1 ? u8(200 - c * 30) : u8(10 + c * 20);
+
+			if (codec == Codec::BC1)
+				for (usz i = 0; i < 16; ++i)
+					block.px[i][3] = 255;
+
+			IGXI_CHECK(roundTrip(block, codec, iterations).max <= 4);
+		}
+
+	//Noise; refinement shouldn't make it worse
+
+	u32 state = 12345;
+
+	auto next = [&state]() -> u8 {
+		state = state * 1664525 + 1013904223;
+		return u8(state >> 24);
+	};
+
+	for (Codec codec : codecs) {
+
+		f64 fast{}, refined{};
+
+		for (u32 j = 0; j < 256; ++j) {
+
+			Block block;
+
+			for (usz i = 0; i < 16; ++i)
+				for (usz c = 0; c < 4; ++c)
+					block.px[i][c] = codec == Codec::BC1 && c == 3 ? 255 : next();
+
+			fast += roundTrip(block, codec, 0).rmse;
+			refined += roundTrip(block, codec, 4).rmse;
+		}
+
+		IGXI_CHECK(refined <= fast * 1.01);
+		IGXI_CHECK(refined / 256 < 64);
+	}
+
+	return test::result();
+}
@@ -0,0 +1,147 @@
+#include "test.hpp"
+#include "igxi/cache.hpp"
+#include <thread>
+
+using namespace igxi;
+using namespace ignis;
+
+static constexpr u16 size = 64;
+static constexpr usz imageSize = usz(size) * size * 4, fileSize = sizeof(DecodeCache::Header) + imageSize;
+
+static const GPUFormat rgba8 = GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4)));
+
+static void store(DecodeCache &cache, u64 key) {
+	Buffer image(imageSize, u8(key));
+	cache.store(key, size, size, rgba8, image.data(), image.size());
+}
+
+//Whether the image of the key is cached and has the texels it was stored with
+
+static bool contains(DecodeCache &cache, u64 key) {
+
+	DecodeCache::Header header{};
+	std::unique_ptr<MappedFile> file = cache.find(key, header);
+
+	if (!file)
+		return false;
+
+	bool valid = header.width == size && header.height == size && file->size() == fileSize;
+
+	for (usz i = sizeof(header); valid && i < file->size(); ++i)
+		valid = file->data()[i] == u8(key);
+
+	return valid;
+}
+
+int main() {
+
+	String directory = test::getDirectory("cache");
+
+	//The least recently used image is evicted first, where finding an image counts as a use
+
+	{
+		DecodeCache cache(directory, fileSize * 3);
+
+		store(cache, 1);
+		store(cache, 2);
+		store(cache, 3);
+
+		IGXI_CHECK(cache.getSize() == fileSize * 3);
+		IGXI_CHECK(contains(cache, 1) && contains(cache, 2) && contains(cache, 3));
+
+		IGXI_CHECK(contains(cache, 1));
+		store(cache, 4);
+
+		IGXI_CHECK(cache.getSize() == fileSize * 3);
+		IGXI_CHECK(!contains(cache, 2));
+		IGXI_CHECK(contains(cache, 3) && contains(cache, 1) && contains(cache, 4));
+
+		IGXI_CHECK(cache.getHits() == 7 && cache.getMisses() == 1);
+
+		//Storing a key again doesn't change anything and an image that doesn't fit isn't stored
+
+		store(cache, 4);
+		IGXI_CHECK(cache.getSize() == fileSize * 3);
+
+		Buffer big(fileSize * 3);
+		cache.store(5, size, size * 3, rgba8, big.data(), big.size());
+
+		IGXI_CHECK(!contains(cache, 5) && cache.getSize() == fileSize * 3);
+	}
+
+	//The next run continues from the write times; uses are ordered 3 (oldest), 1, 4 (newest)
+
+	{
+		auto now = std::filesystem::file_time_type::clock::now();
+		std::error_code error;
+		usz files{};
+
+		for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(directory, error)) {
+
+			String name = entry.path().stem().string();
+			u64 key = std::stoull(name, nullptr, 16);
+
+			std::filesystem::last_write_time(entry.path(), now - std::chrono::hours(key == 3 ? 3 : (key == 1 ? 2 : 1)), error);
+			++files;
+		}
+
+		IGXI_CHECK(files == 3);
+
+		DecodeCache cache(directory, fileSize * 2);
+
+		IGXI_CHECK(cache.getSize() == fileSize * 2);
+		IGXI_CHECK(contains(cache, 1) && contains(cache, 4) && !contains(cache, 3));
+		IGXI_CHECK(!std::filesystem::exists(directory + "/0000000000000003.igxic"));
+	}
+
+	//Keys only depend on the flags that change the decoded image
+
+	{
+		u8 file[100];
+
+		for (usz i = 0; i < sizeof(file); ++i)
+			file[i] = u8(i * 3);
+
+		u64 key = DecodeCache::getKey(file, sizeof(file), Helper::DEFAULT);
+
+		IGXI_CHECK(key == DecodeCache::getKey(file, sizeof(file), Helper::Flags(Helper::DEFAULT | Helper::GENERATE_MIPS)));
+		IGXI_CHECK(key != DecodeCache::getKey(file, sizeof(file), Helper::Flags(Helper::DEFAULT | Helper::IS_SRGB)));
+		IGXI_CHECK(key != DecodeCache::getKey(file, sizeof(file) - 1, Helper::DEFAULT));
+
+		file[50] ^= 1;
+		IGXI_CHECK(key != DecodeCache::getKey(file, sizeof(file), Helper::DEFAULT));
+	}
+
+	//Two caches on the same directory (like two processes) storing the same images at once
+	//Every store writes its own temporary file, so each image is whole and no temporary file is left
+
+	{
+		String shared = test::getDirectory("cache-shared");
+
+		DecodeCache a(shared, u64(1) << 30), b(shared, u64(1) << 30);
+		List<std::thread> threads;
+
+		for (u32 i = 0; i < 8; ++i)
+			threads.emplace_back([&, i]() {
+				for (u64 key = 0; key < 16; ++key)
+					store(i & 1 ? a : b, key);
+			});
+
+		for (std::thread &thread : threads)
+			thread.join();
+
+		for (u64 key = 0; key < 16; ++key)
+			IGXI_CHECK(contains(a, key) && contains(b, key));
+
+		for (const auto &entry : std::filesystem::directory_iterator(shared))
+			IGXI_CHECK(entry.path().extension() != ".tmp");
+
+		std::error_code error;
+		std::filesystem::remove_all(shared, error);
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+
+	return test::result();
+}
@@ -0,0 +1,210 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+#include "igxi/compress.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+template<typename T>
+static void put(Buffer &file, usz offset, T v) {
+
+	if (file.size() < offset + sizeof(T))
+		file.resize(offset + sizeof(T));
+
+	std::memcpy(file.data() + offset, &v, sizeof(T));
+}
+
+//A DDS with a DX10 header; every layer has all of its mips, which are filled with layer * 16 + mip
+
+static Buffer makeDDS(u32 width, u32 height, u32 mips, u32 dxgi, u32 arraySize, bool cube, const List<usz> &mipSizes) {
+
+	Buffer file(148);
+	std::memcpy(file.data(), "DDS ", 4);
+
+	put<u32>(file, 4, 124);
+	put<u32>(file, 12, height);
+	put<u32>(file, 16, width);
+	put<u32>(file, 28, mips);
+	put<u32>(file, 80, 0x4);				//DDPF_FOURCC
+	put<u32>(file, 84, 0x30315844);			//DX10
+	put<u32>(file, 128, dxgi);
+	put<u32>(file, 132, 3);					//2D
+	put<u32>(file, 136, cube ? 0x4 : 0);
+	put<u32>(file, 140, arraySize);
+
+	u32 layers = arraySize * (cube ? 6 : 1);
+
+	for (u32 layer = 0; layer < layers; ++layer)
+		for (u32 mip = 0; mip < mips; ++mip)
+			file.insert(file.end(), mipSizes[mip], u8(layer * 16 + mip));
+
+	return file;
+}
+
+//A DDS without DX10 header with a 32-bit RGB(A) pixel format
+
+static Buffer makeLegacyDDS(u32 width, u32 height, u32 pixelFlags, u32 alphaMask) {
+
+	Buffer file(128);
+	std::memcpy(file.data(), "DDS ", 4);
+
+	put<u32>(file, 4, 124);
+	put<u32>(file, 12, height);
+	put<u32>(file, 16, width);
+	put<u32>(file, 28, 1);
+	put<u32>(file, 80, pixelFlags);
+	put<u32>(file, 88, 32);
+	put<u32>(file, 92, 0xFF);
+	put<u32>(file, 96, 0xFF00);
+	put<u32>(file, 100, 0xFF0000);
+	put<u32>(file, 104, alphaMask);
+
+	file.resize(128 + usz(width) * height * 4, 0x7F);
+	return file;
+}
+
+//A KTX2 3D texture; every level is filled with mip + 1
+
+static Buffer makeKTX2(u32 vkFormat, u32 size, u32 mips, const List<usz> &mipSizes) {
+
+	static constexpr u8 identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	Buffer file(80 + 24 * mips);
+	std::memcpy(file.data(), identifier, sizeof(identifier));
+
+	put<u32>(file, 12, vkFormat);
+	put<u32>(file, 20, size);
+	put<u32>(file, 24, size);
+	put<u32>(file, 28, size);
+	put<u32>(file, 36, 1);
+	put<u32>(file, 40, mips);
+
+	//Levels are stored from the smallest mip
+
+	for (u32 mip = mips; mip-- > 0; ) {
+
+		usz offset = file.size();
+
+		put<u64>(file, 80 + 24 * mip, offset);
+		put<u64>(file, 80 + 24 * mip + 8, mipSizes[mip]);
+
+		file.insert(file.end(), mipSizes[mip], u8(mip + 1));
+	}
+
+	return file;
+}
+
+static Helper::ErrorMessage convertFile(const String &path, const Buffer &file, IGXI &out) {
+	IGXI_CHECK(test::writeFile(path, file));
+	return Helper::convertContainer(out, path);
+}
+
+int main() {
+
+	String directory = test::getDirectory("container");
+
+	//BC7 cube array; 2 cubes of 16x16 with 5 mips (4x4 blocks of 16 bytes, so the last 3 mips are 1 block)
+
+	{
+		List<usz> mipSizes = { 256, 64, 16, 16, 16 };
+
+		IGXI out;
+		Helper::ErrorMessage msg = convertFile(directory + "/cubes.dds", makeDDS(16, 16, 5, 98, 2, true, mipSizes), out);
+
+		IGXI_CHECK(msg == Helper::SUCCESS);
+
+		if (msg == Helper::SUCCESS) {
+
+			IGXI_CHECK(out.header.type == TextureType(u8(TextureType::TEXTURE_CUBE) | u8(TextureType::PROPERTY_IS_ARRAY)));
+			IGXI_CHECK(out.header.width == 16 && out.header.height == 16 && out.header.layers == 12 && out.header.mips == 5);
+			IGXI_CHECK(out.format.size() == 1 && out.format[0] == getGPUFormat(CompressedFormat::BC7));
+
+			for (u32 mip = 0; mip < 5; ++mip) {
+
+				IGXI_CHECK(out.data[0][mip].size() == mipSizes[mip] * 12);
+
+				for (u32 layer = 0; layer < 12; ++layer) {
+					const u8 *begin = out.data[0][mip].data() + mipSizes[mip] * layer;
+					IGXI_CHECK(begin[0] == u8(layer * 16 + mip) && begin[mipSizes[mip] - 1] == u8(layer * 16 + mip));
+				}
+			}
+		}
+	}
+
+	//Legacy RGBA8 needs an alpha mask; RGBX8 has no format to copy into
+
+	{
+		IGXI out;
+
+		IGXI_CHECK(convertFile(directory + "/rgba.dds", makeLegacyDDS(4, 2, 0x41, 0xFF000000), out) == Helper::SUCCESS);
+		IGXI_CHECK(out.format.size() == 1 && out.format[0] == GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4))));
+		IGXI_CHECK(out.data.size() == 1 && out.data[0].size() == 1 && out.data[0][0].size() == 4 * 2 * 4);
+
+		IGXI_CHECK(convertFile(directory + "/rgbx.dds", makeLegacyDDS(4, 2, 0x40, 0), out) == Helper::INVALID_FORMAT);
+	}
+
+	//KTX2 RGBA8 volume of 4x4x4 with 3 mips
+
+	{
+		List<usz> mipSizes = { 4 * 4 * 4 * 4, 2 * 2 * 2 * 4, 4 };
+
+		IGXI out;
+		Helper::ErrorMessage msg = convertFile(directory + "/volume.ktx2", makeKTX2(37, 4, 3, mipSizes), out);
+
+		IGXI_CHECK(msg == Helper::SUCCESS);
+
+		if (msg == Helper::SUCCESS) {
+
+			IGXI_CHECK(out.header.type == TextureType::TEXTURE_3D && out.header.length == 4 && out.header.layers == 1);
+
+			for (u32 mip = 0; mip < 3; ++mip)
+				IGXI_CHECK(
+					out.data[0][mip].size() == mipSizes[mip] && 
+					out.data[0][mip].front() == mip + 1 && out.data[0][mip].back() == mip + 1
+				);
+		}
+
+		//Supercompression isn't supported
+
+		Buffer supercompressed = makeKTX2(37, 4, 3, mipSizes);
+		put<u32>(supercompressed, 44, 2);
+
+		IGXI_CHECK(convertFile(directory + "/zstd.ktx2", supercompressed, out) == Helper::INVALID_OPERATION);
+	}
+
+	//Mips of sizes that aren't a power of two are rounded down by containers, but up by IGXI
+
+	{
+		IGXI out;
+		Buffer file = makeDDS(5, 5, 3, 28, 1, false, { 100, 16, 4 });
+
+		IGXI_CHECK(convertFile(directory + "/npot.dds", file, out) == Helper::INVALID_IMAGE_SIZE);
+
+		file = makeDDS(4, 4, 3, 28, 1, false, { 64, 16, 4 });
+		file.resize(file.size() - 1);
+
+		IGXI_CHECK(convertFile(directory + "/truncated.dds", file, out) == Helper::INVALID_FILE_BOUNDS);
+	}
+
+	//Containers are found by path and name, but can't be combined with other files
+
+	{
+		IGXI out;
+
+		IGXI_CHECK(Helper::convert(out, directory + "/volume.ktx2", Helper::NONE) == Helper::SUCCESS);
+		IGXI_CHECK(out.header.type == TextureType::TEXTURE_3D);
+
+		IGXI_CHECK(Helper::convert(out, directory + "/volume", Helper::NONE) == Helper::SUCCESS);
+		IGXI_CHECK(out.header.length == 4);
+
+		IGXI_CHECK(
+			Helper::convert(out, List<String>{ directory + "/volume.ktx2", directory + "/image.png" }, Helper::NONE) == 
+			Helper::INVALID_OPERATION
+		);
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+
+	return test::result();
+}
@@ -0,0 +1,252 @@
+#include "test.hpp"
+#include "igxi/cube.hpp"
+#include "igxi/png.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+//The images are a color per direction (the normalized direction in rgb), so every face can be checked
+//	against where it should point (getCubeDirection) and neighboring pixels on different faces have to be close
+
+static const GPUFormat rgba8 = GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4)));
+static const GPUFormat rgba32f = GPUFormat(u16(3 | (3 << 2) | (u8(GPUFormatType::FLOAT) << 4)));
+
+static void normalize(f32 *dir) {
+
+	f32 len = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+
+	for (usz i = 0; i < 3; ++i)
+		dir[i] /= len;
+}
+
+static f32 getCoord(usz i, usz size) {
+	return (i + .5f) / size * 2 - 1;
+}
+
+static void getFaceDirection(u8 face, usz x, usz y, u16 faceSize, f32 *dir) {
+	getCubeDirection(face, getCoord(x, faceSize), getCoord(y, faceSize), dir);
+	normalize(dir);
+}
+
+//The faces as they should be (in order of +x, -x, +y, -y, +z, -z)
+
+static Buffer makeFaces(u16 faceSize) {
+
+	Buffer faces(usz(faceSize) * faceSize * 6 * 4);
+
+	for (u8 face = 0; face < 6; ++face)
+		for (usz y = 0; y < faceSize; ++y)
+			for (usz x = 0; x < faceSize; ++x) {
+
+				f32 dir[3];
+				getFaceDirection(face, x, y, faceSize, dir);
+
+				u8 *texel = faces.data() + ((usz(face) * faceSize + y) * faceSize + x) * 4;
+
+				for (usz c = 0; c < 3; ++c)
+					texel[c] = u8(std::lround(127.5f + 127 * dir[c]));
+
+				texel[3] = 255;
+			}
+
+	return faces;
+}
+
+//Cells of the faces in the crosses, as described by CubeLayout
+
+struct Cell { usz x, y; bool flip; };
+
+static constexpr Cell horizontalCells[6] = {
+	{ 2, 1, false }, { 0, 1, false }, { 1, 0, false }, { 1, 2, false }, { 1, 1, false }, { 3, 1, false }
+};
+
+static constexpr Cell verticalCells[6] = {
+	{ 2, 1, false }, { 0, 1, false }, { 1, 0, false }, { 1, 2, false }, { 1, 1, false }, { 1, 3, true }
+};
+
+//Put the faces in a cross and check that it's seamless; every neighbor in the cross is a neighbor on the cube
+//Then it has to be split into the same faces again
+
+static void checkCross(CubeLayout layout, u16 faceSize) {
+
+	bool horizontal = layout == CubeLayout::HORIZONTAL_CROSS;
+	const Cell *cells = horizontal ? horizontalCells : verticalCells;
+
+	usz width = faceSize * (horizontal ? 4 : 3), height = faceSize * (horizontal ? 3 : 4);
+
+	Buffer faces = makeFaces(faceSize), cross(width * height * 4);
+	List<bool> used(width * height);
+
+	for (u8 face = 0; face < 6; ++face)
+		for (usz y = 0; y < faceSize; ++y)
+			for (usz x = 0; x < faceSize; ++x) {
+
+				const Cell &cell = cells[face];
+				usz sx = cell.flip ? faceSize - 1 - x : x, sy = cell.flip ? faceSize - 1 - y : y;
+				usz i = (cell.y * faceSize + sy) * width + cell.x * faceSize + sx;
+
+				const u8 *texel = faces.data() + ((usz(face) * faceSize + y) * faceSize + x) * 4;
+				std::memcpy(cross.data() + i * 4, texel, 4);
+				used[i] = true;
+			}
+
+	u32 maxStep{};
+
+	for (usz y = 0; y < height; ++y)
+		for (usz x = 0; x < width; ++x) {
+
+			usz i = y * width + x;
+
+			if (!used[i])
+				continue;
+
+			for (usz j : { i + 1, i + width })
+				if ((j != i + 1 || x + 1 < width) && j < used.size() && used[j])
+					for (usz c = 0; c < 3; ++c)
+						maxStep = std::max(maxStep, u32(std::abs(i32(cross[i * 4 + c]) - i32(cross[j * 4 + c]))));
+		}
+
+	//Neighbors are a pixel (about 2 / faceSize radians) apart, a seam that doesn't line up is far more
+
+	IGXI_CHECK(maxStep <= u32(512 / faceSize + 1));
+
+	Buffer result(faces.size());
+	IGXI_CHECK(toCube(cross.data(), u16(width), u16(height), rgba8, layout, result.data(), 2) == Helper::SUCCESS);
+	IGXI_CHECK(result == faces);
+}
+
+//Sample a panorama of the directions and check every face against its direction and across the seams
+
+static void checkPanorama(u16 height) {
+
+	u16 width = height * 2, faceSize = width / 4;
+
+	List<f32> panorama(usz(width) * height * 4);
+
+	for (usz y = 0; y < height; ++y)
+		for (usz x = 0; x < width; ++x) {
+
+			//-z is the center and +y the top
+
+			f64 phi = ((x + .5) / width - .5) * 2 * 3.14159265358979323846;
+			f64 theta = (y + .5) / height * 3.14159265358979323846;
+
+			f32 *texel = panorama.data() + (y * width + x) * 4;
+			texel[0] = f32(std::sin(theta) * std::sin(phi));
+			texel[1] = f32(std::cos(theta));
+			texel[2] = f32(-std::sin(theta) * std::cos(phi));
+			texel[3] = 1;
+		}
+
+	List<f32> faces(usz(faceSize) * faceSize * 6 * 4);
+
+	IGXI_CHECK(
+		toCube(
+			(const u8*) panorama.data(), width, height, rgba32f, CubeLayout::EQUIRECTANGULAR, (u8*) faces.data(), 2
+		) == Helper::SUCCESS
+	);
+
+	auto texel = [&](u8 face, usz x, usz y) {
+		return faces.data() + ((usz(face) * faceSize + y) * faceSize + x) * 4;
+	};
+
+	//Every face points where it should
+	//Close to the poles the panorama only has half a pixel (clamped), so it's less exact there
+
+	f32 maxError{};
+
+	for (u8 face = 0; face < 6; ++face)
+		for (usz y = 0; y < faceSize; ++y)
+			for (usz x = 0; x < faceSize; ++x) {
+
+				f32 dir[3];
+				getFaceDirection(face, x, y, faceSize, dir);
+
+				for (usz c = 0; c < 3; ++c)
+					maxError = std::max(maxError, std::abs(texel(face, x, y)[c] - dir[c]));
+			}
+
+	IGXI_CHECK(maxError < 4.f / height);
+
+	//A pixel on the edge of a face and the pixel next to it on the neighboring face are about a pixel apart
+
+	f32 maxStep{};
+
+	for (u8 face = 0; face < 6; ++face)
+		for (usz i = 0; i < faceSize; ++i)
+			for (usz edge = 0; edge < 4; ++edge) {
+
+				usz x = edge == 0 ? 0 : (edge == 1 ? faceSize - 1 : i);
+				usz y = edge == 2 ? 0 : (edge == 3 ? faceSize - 1 : i);
+
+				//Step a pixel over the edge and find the face there
+
+				f32 pixel = 2.f / faceSize;
+				f32 s = getCoord(x, faceSize) + (edge == 0 ? -pixel : (edge == 1 ? pixel : 0));
+				f32 t = getCoord(y, faceSize) + (edge == 2 ? -pixel : (edge == 3 ? pixel : 0));
+
+				f32 dir[3];
+				getCubeDirection(face, s, t, dir);
+
+				u8 other = getCubeFace(dir, s, t);
+				IGXI_CHECK(other != face);
+
+				usz ox = std::min(usz((s + 1) / 2 * faceSize), usz(faceSize - 1));
+				usz oy = std::min(usz((t + 1) / 2 * faceSize), usz(faceSize - 1));
+
+				for (usz c = 0; c < 3; ++c)
+					maxStep = std::max(maxStep, std::abs(texel(face, x, y)[c] - texel(other, ox, oy)[c]));
+			}
+
+	IGXI_CHECK(maxStep < 4.f / faceSize);
+}
+
+int main() {
+
+	checkCross(CubeLayout::HORIZONTAL_CROSS, 64);
+	checkCross(CubeLayout::VERTICAL_CROSS, 64);
+	checkCross(CubeLayout::HORIZONTAL_CROSS, 1);
+	checkCross(CubeLayout::VERTICAL_CROSS, 1);
+
+	checkPanorama(256);
+	checkPanorama(34);
+
+	//Panoramas have to be exactly 2:1 (and have a face of at least a pixel)
+
+	IGXI_CHECK(getCubeLayout(512, 256) == CubeLayout::EQUIRECTANGULAR);
+	IGXI_CHECK(getCubeLayout(4, 2) == CubeLayout::EQUIRECTANGULAR);
+	IGXI_CHECK(getCubeLayout(512, 255) == CubeLayout::NONE && getCubeLayout(513, 256) == CubeLayout::NONE);
+	IGXI_CHECK(getCubeLayout(2, 1) == CubeLayout::NONE);
+
+	{
+		Buffer image(usz(512) * 257 * 4), faces(usz(128) * 128 * 6 * 4);
+
+		auto convert = [&](u16 width, u16 height, CubeLayout layout) {
+			return toCube(image.data(), width, height, rgba8, layout, faces.data());
+		};
+
+		IGXI_CHECK(convert(512, 257, CubeLayout::EQUIRECTANGULAR) == Helper::INVALID_IMAGE_SIZE);
+		IGXI_CHECK(convert(2, 1, CubeLayout::EQUIRECTANGULAR) == Helper::INVALID_IMAGE_SIZE);
+		IGXI_CHECK(convert(512, 256, CubeLayout::HORIZONTAL_CROSS) == Helper::INVALID_IMAGE_SIZE);
+	}
+
+	//And so does a whole cube from a file
+
+	{
+		String dir = test::getDirectory("cube");
+		String path = dir + "/panorama.png";
+
+		Buffer image(usz(300) * 140 * 4, 255);
+		IGXI_CHECK(test::writeFile(path, encodePNG(image.data(), 300 * 4, 300, 140, 4, 1, 1)));
+
+		IGXI out;
+		const Helper::Flags flags = Helper::Flags(Helper::IS_CUBE | Helper::CUBE_FROM_IMAGE);
+
+		IGXI_CHECK(Helper::convert(out, { Helper::FileDesc{ path, {} } }, flags, 1, 1) == Helper::INVALID_IMAGE_SIZE);
+
+		std::error_code error;
+		std::filesystem::remove_all(dir, error);
+	}
+
+	return test::result();
+}
@@ -0,0 +1,137 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+#include "igxi/png.hpp"
+#include "stb/stb_image.h"
+
+//stb_image is implemented in the library (convert.cpp), so the reference decodes with the same decoder
+
+using namespace igxi;
+using namespace ignis;
+
+static Buffer makeImage(u16 width, u16 height, u8 channels, u8 bytesPerChannel, u32 seed) {
+
+	Buffer image(usz(width) * height * channels * bytesPerChannel);
+
+	for (usz i = 0; i < image.size(); ++i) {
+		seed = seed * 1664525 + 1013904223;
+		image[i] = u8(seed >> 24);
+	}
+
+	return image;
+}
+
+//What convert did before decoding in place: decode into stb's buffer, copy it into a temporary buffer
+//	(value by value, with the missing channels left zero) and copy that into the subresource
+
+static Buffer decodeCopy(const Buffer &png, int channelCount, u8 &bytes, u8 &outChannels) {
+
+	int x{}, y{}, comp{};
+	void *data;
+
+	bytes = u8(stbi_is_16_bit_from_memory(png.data(), int(png.size())) ? 2 : 1);
+
+	if (bytes == 2)
+		data = stbi_load_16_from_memory(png.data(), int(png.size()), &x, &y, &comp, channelCount);
+
+	else data = stbi_load_from_memory(png.data(), int(png.size()), &x, &y, &comp, channelCount);
+
+	if (!data)
+		return {};
+
+	int inChannels = channelCount ? channelCount : comp;
+	outChannels = u8(inChannels == 3 ? 4 : inChannels);
+
+	Buffer temp(usz(x) * y * outChannels * bytes);
+
+	for (usz i = 0; i < usz(x) * y; ++i)
+		for (usz c = 0; c < usz(inChannels); ++c)
+			std::memcpy(
+				temp.data() + (i * outChannels + c) * bytes,
+				(const u8*) data + (i * inChannels + c) * bytes,
+				bytes
+			);
+
+	stbi_image_free(data);
+	return temp;
+}
+
+//Decode files into one IGXI and compare every slice against the copy path
+
+static void check(const String &dir, const List<Buffer> &pngs, Helper::Flags flags, int channelCount) {
+
+	List<Helper::FileDesc> descs;
+	const bool is3D = flags & Helper::IS_3D;
+
+	for (usz i = 0; i < pngs.size(); ++i) {
+
+		String path = dir + "/image" + std::to_string(i) + ".png";
+		test::writeFile(path, pngs[i]);
+
+		descs.push_back({ path, { u16(is3D ? i : 0), u16(is3D ? 0 : i), 0 } });
+	}
+
+	IGXI out;
+	IGXI_CHECK(Helper::convert(out, descs, flags, 1, 1) == Helper::SUCCESS);
+
+	if (out.data.empty() || out.data[0].empty())
+		return;
+
+	Buffer expected;
+	u8 bytes{}, outChannels{};
+
+	for (const Buffer &png : pngs) {
+		Buffer slice = decodeCopy(png, channelCount, bytes, outChannels);
+		expected.insert(expected.end(), slice.begin(), slice.end());
+	}
+
+	IGXI_CHECK(out.header.formats == 1 && out.header.mips == 1);
+	IGXI_CHECK(FormatHelper::getSizeBytes(out.format[0]) == usz(bytes) * outChannels);
+	IGXI_CHECK(out.data[0][0] == expected);
+}
+
+int main() {
+
+	String dir = test::getDirectory("decode");
+
+	//Every channel count at 8 and 16 bits, with the input's channels and with other channel counts requested
+	//	Odd sizes, so the vector loops of the kernels have remainders
+
+	constexpr Helper::Flags channelFlags[] = { Helper::NONE, Helper::IS_R, Helper::IS_RG, Helper::IS_RGB, Helper::IS_RGBA };
+
+	for (u8 bytesPerChannel = 1; bytesPerChannel <= 2; ++bytesPerChannel)
+		for (u8 channels = 1; channels <= 4; ++channels)
+			for (int requested = 0; requested <= 4; ++requested) {
+
+				u16 width = 37, height = 19;
+				Buffer image = makeImage(width, height, channels, bytesPerChannel, channels);
+
+				Buffer png = encodePNG(
+					image.data(), i64(width) * channels * bytesPerChannel, width, height, channels, bytesPerChannel, 1
+				);
+
+				check(dir, { png }, Helper::Flags(Helper::IS_2D | channelFlags[requested]), requested);
+			}
+
+	//Multiple files end up in their own layer or z slice
+
+	for (Helper::Flags type : { Helper::Flags(Helper::IS_2D | Helper::IS_ARRAY), Helper::IS_3D }) {
+
+		List<Buffer> pngs;
+
+		for (u32 i = 0; i < 3; ++i) {
+			Buffer image = makeImage(13, 7, 3, 1, i + 10);
+			pngs.push_back(encodePNG(image.data(), 13 * 3, 13, 7, 3, 1, 1));
+		}
+
+		check(dir, pngs, type, 0);
+	}
+
+	//1D reads all rows as one
+
+	{
+		Buffer image = makeImage(5, 3, 4, 2, 20);
+		check(dir, { encodePNG(image.data(), 5 * 4 * 2, 5, 3, 4, 2, 1) }, Helper::IS_1D, 0);
+	}
+
+	return test::result();
+}
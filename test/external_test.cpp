@@ -0,0 +1,200 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+#include "igxi/mips.hpp"
+#include "stb/stb_image.h"
+#include <cstdlib>
+
+using namespace igxi;
+using namespace ignis;
+
+//Encoding in parallel has to give the same images, in the same order, as encoding them one after another
+//Writing them to disk (through the bounded queue of the writer) has to give the same files
+
+static const GPUFormat rg16 = GPUFormat(u16(1 | (1 << 2) | (u8(GPUFormatType::UNORM) << 4)));
+static const GPUFormat rgba8 = GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4)));
+
+//Random texels for every format and mip
+
+static IGXI makeIGXI(u16 width, u16 height, u16 length, u16 layers, const List<GPUFormat> &formats, u32 seed) {
+
+	u16 mips = getMipCount(width, height, length);
+
+	IGXI igxi;
+	igxi.header.width = width;
+	igxi.header.height = height;
+	igxi.header.length = length;
+	igxi.header.layers = layers;
+	igxi.header.formats = u8(formats.size());
+	igxi.header.mips = u8(mips);
+	igxi.header.type = length > 1 ? TextureType::TEXTURE_3D : TextureType::TEXTURE_2D;
+	igxi.format = formats;
+	igxi.data.resize(formats.size());
+
+	for (usz i = 0; i < formats.size(); ++i) {
+
+		Vec3u16 dim{ width, height, length };
+
+		for (u16 mip = 0; mip < mips; ++mip) {
+
+			Buffer texels(usz(dim.x) * dim.y * dim.z * layers * FormatHelper::getSizeBytes(formats[i]));
+
+			for (u8 &texel : texels) {
+				seed = seed * 1664525 + 1013904223;
+				texel = u8(seed >> 24);
+			}
+
+			igxi.data[i].push_back(std::move(texels));
+			dim = (dim.cast<Vec3f32>() / 2.f).ceil().cast<Vec3u16>();
+		}
+	}
+
+	return igxi;
+}
+
+static void check(const IGXI &igxi, f32 quality) {
+
+	using Images = HashMap<GPUFormat, List<Pair<Helper::FileDesc, Buffer>>>;
+
+	Images expected = Helper::toMemoryExternal(igxi, quality, 1);
+
+	IGXI_CHECK(expected.size() == igxi.format.size());
+
+	//Single threaded, every format lists its images by mip, layer and z; each the same as encoding it on its own
+
+	for (auto &[format, images] : expected) {
+
+		usz i{};
+		Vec3u16 dim{ igxi.header.width, igxi.header.height, igxi.header.length };
+
+		for (u8 mip = 0; mip < igxi.header.mips; ++mip) {
+
+			for (u16 layer = 0; layer < igxi.header.layers; ++layer)
+				for (u16 z = 0; z < dim.z; ++z, ++i) {
+
+					IGXI_CHECK(i < images.size());
+
+					if (i >= images.size())
+						return;
+
+					const Helper::ImageIdentifier &iid = images[i].first.iid;
+					IGXI_CHECK(iid.z == z && iid.layer == layer && iid.mip == mip);
+
+					Buffer image = Helper::toExternal(igxi, ExternalFormat::PNG, format, dim, z, layer, mip, quality);
+					IGXI_CHECK(!image.empty() && images[i].second == image);
+				}
+
+			dim = (dim.cast<Vec3f32>() / 2.f).ceil().cast<Vec3u16>();
+		}
+
+		IGXI_CHECK(i == images.size());
+	}
+
+	//In parallel, the same names and buffers in the same order
+
+	for (u32 threads : { 2u, 3u, 8u, 0u }) {
+
+		Images images = Helper::toMemoryExternal(igxi, quality, threads);
+
+		IGXI_CHECK(images.size() == expected.size());
+
+		for (auto &[format, list] : expected) {
+
+			auto it = images.find(format);
+			IGXI_CHECK(it != images.end() && it->second.size() == list.size());
+
+			if (it == images.end() || it->second.size() != list.size())
+				continue;
+
+			for (usz i = 0; i < list.size(); ++i) {
+
+				const Helper::FileDesc &a = it->second[i].first, &b = list[i].first;
+
+				bool equal =
+					a.path == b.path && a.iid.z == b.iid.z && a.iid.layer == b.iid.layer && a.iid.mip == b.iid.mip &&
+					it->second[i].second == list[i].second;
+
+				if (!equal)
+					std::fprintf(stderr, "Image %zu (%s) with %u threads is different\n", i, b.path.c_str(), threads);
+
+				IGXI_CHECK(equal);
+			}
+		}
+	}
+}
+
+//Every file that toDiskExternal writes is the image toMemoryExternal gives on a single thread
+
+static void checkDisk(const IGXI &igxi, const String &dir, f32 quality) {
+
+	auto expected = Helper::toMemoryExternal(igxi, quality, 1);
+
+	for (u32 threads : { 1u, 2u, 8u, 0u }) {
+
+		String path = dir + "/" + std::to_string(threads) + "_";
+		IGXI_CHECK(Helper::toDiskExternal(igxi, path, quality, threads).empty());
+
+		for (auto &[format, images] : expected)
+			for (auto &[desc, image] : images) {
+
+				std::ifstream in(path + desc.path, std::ios::binary);
+				Buffer file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+				if (file != image)
+					std::fprintf(stderr, "File %s with %u threads is different\n", desc.path.c_str(), threads);
+
+				IGXI_CHECK(file == image);
+			}
+	}
+}
+
+int main() {
+
+	String dir = test::getDirectory("external");
+
+	//A mipped array with two formats, a 3D texture and a single image; stored and compressed
+
+	for (f32 quality : { 0.f, 1.f }) {
+		check(makeIGXI(37, 19, 1, 3, { rgba8, rg16 }, 1), quality);
+		check(makeIGXI(13, 7, 5, 1, { rgba8 }, 2), quality);
+		check(makeIGXI(1, 1, 1, 1, { rgba8 }, 3), quality);
+	}
+
+	//Far more images than the writer queues, so the encoders have to wait for it
+
+	for (f32 quality : { 0.f, 1.f })
+		checkDisk(makeIGXI(16, 8, 1, 64, { rgba8, rg16 }, 4), dir, quality);
+
+	//Images are flipped while encoding (by a negative stride), so the first row of the file is the last row of the texture
+
+	{
+		IGXI igxi = makeIGXI(7, 5, 1, 2, { rgba8 }, 5);
+		auto images = Helper::toMemoryExternal(igxi, 1, 1);
+
+		const Buffer &png = images[rgba8][1].second;
+		IGXI_CHECK(images[rgba8][1].first.iid.layer == 1);
+
+		int x{}, y{}, comp{};
+		u8 *pixels = stbi_load_from_memory(png.data(), int(png.size()), &x, &y, &comp, 4);
+		IGXI_CHECK(pixels && x == 7 && y == 5);
+
+		if (pixels)
+			for (usz row = 0; row < 5; ++row) {
+				const u8 *texels = igxi.data[0][0].data() + ((usz(1) * 5 + 4 - row) * 7) * 4;
+				IGXI_CHECK(!std::memcmp(pixels + row * 7 * 4, texels, 7 * 4));
+			}
+
+		std::free(pixels);
+	}
+
+	//Images that can't be written give their formats back
+
+	{
+		IGXI igxi = makeIGXI(8, 8, 1, 2, { rgba8, rg16 }, 6);
+		IGXI_CHECK(Helper::toDiskExternal(igxi, dir + "/missing/image", 1, 0) == List<GPUFormat>{ rgba8, rg16 });
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(dir, error);
+
+	return test::result();
+}
@@ -0,0 +1,109 @@
+#include "test.hpp"
+#include "igxi/file_index.hpp"
+
+using namespace igxi;
+
+static bool parses(
+	const String &path, Helper::Flags flags, const String &base, 
+	u16 side = 0, u16 z = 0, u8 mip = 0, u16 slice = 0, u16 sample = 0
+) {
+
+	ParsedFileName parsed;
+
+	return 
+		parseFileName(path, flags, parsed) == Helper::SUCCESS && parsed.base == base && parsed.side == side && 
+		parsed.z == z && parsed.mip == mip && parsed.slice == slice && parsed.sample == sample;
+}
+
+static Helper::ErrorMessage parseError(const String &path, Helper::Flags flags) {
+	ParsedFileName parsed;
+	return parseFileName(path, flags, parsed);
+}
+
+int main() {
+
+	using F = Helper::Flags;
+
+	const F mips = F(Helper::IS_2D | Helper::GENERATE_MIPS), noMips = F(Helper::IS_2D);
+	const F array = F(Helper::IS_ARRAY | Helper::GENERATE_MIPS), arrayMips = F(Helper::IS_ARRAY);
+	const F cube = F(Helper::IS_CUBE | Helper::GENERATE_MIPS), cubeMips = F(Helper::IS_CUBE);
+	const F cubeArray = F(Helper::IS_CUBE | Helper::IS_ARRAY);
+	const F volume = F(Helper::IS_3D | Helper::GENERATE_MIPS);
+
+	//Only the numbers the flags need are parsed; the directory and extension are ignored
+
+	IGXI_CHECK(parses("sky.png", mips, "sky"));
+	IGXI_CHECK(parses("dir.1/sky_2.png", noMips, "sky", 0, 0, 2));
+	IGXI_CHECK(parses("sky3.png", noMips, "sky", 0, 0, 3));
+	IGXI_CHECK(parses("sky_3.png", mips, "sky_3"));
+	IGXI_CHECK(parseError("sky.png", noMips) == Helper::INVALID_FILE_NAME_MIP);
+
+	IGXI_CHECK(parses("tiles-12.png", array, "tiles", 0, 0, 0, 12));
+	IGXI_CHECK(parses("tiles.2.5.png", arrayMips, "tiles", 0, 0, 2, 5));
+	IGXI_CHECK(parseError("tiles5.png", arrayMips) == Helper::INVALID_FILE_NAME_MIP);
+	IGXI_CHECK(parseError("tiles.png", array) == Helper::INVALID_FILE_NAME_SLICE);
+
+	IGXI_CHECK(parses("vol_17.png", volume, "vol", 0, 17));
+
+	//Faces are case-insensitive, can be followed by a separator and numbers, and have two names
+
+	IGXI_CHECK(parses("env_right.png", cube, "env", 0));
+	IGXI_CHECK(parses("ENV_Front.hdr", cube, "ENV", 5));
+	IGXI_CHECK(parses("env-x.png", cube, "env", 1));
+	IGXI_CHECK(parses("env_front4.png", cubeMips, "env", 5, 0, 4));
+	IGXI_CHECK(parses("env_front_4.png", cubeMips, "env", 5, 0, 4));
+	IGXI_CHECK(parses("env_top0-1.png", cubeArray, "env", 2, 0, 0, 1));
+	IGXI_CHECK(parseError("env.png", cube) == Helper::INVALID_FILE_NAME_FACE);
+
+	//Whole cubes and frames don't have a face or slice in their name
+
+	IGXI_CHECK(parses("env.hdr", F(cube | Helper::CUBE_FROM_IMAGE), "env"));
+	IGXI_CHECK(parses("anim.gif", F(array | Helper::FRAMES_FROM_IMAGE), "anim"));
+
+	//Out of range and too long numbers
+
+	IGXI_CHECK(parses("sky_254.png", noMips, "sky", 0, 0, 254));
+	IGXI_CHECK(parseError("sky_255.png", noMips) == Helper::INVALID_FILE_NAME_MIP);
+	IGXI_CHECK(parses("tiles_65534.png", array, "tiles", 0, 0, 0, 65534));
+	IGXI_CHECK(parseError("tiles_65535.png", array) == Helper::INVALID_FILE_NAME_SLICE);
+	IGXI_CHECK(parseError("tiles_000001.png", array) == Helper::INVALID_FILE_NAME_SLICE);
+
+	//Extensions
+
+	IGXI_CHECK(isSupportedExtension(".PNG") && isSupportedExtension(".hdr") && !isSupportedExtension(".txt"));
+	IGXI_CHECK(isContainerExtension(".DDS") && isContainerExtension(".ktx2") && !isContainerExtension(".png"));
+
+	//Index; files are found by base name (case-insensitive), other textures and unsupported files are skipped
+
+	String directory = test::getDirectory("file-index");
+
+	for (const char *name : { "sky_0.png", "sky_1.png", "Sky_2.PNG", "sky_normal_0.png", "sky_0.txt", "env.dds" })
+		IGXI_CHECK(test::writeFile(directory + "/" + name, Buffer(1)));
+
+	FileIndex index(directory);
+
+	IGXI_CHECK(index.size() == 5);
+
+	List<String> paths;
+
+	IGXI_CHECK(index.find("sky", noMips, paths) == Helper::SUCCESS);
+	IGXI_CHECK(paths.size() == 3);
+
+	for (const String &path : paths) {
+		String name = std::filesystem::path(path).filename().string();
+		IGXI_CHECK(name == "sky_0.png" || name == "sky_1.png" || name == "Sky_2.PNG");
+	}
+
+	IGXI_CHECK(index.find("sky_normal", noMips, paths) == Helper::SUCCESS && paths.size() == 1);
+	IGXI_CHECK(index.find("env", cube, paths) == Helper::SUCCESS && paths.size() == 1);
+	IGXI_CHECK(index.find("missing", noMips, paths) == Helper::MISSING_PATHS);
+
+	//A directory that doesn't exist is an empty index
+
+	IGXI_CHECK(FileIndex(directory + "/missing").size() == 0);
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+
+	return test::result();
+}
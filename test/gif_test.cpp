@@ -0,0 +1,214 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+//Animated gifs with FRAMES_FROM_IMAGE; every frame has to end up in its own layer (IS_ARRAY) or z (IS_3D)
+//	and the frames are counted and checked by the probe, before anything is decoded
+
+static constexpr u8 palette[4][3] = { { 255, 0, 0 }, { 0, 255, 0 }, { 0, 0, 255 }, { 255, 255, 255 } };
+
+//The palette index of a pixel of a frame; every frame (and every file, by seed) is different
+
+static u8 getIndex(usz x, usz y, usz frame, usz seed) {
+	return u8((x * (seed + 1) + y * 3 + frame) % 4);
+}
+
+//An uncompressed gif; every code is preceded by a clear code, so the LZW table never grows
+//	and every code is 3 bits (a 2-bit palette)
+
+static Buffer makeGif(u16 width, u16 height, u16 frames, usz seed) {
+
+	Buffer gif = {
+		'G', 'I', 'F', '8', '9', 'a',
+		u8(width), u8(width >> 8), u8(height), u8(height >> 8),
+		0x81, 0, 0
+	};
+
+	for (auto &color : palette)
+		gif.insert(gif.end(), color, color + 3);
+
+	for (u16 frame = 0; frame < frames; ++frame) {
+
+		//Image descriptor of the whole canvas, without a local color table
+
+		const u8 descriptor[] = { 0x2C, 0, 0, 0, 0, u8(width), u8(width >> 8), u8(height), u8(height >> 8), 0, 2 };
+		gif.insert(gif.end(), descriptor, descriptor + sizeof(descriptor));
+
+		Buffer codes;
+		u32 bits{}, count{};
+
+		auto write = [&](u32 code) {
+
+			bits |= code << count;
+
+			for (count += 3; count >= 8; count -= 8, bits >>= 8)
+				codes.push_back(u8(bits));
+		};
+
+		for (usz y = 0; y < height; ++y)
+			for (usz x = 0; x < width; ++x) {
+				write(4);
+				write(getIndex(x, y, frame, seed));
+			}
+
+		write(5);
+
+		if (count)
+			codes.push_back(u8(bits));
+
+		//Sub-blocks of at most 255 bytes, then the terminator
+
+		for (usz i = 0; i < codes.size(); i += 255) {
+			usz block = std::min(codes.size() - i, usz(255));
+			gif.push_back(u8(block));
+			gif.insert(gif.end(), codes.begin() + i, codes.begin() + i + block);
+		}
+
+		gif.push_back(0);
+	}
+
+	gif.push_back(0x3B);
+	return gif;
+}
+
+static String writeGif(const String &dir, const String &name, u16 width, u16 height, u16 frames, usz seed) {
+	String path = dir + "/" + name + ".gif";
+	IGXI_CHECK(test::writeFile(path, makeGif(width, height, frames, seed)));
+	return path;
+}
+
+//The RGBA8 texels of a frame of a gif, as they should be decoded
+
+static bool isFrame(const u8 *texels, u16 width, u16 height, usz frame, usz seed) {
+
+	for (usz y = 0; y < height; ++y)
+		for (usz x = 0; x < width; ++x) {
+
+			const u8 *texel = texels + (y * width + x) * 4;
+			const u8 *color = palette[getIndex(x, y, frame, seed)];
+
+			if (texel[0] != color[0] || texel[1] != color[1] || texel[2] != color[2] || texel[3] != 255)
+				return false;
+		}
+
+	return true;
+}
+
+int main() {
+
+	String dir = test::getDirectory("gif");
+
+	const GPUFormat rgba8 = GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4)));
+
+	const Helper::Flags array = Helper::Flags(Helper::IS_ARRAY | Helper::FRAMES_FROM_IMAGE);
+	const Helper::Flags volume = Helper::Flags(Helper::IS_3D | Helper::FRAMES_FROM_IMAGE);
+
+	constexpr u16 width = 13, height = 7;
+
+	String a = writeGif(dir, "a", width, height, 3, 0);
+	String b = writeGif(dir, "b", width, height, 3, 1);
+
+	//The probe counts the frames without decoding them; without FRAMES_FROM_IMAGE a gif is a single image
+
+	{
+		List<Helper::ImageInfo> infos;
+
+		IGXI_CHECK(Helper::probe({ Helper::FileDesc{ a, {} } }, infos, array, 1) == Helper::SUCCESS);
+		IGXI_CHECK(infos.size() == 1 && infos[0].frames == 3);
+		IGXI_CHECK(infos[0].width == width && infos[0].height == height && infos[0].format == rgba8);
+
+		IGXI_CHECK(Helper::probe({ Helper::FileDesc{ a, {} } }, infos, Helper::IS_ARRAY, 1) == Helper::SUCCESS);
+		IGXI_CHECK(infos.size() == 1 && infos[0].frames == 1);
+
+		//A single frame (without trailer, like some encoders write them) and a truncated gif
+
+		Buffer gif = makeGif(width, height, 1, 0);
+		gif.pop_back();
+
+		IGXI_CHECK(test::writeFile(dir + "/single.gif", gif));
+		IGXI_CHECK(Helper::probe({ { dir + "/single.gif", {} } }, infos, array, 1) == Helper::SUCCESS);
+		IGXI_CHECK(infos.size() == 1 && infos[0].frames == 1);
+
+		gif = makeGif(width, height, 3, 0);
+		gif.resize(gif.size() / 2);
+
+		IGXI_CHECK(test::writeFile(dir + "/truncated.gif", gif));
+		IGXI_CHECK(Helper::probe({ { dir + "/truncated.gif", {} } }, infos, array, 1) == Helper::INVALID_FILE_DATA);
+	}
+
+	//Two files of 3 frames in an array; the frames of a file are consecutive layers
+
+	for (u32 threads : { 1u, 2u }) {
+
+		IGXI out;
+		IGXI_CHECK(
+			Helper::convert(out, { { a, { 0, 0, 0 } }, { b, { 0, 1, 0 } } }, array, 1, threads) == Helper::SUCCESS
+		);
+
+		IGXI_CHECK(out.header.width == width && out.header.height == height);
+		IGXI_CHECK(out.header.length == 1 && out.header.layers == 6 && out.header.mips == 1);
+		IGXI_CHECK(out.format == List<GPUFormat>{ rgba8 });
+
+		usz layerSize = usz(width) * height * 4;
+
+		if (out.data.size() == 1 && out.data[0].size() == 1 && out.data[0][0].size() == layerSize * 6)
+			for (usz layer = 0; layer < 6; ++layer)
+				IGXI_CHECK(isFrame(out.data[0][0].data() + layer * layerSize, width, height, layer % 3, layer / 3));
+
+		else IGXI_CHECK(!"The array has the wrong size");
+	}
+
+	//A 3D texture; every frame is a slice
+
+	{
+		IGXI out;
+		IGXI_CHECK(Helper::convert(out, { Helper::FileDesc{ a, {} } }, volume, 1, 1) == Helper::SUCCESS);
+
+		IGXI_CHECK(out.header.width == width && out.header.height == height);
+		IGXI_CHECK(out.header.length == 3 && out.header.layers == 1);
+
+		usz sliceSize = usz(width) * height * 4;
+
+		if (out.data.size() == 1 && out.data[0].size() == 1 && out.data[0][0].size() == sliceSize * 3)
+			for (usz z = 0; z < 3; ++z)
+				IGXI_CHECK(isFrame(out.data[0][0].data() + z * sliceSize, width, height, z, 0));
+
+		else IGXI_CHECK(!"The volume has the wrong size");
+	}
+
+	//Files that don't fit are found by the probe: a different canvas or frame count
+
+	{
+		String small = writeGif(dir, "small", width - 1, height, 3, 0);
+		String shorter = writeGif(dir, "shorter", width, height, 2, 0);
+
+		IGXI out;
+
+		IGXI_CHECK(
+			Helper::convert(out, { { a, { 0, 0, 0 } }, { small, { 0, 1, 0 } } }, array, 1, 1) ==
+			Helper::CONFLICTING_IMAGE_SIZE
+		);
+
+		IGXI_CHECK(
+			Helper::convert(out, { { a, { 0, 0, 0 } }, { shorter, { 0, 1, 0 } } }, array, 1, 1) ==
+			Helper::CONFLICTING_IMAGE_SIZE
+		);
+	}
+
+	//Frames need an array or volume to go to, and can't be cube faces
+
+	{
+		IGXI out;
+		const List<Helper::FileDesc> files = { { a, {} } };
+
+		IGXI_CHECK(Helper::convert(out, files, Helper::FRAMES_FROM_IMAGE, 1, 1) == Helper::INVALID_TYPE);
+		IGXI_CHECK(Helper::convert(out, files, Helper::Flags(array | Helper::IS_CUBE), 1, 1) == Helper::INVALID_TYPE);
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(dir, error);
+
+	return test::result();
+}
@@ -0,0 +1,88 @@
+#include "allocations.hpp"
+#include "igxi/convert.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+//Peak memory and time of loading a texture out of an IGXI that isn't needed anymore (like loadDiskExternal)
+//The IGXI has a 2048x2048x2 rgba8 array with mips (about 43 MB) and a BC7 version of it (a quarter of that),
+//	as KEEP_UNCOMPRESSED makes it; BC7 is the format that is loaded
+//
+//"kept" is convert(const IGXI&, ...): Texture::Info::init copies the mips while the whole IGXI is alive
+//"handed over" is what convert(IGXI&&, ...) does after picking the format:
+//	the other formats are freed before init copies the mips and the mips are freed right after
+//Both decode the IGXI in the measured function, so the peak includes it
+
+static constexpr u16 size = 2048, layers = 2;
+
+static IGXI makeIGXI() {
+
+	IGXI igxi;
+	igxi.data.resize(2);
+
+	for (u16 mip = size; ; mip /= 2) {
+
+		usz blocks = usz(mip + 3) / 4;
+
+		igxi.data[0].push_back(Buffer(usz(mip) * mip * layers * 4, u8(mip)));
+		igxi.data[1].push_back(Buffer(blocks * blocks * 16 * layers, u8(mip)));
+
+		if (mip == 1)
+			break;
+	}
+
+	return igxi;
+}
+
+static Texture::Info makeInfo(const IGXI &igxi) {
+	return Texture::Info(
+		TextureType(u8(TextureType::TEXTURE_2D) | u8(TextureType::PROPERTY_IS_ARRAY)),
+		Vec3u16(size, size, 1), GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4))), GPUMemoryUsage{},
+		u8(igxi.data[1].size()), layers, 1, true
+	);
+}
+
+template<typename Load>
+static void measure(const char *name, const Load &load) {
+
+	test::Timer timer;
+
+	test::AllocationStats stats = test::measureAllocations([&]() {
+		IGXI igxi = makeIGXI();
+		Texture::Info info = makeInfo(igxi);
+		load(igxi, info);
+	});
+
+	f64 time = timer.elapsed();
+
+	std::printf("%s\t%.1f\t\t%zu\t\t%.3f\n", name, f64(stats.peak) / 1e6, stats.count, time * 1e3);
+}
+
+int main() {
+
+	usz bytes[2]{};
+	IGXI igxi = makeIGXI();
+
+	for (usz i = 0; i < 2; ++i)
+		for (const Buffer &mip : igxi.data[i])
+			bytes[i] += mip.size();
+
+	igxi = {};
+
+	std::printf("load\t\tMB peak\t\tallocations\tms\n");
+
+	measure("kept\t", [](IGXI &in, Texture::Info &info) {
+		info.init(in.data[1]);
+	});
+
+	measure("handed over", [](IGXI &in, Texture::Info &info) {
+
+		List<Buffer> mips = std::move(in.data[1]);
+		List<List<Buffer>>().swap(in.data);
+
+		info.init(mips);
+	});
+
+	std::printf("rgba8\t\t%.1f\nbc7\t\t%.1f\n", f64(bytes[0]) / 1e6, f64(bytes[1]) / 1e6);
+	return 0;
+}
@@ -0,0 +1,264 @@
+#include "test.hpp"
+#include "igxi/kernels.hpp"
+#include <cstring>
+#include <random>
+#include <cmath>
+
+using namespace igxi;
+using namespace ignis;
+
+//The per-value conversion that convert() did before the kernels; every kernel has to give the same bytes
+
+static u64 readValue(usz stride, const u8 *data) {
+	switch (stride) {
+		case 1:		return *data;
+		case 2:		return *(const u16*)data;
+		case 4:		return *(const u32*)data;
+		default:	return *(const u64*)data;
+	}
+}
+
+static void writeValue(usz stride, u8 *data, u64 val) {
+	switch (stride) {
+		case 1:		*data = u8(val);			break;
+		case 2:		*(u16*)data = u16(val);		break;
+		case 4:		*(u32*)data = u32(val);		break;
+		default:	*(u64*)data = u64(val);		break;
+	}
+}
+
+template<typename T>
+static u64 toU64(const T &t) {
+	u64 v{};
+	std::memcpy(&v, (const void*) &t, sizeof(t));
+	return v;
+}
+
+template<typename T>
+static T fromU64(u64 v) {
+	T t;
+	std::memcpy((void*) &t, &v, sizeof(t));
+	return t;
+}
+
+static u64 convertValue(usz outStride, usz inStride, u64 val) {
+
+	if (outStride == inStride)
+		return val;
+
+	switch (outStride) {
+
+		case 2: {
+
+			f16 v = inStride == 4 ? f16(fromU64<f32>(val)) : f16(fromU64<f64>(val));
+
+			if (v.lacksPrecision())
+				v = f16::max();
+
+			return toU64(v);
+		}
+
+		case 4: {
+
+			if (inStride == 2)
+				return toU64(f32(fromU64<f16>(val)));
+
+			f32 v = f32(fromU64<f64>(val));
+
+			if (fromU64<flp32>(toU64(v)).lacksPrecision())
+				v = f32_MAX;
+
+			return toU64(v);
+		}
+
+		default:
+			return inStride == 2 ? toU64(f64(fromU64<f16>(val))) : toU64(f64(fromU64<f32>(val)));
+	}
+}
+
+static Buffer reference(usz outStride, usz inStride, usz outC, usz inC, const Buffer &src, usz pixels) {
+
+	Buffer dst(outStride * outC * pixels);
+	usz copyC = std::min(outC, inC);
+
+	for (usz i = 0; i < pixels * copyC; ++i) {
+
+		usz channel = i % copyC, xy = i / copyC;
+
+		u64 val = convertValue(outStride, inStride, readValue(inStride, src.data() + inStride * (channel + xy * inC)));
+		writeValue(outStride, dst.data() + outStride * (channel + xy * outC), val);
+	}
+
+	return dst;
+}
+
+static Buffer run(ConversionKernel kernel, usz outStride, usz outC, const Buffer &src, usz pixels) {
+
+	//One pixel more than needed, to check that the kernel doesn't write past the end
+
+	Buffer dst(outStride * outC * (pixels + 1), 0xCD);
+	kernel(src.data(), dst.data(), pixels);
+
+	bool untouched = true;
+
+	for (usz i = outStride * outC * pixels; i < dst.size(); ++i)
+		untouched &= dst[i] == 0xCD;
+
+	IGXI_CHECK(untouched);
+
+	dst.resize(outStride * outC * pixels);
+	return dst;
+}
+
+static GPUFormat getFormat(usz bytes, bool isFloat) {
+	return GPUFormat(u16(((bytes - 1) << 2) | (u8(isFloat ? GPUFormatType::FLOAT : GPUFormatType::UINT) << 4)));
+}
+
+//Random bits, with special floats (zeros, subnormals, inf, NaN, f16 limits) mixed in
+
+static Buffer getInput(usz stride, usz count, std::mt19937_64 &random) {
+
+	Buffer src(stride * count);
+
+	for (usz i = 0; i < count; ++i) {
+
+		u64 v = random();
+
+		if (stride == 4)
+			switch (v % 8) {
+				case 0:		v = toU64(f32(i32(v >> 40) % 70000) * 1.001f);			break;
+				case 1:		v = (v >> 32) & 0x807FFFFF;									break;
+				case 2:		v = toU64(((v >> 32) & 1 ? -1.f : 1.f) * 65520.f);			break;
+				case 3:		v = (v >> 32) & 1 ? 0x7F800000 : 0xFFC00001;				break;
+				case 4:		v = (v >> 32) & 0x8FFFFFFF;									break;
+			}
+
+		else if (stride == 8 && v % 4 == 0)
+			v = toU64(f64(i64(v >> 20) % 1000000) / 7);
+
+		std::memcpy(src.data() + stride * i, &v, stride);
+	}
+
+	return src;
+}
+
+template<typename Out, typename In>
+static void checkPair(std::mt19937_64 &random) {
+
+	for (usz outC = 1; outC <= 4; ++outC)
+		for (usz inC = 1; inC <= 4; ++inC)
+			for (usz pixels : { 0, 1, 2, 3, 5, 7, 8, 9, 16, 17, 33, 1000 }) {
+				Buffer src = getInput(sizeof(In), pixels * inC, random);
+				Buffer out = run(getKernel<Out, In>(outC, inC), sizeof(Out), outC, src, pixels);
+				IGXI_CHECK(out == reference(sizeof(Out), sizeof(In), outC, inC, src, pixels));
+			}
+}
+
+int main() {
+
+	std::mt19937_64 random(2);
+
+	//Every channel combination of every type pair, with all remainder sizes of the vector loops
+
+	checkPair<u8, u8>(random);
+	checkPair<u16, u16>(random);
+	checkPair<u32, u32>(random);
+	checkPair<u64, u64>(random);
+	checkPair<f16, f32>(random);
+	checkPair<f16, f64>(random);
+	checkPair<f32, f16>(random);
+	checkPair<f32, f64>(random);
+	checkPair<f64, f16>(random);
+	checkPair<f64, f32>(random);
+
+	//Formats pick the kernel of their types
+
+	IGXI_CHECK(getConversionKernel(getFormat(2, true), getFormat(4, true), 4, 4) == getKernel<f16, f32>(4, 4));
+	IGXI_CHECK(getConversionKernel(getFormat(4, true), getFormat(2, true), 3, 3) == getKernel<f32, f16>(3, 3));
+	IGXI_CHECK(getConversionKernel(getFormat(1, false), getFormat(1, false), 4, 3) == getKernel<u8, u8>(4, 3));
+
+	//Different types or int strides can't be converted
+
+	IGXI_CHECK(!getConversionKernel(getFormat(2, false), getFormat(4, false), 4, 4));
+	IGXI_CHECK(!getConversionKernel(getFormat(2, true), getFormat(4, false), 4, 4));
+	IGXI_CHECK(!getConversionKernel(getFormat(4, true), getFormat(4, true), 5, 4));
+
+	//Every vectorized kernel that this CPU can run (not just the one that is picked), next to the generic one
+
+	const CpuFeatures &cpu = getCpuFeatures();
+	std::printf("ssse3: %i, avx: %i, f16c: %i\n", cpu.ssse3, cpu.avx, cpu.f16c);
+
+	#ifdef IGXI_SSE2
+
+		for (usz pixels : { 0, 1, 4, 5, 6, 11, 12, 13, 255 }) {
+
+			if (cpu.ssse3) {
+
+				Buffer src8 = getInput(1, pixels * 3, random), src16 = getInput(2, pixels * 3, random);
+
+				IGXI_CHECK(run(&expandRgbToRgba<u8>, 1, 4, src8, pixels) == reference(1, 1, 4, 3, src8, pixels));
+				IGXI_CHECK(run(&expandRgbToRgba<u16>, 2, 4, src16, pixels) == reference(2, 2, 4, 3, src16, pixels));
+			}
+
+			Buffer src = getInput(4, pixels * 3, random);
+
+			IGXI_CHECK(run(&f32ToF64Pixels<3>, 8, 3, src, pixels) == reference(8, 4, 3, 3, src, pixels));
+			IGXI_CHECK(run(&f32ToF16Pixels<3>, 2, 3, src, pixels) == reference(2, 4, 3, 3, src, pixels));
+
+			if (cpu.avx)
+				IGXI_CHECK(run(&f32ToF64PixelsAvx<3>, 8, 3, src, pixels) == reference(8, 4, 3, 3, src, pixels));
+
+			if (cpu.f16c) {
+				Buffer half = getInput(2, pixels * 3, random);
+				IGXI_CHECK(run(&f16ToF32Pixels<3>, 4, 3, half, pixels) == reference(4, 2, 3, 3, half, pixels));
+			}
+		}
+
+		//All 65536 halves to f32, against f32(f16)
+
+		if (cpu.f16c) {
+
+			Buffer halves(65536 * 2);
+
+			for (usz i = 0; i < 65536; ++i)
+				writeValue(2, halves.data() + i * 2, i);
+
+			IGXI_CHECK(run(&f16ToF32Pixels<1>, 4, 1, halves, 65536) == reference(4, 2, 1, 1, halves, 65536));
+		}
+
+		//f32 to f16 around every half: the half itself, the halfway points to its neighbours (ties) and one ulp around those
+		//And a sweep over every 251st bit pattern, which covers every exponent (NaN, inf and subnormals included)
+
+		{
+			List<u32> values;
+
+			for (u32 h = 0; h < 65536; ++h) {
+
+				u32 bits = u32(toU64(f32(fromU64<f16>(h))));
+
+				if (((h >> 10) & 31) == 31)
+					continue;
+
+				//Subnormal halves are closer together than 0x1000 ulp
+
+				u32 tie = ((h >> 10) & 31) ? bits + 0x1000 : u32(toU64(std::ldexp(f32(h & 0x3FF) + .5f, -24))) | (bits & 0x80000000);
+
+				for (i32 d : { -1, 0, 1 }) {
+					values.push_back(bits + u32(d));
+					values.push_back(tie + u32(d));
+				}
+			}
+
+			for (u64 bits = 0; bits < (u64(1) << 32); bits += 251)
+				values.push_back(u32(bits));
+
+			Buffer src(values.size() * 4);
+			std::memcpy(src.data(), values.data(), src.size());
+
+			IGXI_CHECK(run(&f32ToF16Pixels<1>, 2, 1, src, values.size()) == reference(2, 4, 1, 1, src, values.size()));
+		}
+
+	#endif
+
+	return test::result();
+}
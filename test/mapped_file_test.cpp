@@ -0,0 +1,90 @@
+#include "test.hpp"
+#include "igxi/mapped_file.hpp"
+#include "igxi/convert.hpp"
+#include "igxi/png.hpp"
+
+using namespace igxi;
+
+static Buffer readFile(const String &path) {
+	std::ifstream in(path, std::ios::binary);
+	return Buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+static Buffer makeBytes(usz size, u32 seed) {
+
+	Buffer bytes(size);
+
+	for (u8 &b : bytes) {
+		seed = seed * 1664525 + 1013904223;
+		b = u8(seed >> 24);
+	}
+
+	return bytes;
+}
+
+int main() {
+
+	String dir = test::getDirectory("mapped_file");
+
+	//A mapped file has the same bytes as reading it; around the page size and bigger than a page
+
+	for (usz size : { usz(1), usz(4095), usz(4096), usz(4097), usz(1) << 20 }) {
+
+		String path = dir + "/file" + std::to_string(size);
+		IGXI_CHECK(test::writeFile(path, makeBytes(size, u32(size))));
+
+		Buffer contents = readFile(path);
+		MappedFile file(path);
+
+		IGXI_CHECK(file.data() && file.isMapped());
+		IGXI_CHECK(file.size() == contents.size() && !std::memcmp(file.data(), contents.data(), contents.size()));
+	}
+
+	//An empty file can't be mapped, but it can be opened; so it's read and has a (non-null) empty view
+
+	{
+		String path = dir + "/empty";
+		IGXI_CHECK(test::writeFile(path, Buffer{}));
+
+		MappedFile file(path);
+		IGXI_CHECK(file.data() && !file.size() && !file.isMapped());
+	}
+
+	//A missing file can't be opened at all
+
+	{
+		MappedFile file(dir + "/missing");
+		IGXI_CHECK(!file.data() && !file.size() && !file.isMapped());
+	}
+
+	//A mapped image decodes to the image
+
+	{
+		Buffer image = makeBytes(19 * 11 * 4, 3);
+		Buffer png = encodePNG(image.data(), 19 * 4, 19, 11, 4, 1, 1);
+
+		String path = dir + "/image.png";
+		IGXI_CHECK(test::writeFile(path, png));
+
+		IGXI out;
+		IGXI_CHECK(Helper::convert(out, { Helper::FileDesc{ path, {} } }, Helper::IS_2D, 1, 1) == Helper::SUCCESS);
+		IGXI_CHECK(out.data.size() == 1 && out.data[0].size() == 1 && out.data[0][0] == image);
+	}
+
+	//Empty and missing images are errors
+
+	{
+		auto convert = [](const String &path) {
+			IGXI out;
+			return Helper::convert(out, { Helper::FileDesc{ path, {} } }, Helper::IS_2D, 1, 1);
+		};
+
+		IGXI_CHECK(convert(dir + "/empty") == Helper::INVALID_FILE_BOUNDS);
+		IGXI_CHECK(convert(dir + "/missing.png") == Helper::INVALID_FILE_PATH);
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(dir, error);
+
+	return test::result();
+}
@@ -0,0 +1,451 @@
+#include "test.hpp"
+#include "igxi/mips.hpp"
+#include "igxi/srgb.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+static const GPUFormat r8 = GPUFormat(u16(u8(GPUFormatType::UNORM) << 4));
+static const GPUFormat rg16 = GPUFormat(u16(1 | (1 << 2) | (u8(GPUFormatType::UNORM) << 4)));
+static const GPUFormat rgba8 = GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4)));
+static const GPUFormat rgba32f = GPUFormat(u16(3 | (3 << 2) | (u8(GPUFormatType::FLOAT) << 4)));
+
+enum class Filter : u8 { LINEAR, NEAREST, MIN, MAX, PREMULTIPLY };
+
+static constexpr Helper::Flags filterFlags[] = {
+	Helper::MIP_LINEAR, Helper::MIP_NEAREST, Helper::MIP_MIN, Helper::MIP_MAX, Helper::MIP_PREMULTIPLY
+};
+
+//A plain scalar box filter, to check the (vectorized) row kernels against
+//Floats are summed pairwise and sRGB in order, like the library, so the results have to be the same bits
+
+template<typename T>
+static T average(const T *s, usz n) {
+
+	if constexpr (std::is_floating_point_v<T>) {
+
+		T sum[8];
+		std::copy(s, s + n, sum);
+
+		for (usz step = 1; step < n; step *= 2)
+			for (usz i = 0; i + step < n; i += step * 2)
+				sum[i] += sum[i + step];
+
+		return sum[0] * (T(1) / n);
+	}
+
+	else {
+
+		u64 sum{};
+
+		for (usz i = 0; i < n; ++i)
+			sum += s[i];
+
+		return T((sum + n / 2) / n);
+	}
+}
+
+static u8 averageSrgb(const u8 *s, usz n) {
+
+	const SrgbTables &tables = getSrgbTables();
+
+	f32 sum{};
+
+	for (usz i = 0; i < n; ++i)
+		sum += tables.toLinear[s[i]];
+
+	return tables.toSrgb(sum * (1.f / n));
+}
+
+//Color weighted by alpha, or the plain average if all samples are transparent
+
+template<typename T>
+static void averagePremultiplied(const T (*s)[4], usz n, bool srgb, T *out) {
+
+	using F = std::conditional_t<sizeof(T) <= 2, f32, f64>;
+
+	const SrgbTables &tables = getSrgbTables();
+
+	F weight{};
+
+	for (usz i = 0; i < n; ++i)
+		weight += std::max(F(s[i][3]), F(0));
+
+	for (usz c = 0; c < 3; ++c) {
+
+		F sum{}, plain{};
+
+		for (usz i = 0; i < n; ++i) {
+
+			F v = srgb ? F(tables.toLinear[usz(s[i][c])]) : F(s[i][c]);
+
+			sum += v * std::max(F(s[i][3]), F(0));
+			plain += v;
+		}
+
+		F v = weight > 0 ? sum / weight : plain * (F(1) / n);
+
+		if (srgb)
+			out[c] = T(tables.toSrgb(f32(v)));
+
+		else if constexpr (std::is_floating_point_v<T>)
+			out[c] = T(v);
+
+		else out[c] = T(std::clamp(std::floor(v + F(.5)), F(0), F(std::numeric_limits<T>::max())));
+	}
+
+	T alpha[8];
+
+	for (usz i = 0; i < n; ++i)
+		alpha[i] = s[i][3];
+
+	out[3] = average(alpha, n);
+}
+
+template<typename T>
+static void reducePixel(Filter filter, bool srgb, usz C, const T (*s)[4], usz n, T *out) {
+
+	if (filter == Filter::PREMULTIPLY && C == 4)
+		return averagePremultiplied(s, n, srgb, out);
+
+	for (usz c = 0; c < C; ++c) {
+
+		T v[8];
+
+		for (usz i = 0; i < n; ++i)
+			v[i] = s[i][c];
+
+		switch (filter) {
+
+			case Filter::NEAREST:	out[c] = v[0];								break;
+			case Filter::MIN:		out[c] = *std::min_element(v, v + n);		break;
+			case Filter::MAX:		out[c] = *std::max_element(v, v + n);		break;
+
+			default:
+
+				if constexpr (std::is_same_v<T, u8>)
+					if (srgb && c != 3) {
+						out[c] = averageSrgb(v, n);
+						break;
+					}
+
+				out[c] = average(v, n);
+		}
+	}
+}
+
+//Every mip from the previous reference mip; odd sizes reuse the last row, column or slice
+
+template<typename T>
+static List<List<T>> reference(
+	const List<T> &base, u16 width, u16 height, u16 length, u16 layers, usz C, Filter filter, bool srgb
+) {
+
+	bool is3D = length > 1;
+	u16 mips = getMipCount(width, height, length);
+
+	List<List<T>> res{ base };
+	Array<usz, 3> src{ width, height, length };
+
+	for (u16 mip = 1; mip < mips; ++mip) {
+
+		Array<usz, 3> dst{ (src[0] + 1) / 2, (src[1] + 1) / 2, (src[2] + 1) / 2 };
+
+		const List<T> &prev = res.back();
+		List<T> next(dst[0] * dst[1] * dst[2] * layers * C);
+
+		for (usz layer = 0; layer < layers; ++layer)
+			for (usz z = 0; z < dst[2]; ++z)
+				for (usz y = 0; y < dst[1]; ++y)
+					for (usz x = 0; x < dst[0]; ++x) {
+
+						//Same order as the rows of the library: (z0, y0), (z0, y1), (z1, y0), (z1, y1), x0 then x1
+
+						T s[8][4]{};
+						usz n{};
+
+						for (usz dz = 0; dz < (is3D ? 2 : 1); ++dz)
+							for (usz dy = 0; dy < 2; ++dy)
+								for (usz dx = 0; dx < 2; ++dx) {
+
+									usz sx = std::min(x * 2 + dx, src[0] - 1);
+									usz sy = std::min(y * 2 + dy, src[1] - 1);
+									usz sz = std::min(z * 2 + dz, src[2] - 1);
+
+									const T *p = prev.data() + (((layer * src[2] + sz) * src[1] + sy) * src[0] + sx) * C;
+									std::copy(p, p + C, s[n++]);
+								}
+
+						T *out = next.data() + (((layer * dst[2] + z) * dst[1] + y) * dst[0] + x) * C;
+						reducePixel(filter, srgb, C, s, n, out);
+					}
+
+		res.push_back(std::move(next));
+		src = dst;
+	}
+
+	return res;
+}
+
+//Generate the mips of random texels with the library and compare every mip against the reference
+
+template<typename T>
+static void check(GPUFormat format, usz C, u16 width, u16 height, u16 length, u16 layers, Filter filter, u32 seed) {
+
+	bool srgb = format == GPUFormat::srgba8;
+	u16 mips = getMipCount(width, height, length);
+
+	List<T> base(usz(width) * height * length * layers * C);
+
+	for (usz i = 0; i < base.size(); ++i) {
+
+		seed = seed * 1664525 + 1013904223;
+
+		if constexpr (std::is_floating_point_v<T>)
+			base[i] = T(seed >> 8) / T(1 << 20);
+
+		//Mostly fully transparent or opaque alpha, like a cutout
+
+		else if (C == 4 && i % 4 == 3 && seed >> 30)
+			base[i] = seed >> 29 & 1 ? std::numeric_limits<T>::max() : T(0);
+
+		else base[i] = T(seed >> 16);
+	}
+
+	List<List<T>> expected = reference(base, width, height, length, layers, C, filter, srgb);
+
+	IGXI out;
+	out.header.width = width;
+	out.header.height = height;
+	out.header.length = length;
+	out.header.layers = layers;
+	out.header.formats = 1;
+	out.header.mips = u8(mips);
+	out.header.type = length > 1 ? TextureType::TEXTURE_3D : TextureType::TEXTURE_2D;
+	out.format = { format };
+	out.data = { List<Buffer>(mips) };
+
+	for (u16 mip = 0; mip < mips; ++mip)
+		out.data[0][mip].resize(expected[mip].size() * sizeof(T));
+
+	std::memcpy(out.data[0][0].data(), base.data(), out.data[0][0].size());
+
+	IGXI_CHECK(generateMips(out, 0, filterFlags[u8(filter)], 1) == Helper::SUCCESS);
+
+	for (u16 mip = 1; mip < mips; ++mip) {
+
+		bool equal = !std::memcmp(out.data[0][mip].data(), expected[mip].data(), out.data[0][mip].size());
+
+		if (!equal)
+			std::fprintf(
+				stderr, "Mip %u of %ux%ux%u (%u layers, %zu channels) with filter %u is different\n",
+				u32(mip), u32(width), u32(height), u32(length), u32(layers), C, u32(filter)
+			);
+
+		IGXI_CHECK(equal);
+	}
+}
+
+//An IGXI with every mip of the texels (only mip 0 is filled in)
+
+template<typename T>
+static IGXI makeMipped(GPUFormat format, u16 width, u16 height, const List<T> &texels) {
+
+	u16 mips = getMipCount(width, height, 1);
+
+	IGXI out;
+	out.header.width = width;
+	out.header.height = height;
+	out.header.length = 1;
+	out.header.layers = 1;
+	out.header.formats = 1;
+	out.header.mips = u8(mips);
+	out.header.type = TextureType::TEXTURE_2D;
+	out.format = { format };
+	out.data = { List<Buffer>(mips) };
+
+	for (u16 mip = 0; mip < mips; ++mip) {
+		out.data[0][mip].resize(usz(width) * height * 4 * sizeof(T));
+		width = u16((width + 1) / 2);
+		height = u16((height + 1) / 2);
+	}
+
+	std::memcpy(out.data[0][0].data(), texels.data(), out.data[0][0].size());
+	return out;
+}
+
+//A cutout: opaque red on the left, transparent green on the right, with the edge in the middle of a 2x2 block
+//Weighted by alpha, the edge stays red (at half alpha) and no green bleeds into any visible texel of any mip;
+//	the transparent texels keep their own color. A plain average does bleed
+
+static void checkPremultipliedEdge(GPUFormat format) {
+
+	constexpr u16 width = 22, height = 8;
+
+	List<u8> texels(usz(width) * height * 4);
+
+	for (usz i = 0; i < usz(width) * height; ++i) {
+		bool opaque = i % width < 11;
+		u8 *texel = texels.data() + i * 4;
+		texel[0] = opaque ? 255 : 0;
+		texel[1] = opaque ? 0 : 255;
+		texel[2] = 0;
+		texel[3] = opaque ? 255 : 0;
+	}
+
+	for (bool premultiplied : { true, false }) {
+
+		IGXI out = makeMipped(format, width, height, texels);
+
+		Helper::Flags flags = premultiplied ? Helper::MIP_PREMULTIPLY : Helper::MIP_LINEAR;
+		IGXI_CHECK(generateMips(out, 0, flags, 1) == Helper::SUCCESS);
+
+		//Mip 1 is 11 wide; texel 5 is the edge (texels 10 and 11), 4 is opaque and 6 transparent
+
+		const u8 *row = out.data[0][1].data();
+
+		IGXI_CHECK(row[4 * 4 + 0] == 255 && row[4 * 4 + 1] == 0 && row[4 * 4 + 3] == 255);
+		IGXI_CHECK(row[6 * 4 + 0] == 0 && row[6 * 4 + 1] == 255 && row[6 * 4 + 3] == 0);
+		IGXI_CHECK(row[5 * 4 + 3] == 128);
+
+		if (!premultiplied) {
+			IGXI_CHECK(row[5 * 4 + 1] > 100);
+			continue;
+		}
+
+		IGXI_CHECK(row[5 * 4 + 0] == 255 && row[5 * 4 + 1] == 0);
+
+		for (const Buffer &mip : out.data[0])
+			for (usz i = 0; i < mip.size(); i += 4)
+				if (mip[i + 3])
+					IGXI_CHECK(mip[i] == 255 && mip[i + 1] == 0);
+	}
+}
+
+//Alpha test coverage (alpha >= .5) of a layer
+
+template<typename T>
+static f64 getCoverage(const Buffer &mip, f32 one) {
+
+	const T *texels = (const T*) mip.data();
+	usz count = mip.size() / sizeof(T) / 4, covered{};
+
+	for (usz i = 0; i < count; ++i)
+		covered += f32(texels[i * 4 + 3]) >= one / 2;
+
+	return f64(covered) / count;
+}
+
+//Foliage-like noise where alpha is a random u^2, so 29% of the texels pass and the average alpha is 1/3
+//	Averaging pulls alpha to 1/3, so without rescaling the coverage goes to 0
+//	With MIP_PRESERVE_COVERAGE every mip keeps about the coverage of mip 0
+
+template<typename T>
+static void checkCoverage(GPUFormat format, Helper::Flags filter) {
+
+	constexpr u16 size = 128;
+	const f32 one = std::is_floating_point_v<T> ? 1.f : f32(std::numeric_limits<T>::max());
+
+	List<T> texels(usz(size) * size * 4);
+	u32 seed = 7;
+
+	for (usz i = 0; i < texels.size(); ++i) {
+		seed = seed * 1664525 + 1013904223;
+		f32 u = f32(seed >> 8) / (1 << 24);
+		texels[i] = i % 4 == 3 ? T(u * u * one + (std::is_floating_point_v<T> ? 0 : .5f)) : T(seed >> 24);
+	}
+
+	IGXI kept = makeMipped(format, size, size, texels), plain = kept;
+
+	IGXI_CHECK(generateMips(kept, 0, Helper::Flags(filter | Helper::MIP_PRESERVE_COVERAGE), 1) == Helper::SUCCESS);
+	IGXI_CHECK(generateMips(plain, 0, filter, 1) == Helper::SUCCESS);
+
+	f64 base = getCoverage<T>(kept.data[0][0], one);
+	IGXI_CHECK(base > .27 && base < .31);
+
+	//A mip can be off by a texel, or two when 8-bit alpha makes texels share the alpha at the threshold
+
+	for (usz mip = 1; mip < kept.data[0].size(); ++mip) {
+
+		usz count = kept.data[0][mip].size() / sizeof(T) / 4;
+		f64 coverage = getCoverage<T>(kept.data[0][mip], one);
+
+		if (std::abs(coverage - base) > .02 + 2. / count)
+			std::fprintf(stderr, "Coverage of mip %zu is %f instead of %f\n", mip, coverage, base);
+
+		IGXI_CHECK(std::abs(coverage - base) <= .02 + 2. / count);
+	}
+
+	//Without it, the coverage is lost
+
+	IGXI_CHECK(getCoverage<T>(plain.data[0][4], one) < base / 2);
+}
+
+int main() {
+
+	//Alpha weighted mips and alpha test coverage
+
+	checkPremultipliedEdge(rgba8);
+	checkPremultipliedEdge(GPUFormat::srgba8);
+
+	checkCoverage<u8>(rgba8, Helper::MIP_LINEAR);
+	checkCoverage<u8>(GPUFormat::srgba8, Helper::MIP_LINEAR);
+	checkCoverage<u8>(rgba8, Helper::MIP_PREMULTIPLY);
+	checkCoverage<f32>(rgba32f, Helper::MIP_LINEAR);
+
+	//Encoding to sRGB has to give the last value whose threshold is reached; around every threshold and in between
+
+	{
+		const SrgbTables &tables = getSrgbTables();
+
+		auto expected = [&](f32 linear) {
+			u8 k{};
+
+			while (k < 255 && linear >= tables.threshold[k + 1])
+				++k;
+
+			return k;
+		};
+
+		List<f32> values{ -1, 0, 1, 2, std::numeric_limits<f32>::quiet_NaN() };
+
+		for (usz k = 1; k < 256; ++k) {
+			f32 threshold = tables.threshold[k];
+			values.insert(values.end(), { threshold, std::nextafter(threshold, 0.f), std::nextafter(threshold, 2.f) });
+		}
+
+		for (u32 i = 0; i <= 1 << 16; ++i)
+			values.push_back(i / f32(1 << 16));
+
+		for (f32 v : values)
+			if (tables.toSrgb(v) != expected(v)) {
+				std::fprintf(stderr, "%.9g is encoded as %u instead of %u\n", v, u32(tables.toSrgb(v)), u32(expected(v)));
+				IGXI_CHECK(false);
+			}
+	}
+
+	//Odd and even sizes, wide enough for the vector loops and their remainders, 2D arrays and 3D
+
+	struct Size { u16 width, height, length, layers; };
+
+	constexpr Size sizes[] = {
+		{ 37, 19, 1, 1 }, { 32, 16, 1, 2 }, { 1, 1, 1, 1 }, { 1, 9, 1, 1 },
+		{ 13, 7, 5, 1 }, { 32, 8, 4, 1 }, { 19, 2, 9, 1 }, { 1, 1, 3, 1 }
+	};
+
+	u32 seed = 1;
+
+	for (const Size &s : sizes)
+		for (u8 filter = 0; filter < 5; ++filter) {
+
+			Filter f = Filter(filter);
+
+			check<u8>(rgba8, 4, s.width, s.height, s.length, s.layers, f, ++seed);
+			check<u8>(GPUFormat::srgba8, 4, s.width, s.height, s.length, s.layers, f, ++seed);
+			check<u8>(r8, 1, s.width, s.height, s.length, s.layers, f, ++seed);
+			check<u16>(rg16, 2, s.width, s.height, s.length, s.layers, f, ++seed);
+			check<f32>(rgba32f, 4, s.width, s.height, s.length, s.layers, f, ++seed);
+		}
+
+	return test::result();
+}
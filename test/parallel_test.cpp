@@ -0,0 +1,172 @@
+#include "test.hpp"
+#include "igxi/parallel.hpp"
+#include <stdexcept>
+#include <string>
+
+using namespace igxi;
+
+//Counts how many calls are active at once, to check the thread limits
+
+struct Concurrency {
+
+	std::atomic<u32> active{}, peak{};
+
+	inline void enter() {
+
+		u32 now = ++active, last = peak.load();
+
+		while (now > last && !peak.compare_exchange_weak(last, now)) {}
+
+		//Give the other threads a chance to overlap
+
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+	}
+
+	inline void leave() { --active; }
+};
+
+int main() {
+
+	u32 poolSize = ThreadPool::get().size();
+
+	IGXI_CHECK(poolSize == std::max(std::thread::hardware_concurrency(), 1u));
+	IGXI_CHECK(getThreadCount(3, 10) == 3 && getThreadCount(8, 2) == 2 && getThreadCount(0, 1) == 1);
+
+	//Every index is run exactly once
+
+	for (u32 threads : { 0u, 1u, 3u }) {
+
+		List<std::atomic<u32>> calls(10000);
+
+		parallelFor(calls.size(), threads, [&](usz i) { ++calls[i]; });
+
+		bool once = true;
+
+		for (std::atomic<u32> &call : calls)
+			once &= call == 1;
+
+		IGXI_CHECK(once);
+	}
+
+	parallelFor(0, 0, [](usz) { IGXI_CHECK(false); });
+
+	//One thread runs in order on the calling thread
+
+	{
+		List<usz> order;
+		std::thread::id caller = std::this_thread::get_id();
+		bool sameThread = true;
+
+		parallelFor(100, 1, [&](usz i) {
+			order.push_back(i);
+			sameThread &= std::this_thread::get_id() == caller;
+		});
+
+		bool inOrder = order.size() == 100;
+
+		for (usz i = 0; inOrder && i < order.size(); ++i)
+			inOrder = order[i] == i;
+
+		IGXI_CHECK(inOrder && sameThread);
+	}
+
+	//A loop doesn't use more threads than it asks for
+
+	{
+		Concurrency concurrency;
+
+		parallelFor(64, 2, [&](usz) {
+			concurrency.enter();
+			concurrency.leave();
+		});
+
+		IGXI_CHECK(concurrency.peak <= 2);
+	}
+
+	//Nested loops finish every inner index and never run on more threads than the pool has
+
+	{
+		Concurrency concurrency;
+		std::atomic<usz> sum{};
+
+		parallelFor(8, 4, [&](usz i) {
+			parallelFor(100, 4, [&](usz j) {
+
+				concurrency.enter();
+				sum += i * 100 + j;
+				concurrency.leave();
+			});
+		});
+
+		IGXI_CHECK(sum == 800 * 799 / 2);
+		IGXI_CHECK(concurrency.peak <= poolSize);
+	}
+
+	//The first error (lowest index) wins, however the indices are spread
+
+	{
+		std::atomic<usz> first = 1000;
+
+		parallelFor(1000, 0, [&](usz i) {
+			if (i % 7 == 3)
+				atomicMin(first, i);
+		});
+
+		IGXI_CHECK(first == 3);
+	}
+
+	//An exception stops the loop and is rethrown on the calling thread, also from a nested loop
+
+	for (u32 threads : { 1u, 4u, 0u }) {
+
+		std::atomic<usz> calls{};
+		bool caught{};
+
+		try {
+			parallelFor(100000, threads, [&](usz i) {
+
+				++calls;
+
+				if (i == 10)
+					throw std::runtime_error("index 10");
+			});
+		}
+
+		catch (const std::runtime_error &e) {
+			caught = std::string(e.what()) == "index 10";
+		}
+
+		IGXI_CHECK(caught && calls < 100000);
+	}
+
+	{
+		std::atomic<usz> thrown{};
+		bool caught{};
+
+		try {
+			parallelFor(8, 0, [&](usz i) {
+				parallelFor(100, 0, [&](usz j) {
+
+					if (j == 50) {
+						++thrown;
+						throw std::logic_error(std::to_string(i));
+					}
+				});
+			});
+		}
+
+		catch (const std::logic_error&) {
+			caught = true;
+		}
+
+		IGXI_CHECK(caught && thrown >= 1);
+
+		//The pool still works after a loop threw
+
+		std::atomic<usz> sum{};
+		parallelFor(1000, 0, [&](usz i) { sum += i; });
+		IGXI_CHECK(sum == 1000 * 999 / 2);
+	}
+
+	return test::result();
+}
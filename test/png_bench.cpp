@@ -0,0 +1,50 @@
+#include "test.hpp"
+#include "igxi/png.hpp"
+#include <cmath>
+
+using namespace igxi;
+
+//Throughput (MB/s of texels) and size of encodePNG at every level for a 2048x2048 rgba8 image
+//The image is a couple smooth gradients with some noise, which is closer to a texture than pure noise or a flat color
+
+int main() {
+
+	u16 width = 2048, height = 2048;
+	Buffer image(usz(width) * height * 4);
+	u32 seed = 1;
+
+	for (usz y = 0; y < height; ++y)
+		for (usz x = 0; x < width; ++x) {
+
+			seed = seed * 1664525 + 1013904223;
+			u8 noise = u8((seed >> 24) & 7);
+
+			u8 *texel = image.data() + (y * width + x) * 4;
+			texel[0] = u8(x / 8 + noise);
+			texel[1] = u8(y / 8 + noise);
+			texel[2] = u8(128 + 100 * std::sin(f64(x + y) / 64));
+			texel[3] = 255;
+		}
+
+	f64 megabytes = f64(image.size()) / (1024 * 1024);
+
+	std::printf("level\tMB/s\tratio\n");
+
+	for (u8 level = 0; level <= 9; ++level) {
+
+		usz size{};
+
+		f64 time = test::fastest(level == 9 ? 1 : 3, [&]() {
+			size = encodePNG(image.data(), i64(width) * 4, width, height, 4, 1, level).size();
+		});
+
+		if (!size) {
+			std::fprintf(stderr, "Level %u failed\n", u32(level));
+			return 1;
+		}
+
+		std::printf("%u\t%.1f\t%.3f\n", u32(level), megabytes / time, f64(size) / image.size());
+	}
+
+	return 0;
+}
@@ -0,0 +1,129 @@
+#include "test.hpp"
+#include "igxi/png.hpp"
+#include "stb/stb_image.h"
+
+//stb_image is implemented in the library (convert.cpp), so the PNGs are decoded with the same decoder it uses
+
+using namespace igxi;
+
+//Noise with some runs, so every filter and match length is used
+
+static Buffer makeImage(u16 width, u16 height, u8 channels, u8 bytesPerChannel) {
+
+	Buffer image(usz(width) * height * channels * bytesPerChannel);
+	u32 seed = 1;
+
+	for (usz i = 0; i < image.size(); ++i) {
+		seed = seed * 1664525 + 1013904223;
+		image[i] = i / 97 % 3 ? u8(i / 13) : u8(seed >> 24);
+	}
+
+	return image;
+}
+
+//Decode with stb and compare against the image (rows from top to bottom)
+
+static bool decodes(const Buffer &png, const Buffer &image, u16 width, u16 height, u8 channels, u8 bytesPerChannel) {
+
+	if (png.empty())
+		return false;
+
+	int x{}, y{}, comp{};
+	void *data;
+
+	if (bytesPerChannel == 2)
+		data = stbi_load_16_from_memory(png.data(), int(png.size()), &x, &y, &comp, 0);
+
+	else data = stbi_load_from_memory(png.data(), int(png.size()), &x, &y, &comp, 0);
+
+	if (!data)
+		return false;
+
+	//16-bit channels are little endian in memory on both sides
+
+	bool equal = 
+		x == width && y == height && comp == channels && 
+		!std::memcmp(data, image.data(), image.size());
+
+	stbi_image_free(data);
+	return equal;
+}
+
+int main() {
+
+	//Every format at every level
+
+	for (u8 level = 0; level <= 9; ++level)
+		for (u8 bytesPerChannel = 1; bytesPerChannel <= 2; ++bytesPerChannel)
+			for (u8 channels = 1; channels <= 4; ++channels) {
+
+				u16 width = 37, height = 19;
+				Buffer image = makeImage(width, height, channels, bytesPerChannel);
+
+				Buffer png = encodePNG(
+					image.data(), i64(width) * channels * bytesPerChannel, width, height, channels, bytesPerChannel, level
+				);
+
+				if (!decodes(png, image, width, height, channels, bytesPerChannel))
+					std::fprintf(
+						stderr, "Level %u with %u channel(s) of %u byte(s) doesn't round trip\n",
+						u32(level), u32(channels), u32(bytesPerChannel)
+					);
+
+				IGXI_CHECK(decodes(png, image, width, height, channels, bytesPerChannel));
+			}
+
+	//A single pixel, a single row and a single column (the fast deflate has nothing to match)
+
+	for (auto [width, height] : { std::pair<u16, u16>{ 1, 1 }, { 300, 1 }, { 1, 300 } })
+		for (u8 level : { u8(0), u8(1), u8(3), u8(9) }) {
+			Buffer image = makeImage(width, height, 3, 1);
+			IGXI_CHECK(decodes(encodePNG(image.data(), i64(width) * 3, width, height, 3, 1, level), image, width, height, 3, 1));
+		}
+
+	//A negative stride flips the image
+
+	{
+		u16 width = 64, height = 32;
+		usz row = usz(width) * 4;
+
+		Buffer image = makeImage(width, height, 4, 1), flipped(image.size());
+
+		for (usz y = 0; y < height; ++y)
+			std::memcpy(flipped.data() + y * row, image.data() + (height - 1 - y) * row, row);
+
+		Buffer png = encodePNG(image.data() + (height - 1) * row, -i64(row), width, height, 4, 1, 2);
+		IGXI_CHECK(decodes(png, flipped, width, height, 4, 1));
+	}
+
+	//More effort doesn't give bigger files
+
+	{
+		u16 width = 256, height = 256;
+		Buffer image = makeImage(width, height, 4, 1);
+
+		usz stored = encodePNG(image.data(), i64(width) * 4, width, height, 4, 1, 0).size();
+		usz fast = encodePNG(image.data(), i64(width) * 4, width, height, 4, 1, 1).size();
+		usz best = encodePNG(image.data(), i64(width) * 4, width, height, 4, 1, 9).size();
+
+		IGXI_CHECK(fast < stored && best <= fast);
+	}
+
+	//Quality 1 (the default of toExternal) is level 7, the exhaustive level 9 only with maxEffort
+
+	IGXI_CHECK(getPNGLevel(0) == 0 && getPNGLevel(.5f) == 4 && getPNGLevel(1) == 7);
+	IGXI_CHECK(getPNGLevel(1, true) == 9 && getPNGLevel(0, true) == 9);
+
+	//Unsupported sizes and formats
+
+	{
+		u8 pixel[8]{};
+
+		IGXI_CHECK(encodePNG(pixel, 0, 0, 1, 4, 1, 1).empty());
+		IGXI_CHECK(encodePNG(pixel, 4, 1, 0, 4, 1, 1).empty());
+		IGXI_CHECK(encodePNG(pixel, 5, 1, 1, 5, 1, 1).empty());
+		IGXI_CHECK(encodePNG(pixel, 3, 1, 1, 1, 3, 1).empty());
+	}
+
+	return test::result();
+}
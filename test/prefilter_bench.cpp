@@ -0,0 +1,59 @@
+#include "test.hpp"
+#include "igxi/prefilter.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+//Time to prefilter a float cube of 512x512 and 1024x1024 faces with a full mip chain (the default sample count)
+//Every face is filled with noise, so there's no shortcut through uniform texels
+
+int main() {
+
+	std::printf("size\tmips\tseconds\n");
+
+	for (u16 size : { u16(512), u16(1024) }) {
+
+		IGXI cube;
+		cube.header.width = cube.header.height = size;
+		cube.header.length = 1;
+		cube.header.layers = 6;
+		cube.header.formats = 1;
+		cube.header.type = TextureType::TEXTURE_CUBE;
+		cube.format = { GPUFormat(u16(3 | (3 << 2) | (u8(GPUFormatType::FLOAT) << 4))) };
+		cube.data.resize(1);
+
+		u32 seed = 1;
+
+		for (u16 mipSize = size; ; mipSize = u16((mipSize + 1) / 2)) {
+
+			Buffer mip(usz(mipSize) * mipSize * 6 * 16);
+			f32 *texels = (f32*) mip.data();
+
+			for (usz i = 0; i < mip.size() / 4; ++i) {
+				seed = seed * 1664525 + 1013904223;
+				texels[i] = f32(seed >> 8) / f32(1 << 24) * 4;
+			}
+
+			cube.data[0].push_back(std::move(mip));
+			++cube.header.mips;
+
+			if (mipSize == 1)
+				break;
+		}
+
+		Helper::ErrorMessage error{};
+
+		f64 time = test::fastest(3, [&]() {
+			error = prefilterCube(cube, 0);
+		});
+
+		if (error != Helper::SUCCESS) {
+			std::fprintf(stderr, "Unexpected error %u\n", u32(error));
+			return 1;
+		}
+
+		std::printf("%u\t%u\t%.3f\n", u32(size), u32(cube.header.mips), time);
+	}
+
+	return 0;
+}
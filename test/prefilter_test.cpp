@@ -0,0 +1,156 @@
+#include "test.hpp"
+#include "igxi/prefilter.hpp"
+#include <cmath>
+
+using namespace igxi;
+using namespace ignis;
+
+static const GPUFormat rgba32f = GPUFormat(u16(3 | (3 << 2) | (u8(GPUFormatType::FLOAT) << 4)));
+
+//A float cube with a full mip chain, where every texel of a face gets the color face(index, color) writes
+
+template<typename Face>
+static IGXI makeCube(u16 size, u16 cubes, const Face &face) {
+
+	IGXI out;
+	out.header.width = out.header.height = size;
+	out.header.length = 1;
+	out.header.layers = u16(cubes * 6);
+	out.header.formats = 1;
+	out.header.type = cubes > 1 ? TextureType(u8(TextureType::TEXTURE_CUBE) | u8(TextureType::PROPERTY_IS_ARRAY)) : TextureType::TEXTURE_CUBE;
+	out.format = { rgba32f };
+	out.data.resize(1);
+
+	for (u16 mipSize = size; ; mipSize = u16((mipSize + 1) / 2)) {
+
+		Buffer mip(usz(mipSize) * mipSize * out.header.layers * 16);
+		f32 *texels = (f32*) mip.data();
+
+		for (usz layer = 0; layer < out.header.layers; ++layer) {
+
+			f32 value[4];
+			face(layer % 6, value);
+
+			for (usz i = 0; i < usz(mipSize) * mipSize; ++i)
+				std::memcpy(texels + (layer * mipSize * mipSize + i) * 4, value, sizeof(value));
+		}
+
+		out.data[0].push_back(std::move(mip));
+		++out.header.mips;
+
+		if (mipSize == 1)
+			break;
+	}
+
+	return out;
+}
+
+//Largest difference of a texel with the given color, for a layer of a mip
+
+static f32 getError(const IGXI &igxi, usz mip, usz layer, const f32 (&color)[4]) {
+
+	usz size = igxi.header.width;
+
+	for (usz i = 0; i < mip; ++i)
+		size = (size + 1) / 2;
+
+	const f32 *texels = (const f32*) igxi.data[0][mip].data() + layer * size * size * 4;
+	f32 error{};
+
+	for (usz i = 0; i < size * size; ++i)
+		for (usz c = 0; c < 4; ++c)
+			error = std::max(error, std::abs(texels[i * 4 + c] - color[c]));
+
+	return error;
+}
+
+//Average of the rgb of a layer of a mip
+
+static f32 getAverage(const IGXI &igxi, usz mip, usz layer) {
+
+	usz size = igxi.header.width;
+
+	for (usz i = 0; i < mip; ++i)
+		size = (size + 1) / 2;
+
+	const f32 *texels = (const f32*) igxi.data[0][mip].data() + layer * size * size * 4;
+	f64 sum{};
+
+	for (usz i = 0; i < size * size; ++i)
+		sum += texels[i * 4] + texels[i * 4 + 1] + texels[i * 4 + 2];
+
+	return f32(sum / (size * size * 3));
+}
+
+int main() {
+
+	//A constant environment stays constant at every roughness
+
+	{
+		static constexpr f32 color[4] = { .5f, 1, 4, 1 };
+
+		IGXI cube = makeCube(32, 2, [](usz, f32 (&value)[4]) { std::memcpy(value, color, sizeof(color)); });
+
+		IGXI_CHECK(prefilterCube(cube, 0) == Helper::SUCCESS);
+
+		for (usz mip = 0; mip < cube.header.mips; ++mip)
+			for (usz layer = 0; layer < cube.header.layers; ++layer)
+				IGXI_CHECK(getError(cube, mip, layer, color) < 1e-3f);
+
+		//Its irradiance is pi * radiance in every direction, so only the constant coefficient is set
+
+		f32 sh[9][3];
+		IGXI_CHECK(getIrradianceSH(cube, 0, 1, sh) == Helper::SUCCESS);
+
+		static constexpr f32 pi = 3.14159265358979f, y00 = .282095f;
+
+		for (usz c = 0; c < 3; ++c) {
+
+			IGXI_CHECK(std::abs(sh[0][c] * y00 - pi * color[c]) < 1e-2f * color[c]);
+
+			for (usz i = 1; i < 9; ++i)
+				IGXI_CHECK(std::abs(sh[i][c]) < 1e-2f * color[c]);
+		}
+
+		f32 unused[9][3];
+		IGXI_CHECK(getIrradianceSH(cube, 0, 2, unused) == Helper::INVALID_RESOURCE_INDEX);
+	}
+
+	//Light from +x spreads to the sides as the roughness increases, but doesn't reach -x
+
+	{
+		IGXI cube = makeCube(32, 1, [](usz face, f32 (&value)[4]) {
+			value[0] = value[1] = value[2] = face == 0 ? 1.f : 0.f;
+			value[3] = 1;
+		});
+
+		IGXI_CHECK(prefilterCube(cube, 0) == Helper::SUCCESS);
+
+		usz last = cube.header.mips - 1;
+
+		for (usz mip = 1; mip <= last; ++mip) {
+			IGXI_CHECK(getAverage(cube, mip, 0) > 0 && getAverage(cube, mip, 0) <= 1);
+			IGXI_CHECK(getAverage(cube, mip, 2) > 0 && getAverage(cube, mip, 2) < getAverage(cube, mip, 0));
+			IGXI_CHECK(getAverage(cube, mip, 1) < 1e-3f);
+		}
+
+		IGXI_CHECK(getAverage(cube, last, 0) < getAverage(cube, 1, 0));
+		IGXI_CHECK(getAverage(cube, last, 2) > getAverage(cube, 1, 2));
+	}
+
+	//Only float cubes can be prefiltered
+
+	{
+		IGXI cube = makeCube(8, 1, [](usz, f32 (&value)[4]) { value[0] = value[1] = value[2] = value[3] = 1; });
+		IGXI_CHECK(prefilterCube(cube, 1) == Helper::INVALID_RESOURCE_INDEX);
+
+		cube.format[0] = GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4)));
+		IGXI_CHECK(prefilterCube(cube, 0) == Helper::INVALID_FORMAT);
+
+		cube.format[0] = rgba32f;
+		cube.header.type = TextureType::TEXTURE_2D;
+		IGXI_CHECK(prefilterCube(cube, 0) == Helper::INVALID_TYPE);
+	}
+
+	return test::result();
+}
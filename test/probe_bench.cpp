@@ -0,0 +1,64 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+#include "igxi/png.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+//Time to probe the headers of 64 PNGs (of 256x256 to 2048x2048) against decoding them into an array
+//Probing only maps the file and reads the pages of its header, so it shouldn't depend on the image size
+
+int main() {
+
+	String directory = test::getDirectory("probe-bench");
+
+	std::printf("files\tsize\tprobe (ms)\tdecode (ms)\n");
+
+	for (u16 size : { u16(256), u16(1024), u16(2048) }) {
+
+		Buffer texels(usz(size) * size * 4);
+
+		for (usz i = 0; i < texels.size(); ++i)
+			texels[i] = u8((i / 4 % size) ^ (i / 4 / size) ^ (i % 4 * 85));
+
+		Buffer png = encodePNG(texels.data(), i64(size) * 4, size, size, 4, 1, 1);
+
+		List<Helper::FileDesc> descs;
+
+		for (u16 i = 0; i < 64; ++i) {
+
+			String path = directory + "/" + std::to_string(size) + "_" + std::to_string(i) + ".png";
+
+			if (!test::writeFile(path, png)) {
+				std::fprintf(stderr, "Couldn't write %s\n", path.c_str());
+				return 1;
+			}
+
+			descs.push_back({ path, { 0, i, 0 } });
+		}
+
+		Helper::ErrorMessage probeError{}, decodeError{};
+		List<Helper::ImageInfo> infos;
+
+		f64 probe = test::fastest(5, [&]() {
+			probeError = Helper::probe(descs, infos);
+		});
+
+		f64 decode = test::fastest(2, [&]() {
+			IGXI out;
+			decodeError = Helper::convert(out, descs, Helper::Flags(Helper::IS_ARRAY));
+		});
+
+		if (probeError || decodeError) {
+			std::fprintf(stderr, "Unexpected error %u %u\n", u32(probeError), u32(decodeError));
+			return 1;
+		}
+
+		std::printf("%zu\t%u\t%.3f\t\t%.3f\n", descs.size(), u32(size), probe * 1e3, decode * 1e3);
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+
+	return 0;
+}
@@ -0,0 +1,112 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+#include "igxi/png.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+//A PNG with a ramp in every channel
+
+static bool writePNG(const String &path, u16 width, u16 height, u8 channels, u8 bytesPerChannel) {
+
+	Buffer texels(usz(width) * height * channels * bytesPerChannel);
+
+	for (usz i = 0; i < texels.size(); ++i)
+		texels[i] = u8(i * 7);
+
+	Buffer png = encodePNG(texels.data(), i64(width) * channels * bytesPerChannel, width, height, channels, bytesPerChannel, 1);
+	return !png.empty() && test::writeFile(path, png);
+}
+
+int main() {
+
+	String directory = test::getDirectory("probe");
+
+	IGXI_CHECK(writePNG(directory + "/rgba8.png", 64, 32, 4, 1));
+	IGXI_CHECK(writePNG(directory + "/rg16.png", 48, 16, 2, 2));
+	IGXI_CHECK(writePNG(directory + "/small.png", 32, 32, 4, 1));
+
+	//Only the header is read
+
+	{
+		List<Helper::FileDesc> descs = {
+			{ directory + "/rgba8.png", {} },
+			{ directory + "/rg16.png", {} }
+		};
+
+		List<Helper::ImageInfo> infos;
+
+		IGXI_CHECK(Helper::probe(descs, infos) == Helper::SUCCESS);
+		IGXI_CHECK(infos.size() == 2);
+
+		if (infos.size() == 2) {
+
+			IGXI_CHECK(infos[0].width == 64 && infos[0].height == 32 && infos[0].frames == 1);
+			IGXI_CHECK(infos[0].channels == 4 && infos[0].bytesPerChannel == 1);
+
+			IGXI_CHECK(infos[1].width == 48 && infos[1].height == 16);
+			IGXI_CHECK(infos[1].channels == 2 && infos[1].bytesPerChannel == 2);
+		}
+
+		//IS_1D puts all rows after each other
+
+		IGXI_CHECK(Helper::probe(descs, infos, Helper::Flags(Helper::IS_1D)) == Helper::SUCCESS);
+		IGXI_CHECK(infos.size() == 2 && infos[0].width == 64 * 32 && infos[0].height == 1);
+	}
+
+	//The first error (in order of the descs) is returned
+
+	{
+		Buffer garbage(64, 0x55);
+		IGXI_CHECK(test::writeFile(directory + "/garbage.png", garbage));
+
+		List<Helper::ImageInfo> infos;
+
+		List<Helper::FileDesc> descs = {
+			{ directory + "/rgba8.png", {} },
+			{ directory + "/garbage.png", {} },
+			{ directory + "/missing.png", {} }
+		};
+
+		IGXI_CHECK(Helper::probe(descs, infos) == Helper::INVALID_FILE_DATA);
+
+		std::swap(descs[1], descs[2]);
+		IGXI_CHECK(Helper::probe(descs, infos) == Helper::INVALID_FILE_PATH);
+	}
+
+	//A layer of another size is found from the headers, before the truncated file is decoded
+
+	{
+		Buffer png;
+
+		{
+			std::ifstream in(directory + "/small.png", std::ios::binary);
+			png.assign(std::istreambuf_iterator<char>(in), {});
+		}
+
+		png.resize(png.size() / 2);
+		IGXI_CHECK(test::writeFile(directory + "/truncated.png", png));
+
+		List<Helper::FileDesc> descs = {
+			{ directory + "/rgba8.png", { 0, 0, 0 } },
+			{ directory + "/truncated.png", { 0, 1, 0 } }
+		};
+
+		IGXI out;
+		IGXI_CHECK(Helper::convert(out, descs, Helper::Flags(Helper::IS_ARRAY), 1, 1) == Helper::CONFLICTING_IMAGE_SIZE);
+
+		//With the right size, decoding it fails
+
+		descs[0].path = directory + "/small.png";
+		IGXI_CHECK(Helper::convert(out, descs, Helper::Flags(Helper::IS_ARRAY), 1, 1) == Helper::INVALID_FILE_DATA);
+
+		descs[1].path = directory + "/small.png";
+		IGXI_CHECK(Helper::convert(out, descs, Helper::Flags(Helper::IS_ARRAY), 1, 1) == Helper::SUCCESS);
+		IGXI_CHECK(out.header.width == 32 && out.header.layers == 2);
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+
+	return test::result();
+}
@@ -0,0 +1,70 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+//Throughput of convertRaw on a 256x256x256 R32F volume (64 MiB) against reading the file into memory
+//The file is read once before, so both come from the page cache; a straight copy should be as fast as the read
+
+int main() {
+
+	String directory = test::getDirectory("raw-bench");
+	String path = directory + "/volume.raw";
+
+	Helper::RawDesc desc{ GPUFormat(u16((3 << 2) | (u8(GPUFormatType::FLOAT) << 4))), 256, 256, 256 };
+
+	{
+		List<f32> texels(usz(desc.width) * desc.height * desc.length);
+
+		for (usz i = 0; i < texels.size(); ++i)
+			texels[i] = f32(i % 4099) / 4099;
+
+		if (!test::writeFile(path, (const u8*) texels.data(), texels.size() * sizeof(f32))) {
+			std::fprintf(stderr, "Couldn't write %s\n", path.c_str());
+			return 1;
+		}
+	}
+
+	f64 megabytes = f64(desc.width) * desc.height * desc.length * 4 / (1024 * 1024);
+
+	std::printf("import\t\t\tthreads\tMB/s\n");
+
+	f64 read = test::fastest(3, [&]() {
+		std::ifstream in(path, std::ios::binary);
+		Buffer file(usz(std::filesystem::file_size(path)));
+		in.read((char*) file.data(), std::streamsize(file.size()));
+	});
+
+	std::printf("read\t\t\t1\t%.1f\n", megabytes / read);
+
+	struct Case { const char *name; Helper::Flags flags; };
+
+	static constexpr Case cases[] = {
+		{ "copy\t\t", Helper::IS_3D },
+		{ "to 16-bit\t", Helper::Flags(Helper::IS_3D | Helper::IS_16_BIT) }
+	};
+
+	for (const Case &c : cases)
+		for (u32 threads : { 1u, 0u }) {
+
+			Helper::ErrorMessage error{};
+
+			f64 time = test::fastest(3, [&]() {
+				IGXI out;
+				error = Helper::convertRaw(out, path, desc, c.flags, 1, threads);
+			});
+
+			if (error != Helper::SUCCESS) {
+				std::fprintf(stderr, "Unexpected error %u\n", u32(error));
+				return 1;
+			}
+
+			std::printf("%s%s\t%.1f\n", c.name, threads ? "1" : "all", megabytes / time);
+		}
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+
+	return 0;
+}
@@ -0,0 +1,124 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+static const GPUFormat rgba8 = GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4)));
+static const GPUFormat r32f = GPUFormat(u16((3 << 2) | (u8(GPUFormatType::FLOAT) << 4)));
+
+int main() {
+
+	String directory = test::getDirectory("raw");
+
+	//A 5x3x4 rgba8 volume after a 16 byte header, with rows padded to 24 bytes
+
+	Helper::RawDesc desc{ rgba8, 5, 3, 4, 16, 24 };
+
+	Buffer file(16 + 24 * 3 * 4, 0xCD), expected;
+
+	for (usz z = 0; z < 4; ++z)
+		for (usz y = 0; y < 3; ++y)
+			for (usz x = 0; x < 5 * 4; ++x) {
+				u8 v = u8(x + y * 32 + z * 96);
+				file[16 + (z * 3 + y) * 24 + x] = v;
+				expected.push_back(v);
+			}
+
+	IGXI_CHECK(test::writeFile(directory + "/volume.raw", file));
+
+	//Rows are copied without padding, as slices or layers
+
+	{
+		IGXI out;
+
+		IGXI_CHECK(Helper::convertRaw(out, directory + "/volume.raw", desc) == Helper::SUCCESS);
+		IGXI_CHECK(out.header.type == TextureType::TEXTURE_3D);
+		IGXI_CHECK(out.header.width == 5 && out.header.height == 3 && out.header.length == 4 && out.header.layers == 1);
+		IGXI_CHECK(out.header.mips == 1 && out.format.size() == 1 && out.format[0] == rgba8);
+		IGXI_CHECK(out.data.size() == 1 && out.data[0].size() == 1 && out.data[0][0] == expected);
+
+		IGXI_CHECK(Helper::convertRaw(out, directory + "/volume.raw", desc, Helper::Flags(Helper::IS_ARRAY), 1, 1) == Helper::SUCCESS);
+		IGXI_CHECK(out.header.length == 1 && out.header.layers == 4 && out.data[0][0] == expected);
+
+		//With mips, mip 0 is still the file and the other mips are allocated (and generated)
+
+		IGXI_CHECK(
+			Helper::convertRaw(out, directory + "/volume.raw", desc, Helper::Flags(Helper::IS_3D | Helper::GENERATE_MIPS)) ==
+			Helper::SUCCESS
+		);
+
+		//5x3x4, 3x2x2, 2x1x1, 1x1x1
+
+		IGXI_CHECK(out.header.mips == 4 && out.data[0].size() == 4 && out.data[0][0] == expected);
+
+		IGXI_CHECK(
+			out.data[0].size() == 4 && out.data[0][1].size() == 3 * 2 * 2 * 4 && 
+			out.data[0][2].size() == 2 * 1 * 1 * 4 && out.data[0][3].size() == 4
+		);
+	}
+
+	//Floats can be stored in less bits
+
+	{
+		f32 texels[] = { 1, .5f, -2, 0, 65504, .25f };
+		IGXI_CHECK(test::writeFile(directory + "/r32f.raw", (const u8*) texels, sizeof(texels)));
+
+		IGXI out;
+		Helper::RawDesc floats{ r32f, 3, 2 };
+
+		IGXI_CHECK(
+			Helper::convertRaw(out, directory + "/r32f.raw", floats, Helper::Flags(Helper::IS_3D | Helper::IS_16_BIT)) == 
+			Helper::SUCCESS
+		);
+
+		IGXI_CHECK(out.format.size() == 1 && FormatHelper::getSizeBytes(out.format[0]) == 2);
+		IGXI_CHECK(out.format.size() == 1 && FormatHelper::getType(out.format[0]) == GPUFormatType::FLOAT);
+
+		static constexpr u16 halfs[] = { 0x3C00, 0x3800, 0xC000, 0, 0x7BFF, 0x3400 };
+
+		IGXI_CHECK(out.data.size() == 1 && out.data[0][0].size() == sizeof(halfs));
+		IGXI_CHECK(out.data.size() == 1 && !std::memcmp(out.data[0][0].data(), halfs, std::min(sizeof(halfs), out.data[0][0].size())));
+
+		IGXI_CHECK(
+			Helper::convertRaw(out, directory + "/r32f.raw", floats, Helper::Flags(Helper::IS_3D | Helper::IS_UINT)) == 
+			Helper::INCOMPATIBLE_FORMATS
+		);
+	}
+
+	//Errors
+
+	{
+		IGXI out;
+		String path = directory + "/volume.raw";
+
+		Helper::RawDesc tooBig = desc;
+		tooBig.length = 5;
+
+		IGXI_CHECK(Helper::convertRaw(out, path, tooBig) == Helper::INVALID_FILE_BOUNDS);
+		IGXI_CHECK(Helper::convertRaw(out, directory + "/missing.raw", desc) == Helper::INVALID_FILE_PATH);
+
+		Helper::RawDesc pitch = desc;
+		pitch.rowPitch = 16;
+
+		IGXI_CHECK(Helper::convertRaw(out, path, pitch) == Helper::INVALID_IMAGE_SIZE);
+
+		Helper::RawDesc empty = desc;
+		empty.width = 0;
+
+		IGXI_CHECK(Helper::convertRaw(out, path, empty) == Helper::INVALID_IMAGE_SIZE);
+
+		IGXI_CHECK(Helper::convertRaw(out, path, desc, Helper::NONE) == Helper::INVALID_TYPE);
+		IGXI_CHECK(Helper::convertRaw(out, path, desc, Helper::Flags(Helper::IS_CUBE)) == Helper::MISSING_FACE);
+
+		IGXI_CHECK(
+			Helper::convertRaw(out, path, desc, Helper::Flags(Helper::IS_3D | Helper::MAX_SIZE_256)) == 
+			Helper::INVALID_OPERATION
+		);
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+
+	return test::result();
+}
@@ -0,0 +1,107 @@
+#include "test.hpp"
+#include "igxi/resample.hpp"
+
+//stb_image_resize isn't used by the library, so its implementation lives here
+
+#if defined(_MSC_VER)
+	#pragma warning(push, 0)
+#elif defined(__GNUC__)
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Wunused-parameter"
+	#pragma GCC diagnostic ignored "-Wunused-function"
+	#pragma GCC diagnostic ignored "-Wsign-compare"
+	#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+	#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
+#endif
+
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include "stb/stb_image_resize.h"
+
+#if defined(_MSC_VER)
+	#pragma warning(pop)
+#elif defined(__GNUC__)
+	#pragma GCC diagnostic pop
+#endif
+
+using namespace igxi;
+using namespace ignis;
+
+//Throughput (source megapixels per second) of resample against stbir for rgba8 images
+//stbir is single threaded, so resample is timed with one thread and with all of them
+//stbir's Mitchell is the closest to MITCHELL (both are B = C = 1/3), Catmull-Rom is its sharpest
+
+int main() {
+
+	struct Case { u16 srcWidth, srcHeight, dstWidth, dstHeight; };
+
+	static constexpr Case cases[] = {
+		{ 2048, 2048, 1024, 1024 },
+		{ 4096, 4096, 1000, 1000 },
+		{ 1024, 1024, 3000, 3000 }
+	};
+
+	static constexpr const char *filterNames[] = { "mitchell", "lanczos", "kaiser" };
+
+	std::printf("source\t\ttarget\t\tfilter\t\tthreads\tMP/s\n");
+
+	for (const Case &c : cases) {
+
+		Buffer src(usz(c.srcWidth) * c.srcHeight * 4), dst(usz(c.dstWidth) * c.dstHeight * 4);
+		u32 seed = 1;
+
+		for (u8 &v : src) {
+			seed = seed * 1664525 + 1013904223;
+			v = u8(seed >> 24);
+		}
+
+		f64 megapixels = f64(c.srcWidth) * c.srcHeight / 1e6;
+
+		auto print = [&](const char *filter, const char *threads, f64 time) {
+			std::printf(
+				"%ux%u\t%ux%u\t%s\t%s\t%.1f\n", 
+				u32(c.srcWidth), u32(c.srcHeight), u32(c.dstWidth), u32(c.dstHeight), filter, threads, megapixels / time
+			);
+		};
+
+		for (usz i = 0; i < 3; ++i)
+			for (u32 threads : { 1u, 0u }) {
+
+				Helper::ErrorMessage error{};
+
+				f64 time = test::fastest(3, [&]() {
+					error = resample(
+						src.data(), c.srcWidth, c.srcHeight, dst.data(), c.dstWidth, c.dstHeight,
+						GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4))), ResampleFilter(i), threads
+					);
+				});
+
+				if (error != Helper::SUCCESS) {
+					std::fprintf(stderr, "Unexpected error %u\n", u32(error));
+					return 1;
+				}
+
+				print(filterNames[i], threads ? "1" : "all", time);
+			}
+
+		for (auto [filter, name] : { std::pair{ STBIR_FILTER_MITCHELL, "stbir mitchell" }, { STBIR_FILTER_CATMULLROM, "stbir catmull" } }) {
+
+			int ok{};
+
+			f64 time = test::fastest(3, [&]() {
+				ok = stbir_resize_uint8_generic(
+					src.data(), c.srcWidth, c.srcHeight, 0, dst.data(), c.dstWidth, c.dstHeight, 0,
+					4, STBIR_ALPHA_CHANNEL_NONE, 0, STBIR_EDGE_CLAMP, filter, STBIR_COLORSPACE_LINEAR, nullptr
+				);
+			});
+
+			if (!ok) {
+				std::fprintf(stderr, "stbir failed\n");
+				return 1;
+			}
+
+			print(name, "1", time);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include "test.hpp"
+#include "igxi/resample.hpp"
+#include <cmath>
+
+using namespace igxi;
+using namespace ignis;
+
+static const GPUFormat rgba8 = GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4)));
+static const GPUFormat rgba32f = GPUFormat(u16(3 | (3 << 2) | (u8(GPUFormatType::FLOAT) << 4)));
+static const GPUFormat rgba32u = GPUFormat(u16(3 | (3 << 2) | (u8(GPUFormatType::UINT) << 4)));
+
+static constexpr ResampleFilter filters[] = { ResampleFilter::MITCHELL, ResampleFilter::LANCZOS, ResampleFilter::KAISER };
+
+//Largest difference between two rgba8 images of the same size
+
+static u32 getError(const Buffer &a, const Buffer &b) {
+
+	u32 error{};
+
+	for (usz i = 0; i < a.size(); ++i)
+		error = std::max(error, u32(std::abs(int(a[i]) - int(b[i]))));
+
+	return error;
+}
+
+int main() {
+
+	//A constant image stays constant when it's down or upsampled (in every supported format)
+
+	for (ResampleFilter filter : filters)
+		for (GPUFormat format : { rgba8, GPUFormat(GPUFormat::srgba8) }) {
+
+			Buffer src(37 * 23 * 4);
+
+			for (usz i = 0; i < src.size(); ++i)
+				src[i] = u8(i % 4 * 60 + 17);
+
+			for (auto [width, height] : { std::pair<u16, u16>{ 16, 10 }, { 80, 50 }, { 1, 1 } }) {
+
+				Buffer dst(usz(width) * height * 4), expected(dst.size());
+
+				for (usz i = 0; i < expected.size(); ++i)
+					expected[i] = u8(i % 4 * 60 + 17);
+
+				IGXI_CHECK(resample(src.data(), 37, 23, dst.data(), width, height, format, filter) == Helper::SUCCESS);
+				IGXI_CHECK(getError(dst, expected) <= 1);
+			}
+		}
+
+	for (ResampleFilter filter : filters) {
+
+		List<f32> src(13 * 7 * 4, 2.5f), dst(29 * 3 * 4);
+
+		IGXI_CHECK(resample((const u8*) src.data(), 13, 7, (u8*) dst.data(), 29, 3, rgba32f, filter) == Helper::SUCCESS);
+
+		f32 error{};
+
+		for (f32 v : dst)
+			error = std::max(error, std::abs(v - 2.5f));
+
+		IGXI_CHECK(error < 1e-4f);
+	}
+
+	//Lanczos is 0 at every other integer, so resampling to the same size gives the same image
+
+	{
+		Buffer src(64 * 48 * 4), dst(src.size());
+		u32 seed = 1;
+
+		for (u8 &v : src) {
+			seed = seed * 1664525 + 1013904223;
+			v = u8(seed >> 24);
+		}
+
+		IGXI_CHECK(resample(src.data(), 64, 48, dst.data(), 64, 48, rgba8, ResampleFilter::LANCZOS) == Helper::SUCCESS);
+		IGXI_CHECK(getError(src, dst) <= 1);
+	}
+
+	//Halving a ramp averages neighbouring pixels (away from the clamped edges)
+
+	for (ResampleFilter filter : filters) {
+
+		Buffer src(256 * 4 * 4), dst(128 * 2 * 4);
+
+		for (usz i = 0; i < src.size(); ++i)
+			src[i] = u8(i / 4 % 256);
+
+		IGXI_CHECK(resample(src.data(), 256, 4, dst.data(), 128, 2, rgba8, filter) == Helper::SUCCESS);
+
+		for (usz y = 0; y < 2; ++y)
+			for (usz x = 4; x < 124; ++x)
+				IGXI_CHECK(std::abs(f32(dst[(y * 128 + x) * 4]) - (x * 2 + .5f)) <= 1);
+	}
+
+	//Errors
+
+	{
+		u8 src[16]{}, dst[16]{};
+
+		IGXI_CHECK(resample(src, 0, 2, dst, 2, 2, rgba8, ResampleFilter::MITCHELL) == Helper::INVALID_IMAGE_SIZE);
+		IGXI_CHECK(resample(src, 2, 2, dst, 2, 0, rgba8, ResampleFilter::MITCHELL) == Helper::INVALID_IMAGE_SIZE);
+		IGXI_CHECK(resample(src, 2, 2, dst, 2, 2, rgba8, ResampleFilter::NONE) == Helper::INVALID_FORMAT);
+
+		IGXI_CHECK(!canResample(rgba32u));
+		IGXI_CHECK(resample(src, 1, 1, dst, 1, 1, rgba32u, ResampleFilter::MITCHELL) == Helper::INVALID_FORMAT);
+
+		ResampleFilter filter;
+
+		IGXI_CHECK(getResampleFilter(Helper::NONE, filter) == Helper::SUCCESS && filter == ResampleFilter::NONE);
+		IGXI_CHECK(getResampleFilter(Helper::MIP_KAISER, filter) == Helper::SUCCESS && filter == ResampleFilter::KAISER);
+		IGXI_CHECK(getResampleFilter(Helper::Flags(Helper::MIP_MITCHELL | Helper::MIP_LANCZOS), filter) == Helper::INVALID_MIP_FILTER);
+	}
+
+	return test::result();
+}
@@ -0,0 +1,130 @@
+#include "allocations.hpp"
+#include "igxi/convert.hpp"
+#include "igxi/compress.hpp"
+#include "stb/stb_image_write.h"
+#include <cstdlib>
+
+using namespace igxi;
+using namespace ignis;
+
+//The high-water mark of a conversion is measured with the allocations through new (see allocations.hpp)
+
+//32 layers of 256x256 rgba8; the alpha of one layer can be made translucent
+
+static constexpr u16 size = 256, layers = 32;
+
+static List<Helper::FileDesc> writeLayers(const String &directory, u16 translucentLayer) {
+
+	List<Helper::FileDesc> descs;
+	Buffer texels(usz(size) * size * 4);
+
+	for (u16 layer = 0; layer < layers; ++layer) {
+
+		for (usz i = 0; i < texels.size(); ++i)
+			texels[i] = i % 4 == 3 ? (layer == translucentLayer && i / 4 % size < size / 2 ? 128 : 255) : u8(i / 4 + layer * 8);
+
+		String path = directory + "/layer" + std::to_string(layer) + ".png";
+
+		int length{};
+		u8 *png = stbi_write_png_to_mem(texels.data(), size * 4, size, size, 4, &length);
+
+		IGXI_CHECK(png && test::writeFile(path, png, usz(length)));
+		std::free(png);
+		descs.push_back({ path, { 0, layer, 0 } });
+	}
+
+	return descs;
+}
+
+int main() {
+
+	String directory = test::getDirectory("stream");
+
+	const Helper::Flags uncompressed = Helper::Flags(Helper::IS_ARRAY | Helper::GENERATE_MIPS);
+	const Helper::Flags compressed = Helper::Flags(uncompressed | Helper::DO_COMPRESSION | Helper::COMPRESS_BC);
+
+	//All layers with mips, as they'd be kept in memory without streaming
+
+	usz total{};
+
+	for (u16 mip = size; ; mip /= 2) {
+
+		total += usz(mip) * mip * 4 * layers;
+
+		if (mip == 1)
+			break;
+	}
+
+	//Without alpha, every batch is BC1 and only one batch is kept uncompressed
+
+	{
+		List<Helper::FileDesc> descs = writeLayers(directory, u16_MAX);
+
+		Helper::ErrorMessage msg{};
+		IGXI out;
+
+		usz whole = test::measureAllocations([&]() { msg = Helper::convert(out, descs, uncompressed, .25f, 2); }).peak;
+		IGXI_CHECK(msg == Helper::SUCCESS && whole >= total);
+
+		out = {};
+
+		usz streamed = test::measureAllocations([&]() { msg = Helper::convert(out, descs, compressed, .25f, 2); }).peak;
+		IGXI_CHECK(msg == Helper::SUCCESS && streamed < total / 2);
+
+		std::printf("Peak memory of %zu bytes uncompressed: %zu streamed, %zu at once\n", total, streamed, whole);
+
+		IGXI_CHECK(out.format.size() == 1 && out.format[0] == getGPUFormat(CompressedFormat::BC1));
+		IGXI_CHECK(out.data.size() == 1 && out.data[0][0].size() == usz(size / 4) * (size / 4) * 8 * layers);
+	}
+
+	//If only the last layer has alpha, the batches before it are compressed again, so every layer is BC3
+
+	{
+		List<Helper::FileDesc> descs = writeLayers(directory, layers - 1);
+
+		IGXI out;
+		Helper::ErrorMessage msg{};
+
+		usz streamed = test::measureAllocations([&]() { msg = Helper::convert(out, descs, compressed, .25f, 2); }).peak;
+		IGXI_CHECK(msg == Helper::SUCCESS && streamed < total / 2);
+
+		IGXI_CHECK(out.header.layers == layers && out.header.mips == 9);
+		IGXI_CHECK(out.format.size() == 1 && out.format[0] == getGPUFormat(CompressedFormat::BC3));
+		IGXI_CHECK(out.data.size() == 1 && out.data[0][0].size() == usz(size / 4) * (size / 4) * 16 * layers);
+	}
+
+	//KEEP_UNCOMPRESSED keeps every layer uncompressed as format 0 (so nothing is streamed), BC1 is added after it
+
+	{
+		List<Helper::FileDesc> descs = writeLayers(directory, u16_MAX);
+
+		IGXI whole, kept;
+
+		IGXI_CHECK(Helper::convert(whole, descs, uncompressed, .25f, 2) == Helper::SUCCESS);
+
+		Helper::ErrorMessage msg{};
+		const Helper::Flags keep = Helper::Flags(compressed | Helper::KEEP_UNCOMPRESSED);
+
+		usz peak = test::measureAllocations([&]() { msg = Helper::convert(kept, descs, keep, .25f, 2); }).peak;
+		IGXI_CHECK(msg == Helper::SUCCESS && peak >= total);
+
+		IGXI_CHECK(kept.header.formats == 2 && kept.format.size() == 2 && kept.data.size() == 2);
+		IGXI_CHECK(kept.format[0] == whole.format[0] && kept.data[0] == whole.data[0]);
+		IGXI_CHECK(kept.format[1] == getGPUFormat(CompressedFormat::BC1));
+		IGXI_CHECK(kept.data[1][0].size() == usz(size / 4) * (size / 4) * 8 * layers);
+
+		IGXI streamed;
+		IGXI_CHECK(Helper::convert(streamed, descs, compressed, .25f, 2) == Helper::SUCCESS);
+		IGXI_CHECK(streamed.data.size() == 1 && kept.data[1] == streamed.data[0]);
+
+		//The same for a single compress after the fact
+
+		IGXI_CHECK(compress(whole, keep, .25f, 2) == Helper::SUCCESS);
+		IGXI_CHECK(whole.format == kept.format && whole.data == kept.data);
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+
+	return test::result();
+}
@@ -0,0 +1,43 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+
+using namespace igxi;
+
+//Time to validate the subresources of 1k to 1M descs
+//The last desc is a duplicate of the first, so every desc is checked before convert returns (without touching a file)
+
+int main() {
+
+	std::printf("descs\tseconds\tns/desc\n");
+
+	for (u32 count : { 1000u, 10000u, 100000u, 1000000u }) {
+
+		u8 mips = 16;
+		u16 layers = u16((count + mips - 1) / mips);
+
+		List<Helper::FileDesc> descs;
+		descs.reserve(usz(layers) * mips + 1);
+
+		for (u8 mip = 0; mip < mips; ++mip)
+			for (u16 layer = 0; layer < layers; ++layer)
+				descs.push_back({ "igxi-convert-missing-file.png", { 0, layer, mip } });
+
+		descs.push_back(descs.front());
+
+		Helper::ErrorMessage error{};
+
+		f64 time = test::fastest(5, [&]() {
+			IGXI out;
+			error = Helper::convert(out, descs, Helper::IS_ARRAY, 1, 1);
+		});
+
+		if (error != Helper::CONFLICTING_RESOURCE_INDEX) {
+			std::fprintf(stderr, "Unexpected error %u\n", u32(error));
+			return 1;
+		}
+
+		std::printf("%zu\t%.6f\t%.1f\n", descs.size(), time, time * 1e9 / f64(descs.size()));
+	}
+
+	return 0;
+}
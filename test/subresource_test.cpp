@@ -0,0 +1,71 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+
+using namespace igxi;
+
+//Every z, layer and mip of a texture is a desc
+//The paths don't exist, so a complete set is only rejected once the files are probed (INVALID_FILE_PATH)
+
+static List<Helper::FileDesc> getDescs(u16 length, u16 layers, u8 mips) {
+
+	List<Helper::FileDesc> descs;
+
+	for (u8 mip = 0; mip < mips; ++mip)
+		for (u16 layer = 0; layer < layers; ++layer)
+			for (u16 z = 0; z < length; ++z)
+				descs.push_back({ "igxi-convert-missing-file.png", { z, layer, mip } });
+
+	return descs;
+}
+
+static Helper::ErrorMessage convert(const List<Helper::FileDesc> &descs, Helper::Flags flags) {
+	IGXI out;
+	return Helper::convert(out, descs, flags, 1, 1);
+}
+
+int main() {
+
+	const Helper::Flags array = Helper::Flags(Helper::IS_ARRAY);
+	const Helper::Flags volume = Helper::Flags(Helper::IS_3D);
+
+	//Complete
+
+	List<Helper::FileDesc> descs = getDescs(1, 4, 3);
+
+	IGXI_CHECK(convert(descs, array) == Helper::INVALID_FILE_PATH);
+	IGXI_CHECK(convert(getDescs(8, 1, 1), volume) == Helper::INVALID_FILE_PATH);
+
+	//A hole; less files than subresources
+
+	List<Helper::FileDesc> missing = descs;
+	missing.erase(missing.begin() + 5);
+
+	IGXI_CHECK(convert(missing, array) == Helper::MISSING_RESOURCE_INDEX);
+
+	List<Helper::FileDesc> missingZ = getDescs(8, 1, 1);
+	missingZ.erase(missingZ.begin() + 3);
+
+	IGXI_CHECK(convert(missingZ, volume) == Helper::MISSING_RESOURCE_INDEX);
+
+	//A hole filled by a duplicate, so the count is still right
+
+	List<Helper::FileDesc> duplicate = descs;
+	duplicate[5] = duplicate[6];
+
+	IGXI_CHECK(convert(duplicate, array) == Helper::CONFLICTING_RESOURCE_INDEX);
+
+	//An extra file for an existing subresource
+
+	List<Helper::FileDesc> extra = descs;
+	extra.push_back(descs.back());
+
+	IGXI_CHECK(convert(extra, array) == Helper::CONFLICTING_RESOURCE_INDEX);
+
+	//Only the base mip can be loaded when mips are generated and indices have to be in range
+
+	IGXI_CHECK(convert(descs, Helper::Flags(array | Helper::GENERATE_MIPS)) == Helper::TOO_MANY_MIPS);
+	IGXI_CHECK(convert({ { "a.png", { 0, 0xFFFF, 0 } } }, array) == Helper::INVALID_RESOURCE_INDEX);
+	IGXI_CHECK(convert({}, array) == Helper::MISSING_PATHS);
+
+	return test::result();
+}
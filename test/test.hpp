@@ -0,0 +1,90 @@
+#pragma once
+#include "types/vec.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+//Checks for the tests; a check that fails is printed and the test returns 1 at the end
+//Benchmarks use Timer and print their results
+
+namespace igxi::test {
+
+	inline int &getFailures() {
+		static int failures{};
+		return failures;
+	}
+
+	inline void check(bool ok, const char *expr, const char *file, int line) {
+
+		if (ok)
+			return;
+
+		std::fprintf(stderr, "%s:%i: check failed: %s\n", file, line, expr);
+		++getFailures();
+	}
+
+	inline int result() {
+
+		if (getFailures())
+			std::fprintf(stderr, "%i check(s) failed\n", getFailures());
+
+		return getFailures() ? 1 : 0;
+	}
+
+	//Seconds since the timer was (re)started
+
+	struct Timer {
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+		inline void restart() { start = std::chrono::high_resolution_clock::now(); }
+
+		inline f64 elapsed() const {
+			return std::chrono::duration<f64>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+	};
+
+	//The fastest of a couple runs (in seconds)
+
+	template<typename Func>
+	inline f64 fastest(u32 runs, const Func &func) {
+
+		f64 best = std::numeric_limits<f64>::max();
+
+		for (u32 i = 0; i < runs; ++i) {
+			Timer timer;
+			func();
+			best = std::min(best, timer.elapsed());
+		}
+
+		return best;
+	}
+
+	//An empty directory for the files of a test (in the temp directory)
+
+	inline String getDirectory(const String &name) {
+
+		std::filesystem::path path = std::filesystem::temp_directory_path() / ("igxi-convert-" + name);
+
+		std::error_code error;
+		std::filesystem::remove_all(path, error);
+		std::filesystem::create_directories(path, error);
+
+		return path.string();
+	}
+
+	inline bool writeFile(const String &path, const u8 *data, usz size) {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write((const char*) data, std::streamsize(size));
+		return bool(out);
+	}
+
+	inline bool writeFile(const String &path, const Buffer &data) {
+		return writeFile(path, data.data(), data.size());
+	}
+
+}
+
+#define IGXI_CHECK(...) igxi::test::check(bool(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
@@ -0,0 +1,105 @@
+#include "test.hpp"
+#include "igxi/convert.hpp"
+#include "igxi/compress.hpp"
+#include "igxi/png.hpp"
+
+using namespace igxi;
+using namespace ignis;
+
+//Updating a layer has to give the same IGXI as converting every layer again,
+//	with the layers compressed into the formats the IGXI already has
+
+static constexpr u16 size = 64, layers = 4;
+
+static String writeLayer(const String &dir, const String &name, bool alpha, u32 seed) {
+
+	Buffer image(usz(size) * size * 4);
+
+	for (usz i = 0; i < image.size(); ++i) {
+		seed = seed * 1664525 + 1013904223;
+		image[i] = i % 4 == 3 ? (alpha && i / 4 % size < size / 2 ? 0 : 255) : u8(seed >> 24);
+	}
+
+	String path = dir + "/" + name + ".png";
+	IGXI_CHECK(test::writeFile(path, encodePNG(image.data(), i64(size) * 4, size, size, 4, 1, 1)));
+	return path;
+}
+
+//Layers 0-3; the layer of "alphaLayer" has alpha, "changed" replaces "changedLayer"
+
+static List<Helper::FileDesc> getFiles(const String &dir, u16 alphaLayer, u16 changedLayer, const String &changed) {
+
+	List<Helper::FileDesc> files;
+
+	for (u16 layer = 0; layer < layers; ++layer)
+		files.push_back({
+			layer == changedLayer ? changed : writeLayer(dir, "layer" + std::to_string(layer), layer == alphaLayer, layer),
+			{ 0, layer, 0 }
+		});
+
+	return files;
+}
+
+//Convert the layers, update one of them and compare it with converting the new layers
+
+static void check(
+	const String &dir, Helper::Flags flags, u16 alphaLayer, bool changedAlpha,
+	const List<GPUFormat> &formats, Helper::ErrorMessage expected
+) {
+
+	IGXI igxi;
+	IGXI_CHECK(Helper::convert(igxi, getFiles(dir, alphaLayer, u16_MAX, ""), flags, .25f, 2) == Helper::SUCCESS);
+	IGXI_CHECK(igxi.format == formats);
+
+	IGXI old = igxi;
+
+	String changed = writeLayer(dir, "changed", changedAlpha, 100);
+	Helper::ErrorMessage msg = Helper::update(igxi, { { changed, { 0, 2, 0 } } }, flags, .25f, 2);
+
+	IGXI_CHECK(msg == expected);
+
+	if (msg != Helper::SUCCESS) {
+		IGXI_CHECK(igxi.format == old.format && igxi.data == old.data);
+		return;
+	}
+
+	IGXI whole;
+	IGXI_CHECK(Helper::convert(whole, getFiles(dir, alphaLayer, 2, changed), flags, .25f, 2) == Helper::SUCCESS);
+	IGXI_CHECK(igxi.format == formats && igxi.data == whole.data);
+}
+
+int main() {
+
+	String dir = test::getDirectory("update");
+
+	const Helper::Flags uncompressed = Helper::Flags(Helper::IS_ARRAY | Helper::GENERATE_MIPS);
+	const Helper::Flags compressed = Helper::Flags(uncompressed | Helper::DO_COMPRESSION | Helper::COMPRESS_BC);
+	const Helper::Flags kept = Helper::Flags(compressed | Helper::KEEP_UNCOMPRESSED);
+
+	const GPUFormat rgba8 = GPUFormat(u16(3 | (u8(GPUFormatType::UNORM) << 4)));
+	const GPUFormat bc1 = getGPUFormat(CompressedFormat::BC1), bc3 = getGPUFormat(CompressedFormat::BC3);
+
+	//An opaque layer of a BC3 array (layer 0 has alpha) stays BC3, also if it's kept uncompressed
+
+	check(dir, compressed, 0, false, { bc3 }, Helper::SUCCESS);
+	check(dir, kept, 0, false, { rgba8, bc3 }, Helper::SUCCESS);
+
+	//A layer with alpha fits a BC3 array, an opaque one a BC1 array
+
+	check(dir, compressed, 0, true, { bc3 }, Helper::SUCCESS);
+	check(dir, compressed, u16_MAX, false, { bc1 }, Helper::SUCCESS);
+
+	//A layer with alpha doesn't fit a BC1 array; that needs a full conversion and the IGXI isn't touched
+
+	check(dir, compressed, u16_MAX, true, { bc1 }, Helper::CONFLICTING_IMAGE_FORMAT);
+	check(dir, kept, u16_MAX, true, { rgba8, bc1 }, Helper::CONFLICTING_IMAGE_FORMAT);
+
+	//Uncompressed layers are just replaced
+
+	check(dir, uncompressed, 0, true, { rgba8 }, Helper::SUCCESS);
+
+	std::error_code error;
+	std::filesystem::remove_all(dir, error);
+
+	return test::result();
+}